@@ -0,0 +1,48 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      Shared set-up for the EuclideanVector benchmarks: the dimension sweep, deterministic
+//      inputs and the throughput counters.
+#ifndef COMP6771_BENCHMARK_HELPERS_HPP
+#define COMP6771_BENCHMARK_HELPERS_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace benchmarks {
+	// Dimensions 1, 8, 64, ..., 2^20: from a single inline element to a vector far larger than L2.
+	inline auto dimensions(benchmark::internal::Benchmark* b) -> void {
+		b->RangeMultiplier(8)->Range(1, 1 << 20);
+	}
+
+	template<typename T>
+	auto values(std::int64_t dimension) -> std::vector<T> {
+		auto result = std::vector<T>(static_cast<std::size_t>(dimension));
+		for (auto i = std::size_t{0}; i < result.size(); ++i) {
+			result[i] = static_cast<T>(i % 7 + 1) * static_cast<T>(0.5);
+		}
+		return result;
+	}
+
+	template<typename T>
+	auto make_vector(std::int64_t dimension) -> comp6771::basic_euclidean_vector<T> {
+		auto const magnitudes = values<T>(dimension);
+		return comp6771::basic_euclidean_vector<T>(magnitudes.begin(), magnitudes.end());
+	}
+
+	// Reports items/s as elements processed, and bytes/s as the bytes each element reads and
+	// writes: `accesses` is 3 for c = a + b, 2 for a *= k, 1 for a reduction over one vector.
+	template<typename T>
+	auto set_throughput(benchmark::State& state, std::int64_t accesses) -> void {
+		auto const elements = static_cast<std::int64_t>(state.iterations()) * state.range(0);
+		state.SetItemsProcessed(elements);
+		state.SetBytesProcessed(elements * accesses * static_cast<std::int64_t>(sizeof(T)));
+	}
+} // namespace benchmarks
+
+#endif // COMP6771_BENCHMARK_HELPERS_HPP
@@ -0,0 +1,128 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures the EuclideanVector constructors.
+//      The benchmarks are:
+//          1. the default, dimension, dimension and value, iterator and initializer list
+//             constructors
+//          2. copy and move construction
+//          3. copy and move assignment
+
+#include "benchmark_helpers.hpp"
+
+#include <utility>
+
+namespace {
+	template<typename T>
+	auto bm_default_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>();
+			benchmark::DoNotOptimize(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	template<typename T>
+	auto bm_dimension_constructor(benchmark::State& state) -> void {
+		auto const dimension = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>(dimension);
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 1);
+	}
+
+	template<typename T>
+	auto bm_value_constructor(benchmark::State& state) -> void {
+		auto const dimension = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>(dimension, static_cast<T>(1.5));
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 1);
+	}
+
+	template<typename T>
+	auto bm_iterator_constructor(benchmark::State& state) -> void {
+		auto const magnitudes = benchmarks::values<T>(state.range(0));
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>(magnitudes.begin(), magnitudes.end());
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_initializer_list_constructor(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+			benchmark::DoNotOptimize(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 12);
+	}
+
+	template<typename T>
+	auto bm_copy_constructor(benchmark::State& state) -> void {
+		auto const source = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>(source);
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// Each iteration moves the vector out and back, so it times one move construction and one
+	// move assignment.
+	template<typename T>
+	auto bm_move_constructor(benchmark::State& state) -> void {
+		auto source = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto v = comp6771::basic_euclidean_vector<T>(std::move(source));
+			benchmark::DoNotOptimize(v);
+			source = std::move(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	template<typename T>
+	auto bm_copy_assignment(benchmark::State& state) -> void {
+		auto const source = benchmarks::make_vector<T>(state.range(0));
+		auto v = comp6771::basic_euclidean_vector<T>(static_cast<int>(state.range(0)));
+		for (auto _ : state) {
+			v = source;
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_move_assignment(benchmark::State& state) -> void {
+		auto source = benchmarks::make_vector<T>(state.range(0));
+		auto v = comp6771::basic_euclidean_vector<T>();
+		for (auto _ : state) {
+			v = std::move(source);
+			benchmark::DoNotOptimize(v);
+			source = std::move(v);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_default_constructor, double);
+BENCHMARK_TEMPLATE(bm_default_constructor, float);
+BENCHMARK_TEMPLATE(bm_dimension_constructor, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_dimension_constructor, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_value_constructor, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_value_constructor, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_iterator_constructor, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_iterator_constructor, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_initializer_list_constructor, double);
+BENCHMARK_TEMPLATE(bm_initializer_list_constructor, float);
+BENCHMARK_TEMPLATE(bm_copy_constructor, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_copy_constructor, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_move_constructor, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_move_constructor, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_copy_assignment, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_copy_assignment, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_move_assignment, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_move_assignment, float)->Apply(benchmarks::dimensions);
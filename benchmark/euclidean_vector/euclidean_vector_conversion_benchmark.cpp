@@ -0,0 +1,252 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures the EuclideanVector output and type conversions.
+//      The benchmarks are:
+//          1. operator<< into a std::ostringstream
+//          2. conversion to std::vector
+//          3. conversion to std::list
+//          4. write_vectors() of 1000 vectors into a std::ostringstream
+//          5. parse_vectors() of the same text
+//          6. operator>> of the same text, one vector at a time
+//          7. save() of the same 1000 vectors in the binary format
+//          8. load_vectors() of that file
+//          9. opening a mapped .fvecs file of 20000 rows of dimension 128
+//          10. summing the norms of every row of that file, mapped and read into vectors
+//          11. normalising a binary file of 20000 rows through stream_vectors() in chunks
+
+#include "benchmark_helpers.hpp"
+
+#include <comp6771/binary_format.hpp>
+#include <comp6771/mapped_vector_file.hpp>
+#include <comp6771/vector_stream.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	// Items are elements written; bytes are the characters produced.
+	template<typename T>
+	auto bm_output_stream(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto characters = std::int64_t{0};
+		for (auto _ : state) {
+			auto oss = std::ostringstream();
+			oss << v;
+			characters += static_cast<std::int64_t>(oss.tellp());
+			benchmark::DoNotOptimize(oss);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+		state.SetBytesProcessed(characters);
+	}
+
+	// range(0) is the dimension of each of the 1000 vectors; items are elements written
+	template<typename T>
+	auto bm_write_vectors(benchmark::State& state) -> void {
+		auto const vectors = std::vector(1000, benchmarks::make_vector<T>(state.range(0)));
+		auto characters = std::int64_t{0};
+		for (auto _ : state) {
+			auto oss = std::ostringstream();
+			comp6771::write_vectors(oss, vectors);
+			characters += static_cast<std::int64_t>(oss.tellp());
+			benchmark::DoNotOptimize(oss);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000
+		                        * state.range(0));
+		state.SetBytesProcessed(characters);
+	}
+
+	// The text write_vectors() produces for 1000 vectors of the given dimension
+	template<typename T>
+	auto vectors_text(std::int64_t dimension) -> std::string {
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, std::vector(1000, benchmarks::make_vector<T>(dimension)));
+		return oss.str();
+	}
+
+	// range(0) is the dimension of each of the 1000 vectors; items are elements read
+	template<typename T>
+	auto bm_parse_vectors(benchmark::State& state) -> void {
+		auto const text = vectors_text<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::parse_vectors<T>(text));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000
+		                        * state.range(0));
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(text.size()));
+	}
+
+	template<typename T>
+	auto bm_input_stream(benchmark::State& state) -> void {
+		auto const text = vectors_text<T>(state.range(0));
+		auto v = comp6771::basic_euclidean_vector<T>();
+		for (auto _ : state) {
+			auto iss = std::istringstream(text);
+			while (iss >> v) {
+				benchmark::DoNotOptimize(v);
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000
+		                        * state.range(0));
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(text.size()));
+	}
+
+	// range(0) is the dimension of each of the 1000 vectors; items are elements written
+	template<typename T>
+	auto bm_save(benchmark::State& state) -> void {
+		auto const vectors = std::vector(1000, benchmarks::make_vector<T>(state.range(0)));
+		auto bytes = std::int64_t{0};
+		for (auto _ : state) {
+			auto oss = std::ostringstream();
+			comp6771::save(oss, std::span<comp6771::basic_euclidean_vector<T> const>(vectors));
+			bytes += static_cast<std::int64_t>(oss.tellp());
+			benchmark::DoNotOptimize(oss);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000
+		                        * state.range(0));
+		state.SetBytesProcessed(bytes);
+	}
+
+	template<typename T>
+	auto bm_load_vectors(benchmark::State& state) -> void {
+		auto const vectors = std::vector(1000, benchmarks::make_vector<T>(state.range(0)));
+		auto oss = std::ostringstream();
+		comp6771::save(oss, std::span<comp6771::basic_euclidean_vector<T> const>(vectors));
+		auto const file = oss.str();
+		for (auto _ : state) {
+			auto iss = std::istringstream(file);
+			benchmark::DoNotOptimize(comp6771::load_vectors<T>(iss));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000
+		                        * state.range(0));
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(file.size()));
+	}
+
+	constexpr auto fvecs_rows = 20000;
+	constexpr auto fvecs_dimension = 128;
+
+	// Written once, the first time a benchmark asks for it
+	auto fvecs_path() -> std::filesystem::path const& {
+		static auto const path = [] {
+			auto file = std::filesystem::temp_directory_path() / "comp6771_benchmark.fvecs";
+			auto os = std::ofstream(file, std::ios::binary);
+			auto writer = comp6771::fvecs_writer(os);
+			auto const v = benchmarks::make_vector<double>(fvecs_dimension);
+			for (auto row = 0; row < fvecs_rows; ++row) {
+				writer.write(v);
+			}
+			return file;
+		}();
+		return path;
+	}
+
+	auto bm_map_fvecs(benchmark::State& state) -> void {
+		auto const& path = fvecs_path();
+		for (auto _ : state) {
+			auto const file = comp6771::fvecs_file(path);
+			benchmark::DoNotOptimize(file.size());
+		}
+	}
+
+	// Items are elements read
+	auto bm_scan_mapped_fvecs(benchmark::State& state) -> void {
+		auto const file = comp6771::fvecs_file(fvecs_path(),
+		                                       {comp6771::access_pattern::sequential, true});
+		for (auto _ : state) {
+			auto sum = 0.0;
+			for (auto const row : file.rows()) {
+				sum += comp6771::euclidean_norm(row);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * fvecs_rows
+		                        * fvecs_dimension);
+	}
+
+	// The same scan, reading each row into a vector through an std::ifstream
+	auto bm_scan_read_fvecs(benchmark::State& state) -> void {
+		auto row = std::vector<float>(fvecs_dimension);
+		auto v = comp6771::euclidean_vector(fvecs_dimension);
+		for (auto _ : state) {
+			auto is = std::ifstream(fvecs_path(), std::ios::binary);
+			auto sum = 0.0;
+			auto dimension = std::int32_t{0};
+			while (is.read(reinterpret_cast<char*>(&dimension), sizeof(dimension))) {
+				is.read(reinterpret_cast<char*>(row.data()),
+				        static_cast<std::streamsize>(row.size() * sizeof(float)));
+				std::copy(row.begin(), row.end(), v.data_mut());
+				sum += comp6771::euclidean_norm(v);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * fvecs_rows
+		                        * fvecs_dimension);
+	}
+
+	// range(0) is the memory budget in KiB; items are elements read
+	auto bm_stream_normalize(benchmark::State& state) -> void {
+		auto const vectors =
+		   std::vector(fvecs_rows, benchmarks::make_vector<double>(fvecs_dimension));
+		auto oss = std::ostringstream();
+		comp6771::save(oss, std::span<comp6771::euclidean_vector const>(vectors));
+		auto const file = oss.str();
+		auto const options = comp6771::stream_options{static_cast<std::size_t>(state.range(0)) << 10};
+		for (auto _ : state) {
+			auto in = std::istringstream(file);
+			auto out = std::stringstream();
+			auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::binary);
+			auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::binary);
+			benchmark::DoNotOptimize(
+			   comp6771::stream_vectors(reader, writer, options, comp6771::normalize_chunk{}));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * fvecs_rows
+		                        * fvecs_dimension);
+	}
+
+	template<typename T>
+	auto bm_vector_conversion(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto converted = static_cast<std::vector<T>>(v);
+			benchmark::DoNotOptimize(converted);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_list_conversion(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto converted = static_cast<std::list<T>>(v);
+			benchmark::DoNotOptimize(converted);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_output_stream, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_output_stream, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_write_vectors, double)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_write_vectors, float)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_parse_vectors, double)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_parse_vectors, float)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_input_stream, double)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_save, double)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(bm_load_vectors, double)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK(bm_map_fvecs);
+BENCHMARK(bm_scan_mapped_fvecs);
+BENCHMARK(bm_scan_read_fvecs);
+BENCHMARK(bm_stream_normalize)->RangeMultiplier(16)->Range(64, 16 << 10);
+BENCHMARK_TEMPLATE(bm_vector_conversion, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_vector_conversion, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_list_conversion, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_list_conversion, float)->Apply(benchmarks::dimensions);
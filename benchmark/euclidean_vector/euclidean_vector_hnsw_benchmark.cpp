@@ -0,0 +1,178 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures hnsw_index and ivf_index against exact search.
+//      The benchmarks are:
+//          1. building the graph, for a sweep of m and ef_construction
+//          2. search() for a sweep of ef_search, reporting recall@10 against brute_force_index
+//          3. brute_force_index::search() on the same queries, for reference
+//          4. training and filling an ivf_index, for a sweep of lists
+//          5. ivf_index::search() for a sweep of nprobe, reporting recall@10
+
+#include "benchmark_helpers.hpp"
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/hnsw_index.hpp>
+#include <comp6771/ivf_index.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+	constexpr auto dimension = 128;
+	constexpr auto rows = 20000;
+	constexpr auto query_count = 200;
+	constexpr auto k = 10;
+
+	// Rows scattered around 100 random centres, which is closer to real embeddings than uniform
+	// noise and gives the graph some structure to exploit.
+	auto clustered_batch(int count, unsigned seed) -> comp6771::euclidean_vector_batch {
+		// the centres don't depend on the seed, so the database and the queries share them
+		auto centre_engine = std::mt19937_64(0);
+		auto centre_value = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto centres = comp6771::euclidean_vector_batch(100, dimension);
+		for (auto row = 0; row < centres.rows(); ++row) {
+			for (auto i = std::size_t{0}; i < dimension; ++i) {
+				centres[row][i] = centre_value(centre_engine);
+			}
+		}
+
+		auto engine = std::mt19937_64(seed);
+		auto noise = std::normal_distribution<double>(0.0, 0.25);
+
+		auto pick = std::uniform_int_distribution<int>(0, centres.rows() - 1);
+		auto batch = comp6771::euclidean_vector_batch(count, dimension);
+		for (auto row = 0; row < count; ++row) {
+			auto const centre = centres[pick(engine)];
+			for (auto i = std::size_t{0}; i < dimension; ++i) {
+				batch[row][i] = centre[i] + noise(engine);
+			}
+		}
+		return batch;
+	}
+
+	auto database() -> comp6771::euclidean_vector_batch const& {
+		static auto const batch = clustered_batch(rows, 1);
+		return batch;
+	}
+
+	auto queries() -> comp6771::euclidean_vector_batch const& {
+		static auto const batch = clustered_batch(query_count, 2);
+		return batch;
+	}
+
+	auto ground_truth() -> std::vector<std::vector<comp6771::neighbour>> const& {
+		static auto const exact = comp6771::brute_force_index(database()).search(queries(), k);
+		return exact;
+	}
+
+	// One index with the default m and ef_construction, shared by every search benchmark
+	auto default_index() -> comp6771::hnsw_index& {
+		static auto index = comp6771::hnsw_index(database());
+		return index;
+	}
+
+	auto recall(std::vector<std::vector<comp6771::neighbour>> const& found) -> double {
+		auto hits = 0;
+		for (auto q = std::size_t{0}; q < found.size(); ++q) {
+			for (auto const& expected : ground_truth()[q]) {
+				hits += std::any_of(found[q].begin(), found[q].end(), [&](auto const& n) {
+					return n.id == expected.id;
+				});
+			}
+		}
+		return static_cast<double>(hits) / static_cast<double>(found.size() * k);
+	}
+
+	// range(0) is m, range(1) is ef_construction
+	auto bm_hnsw_build(benchmark::State& state) -> void {
+		auto const tuning = comp6771::hnsw_parameters{.m = static_cast<int>(state.range(0)),
+		                                              .ef_construction =
+		                                                 static_cast<int>(state.range(1))};
+		auto const& batch = database();
+		for (auto _ : state) {
+			auto index = comp6771::hnsw_index(batch, comp6771::metric::l2, tuning);
+			benchmark::DoNotOptimize(index.max_level());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * rows);
+	}
+
+	// range(0) is ef_search; items are queries
+	auto bm_hnsw_search(benchmark::State& state) -> void {
+		auto& index = default_index();
+		index.set_ef_search(static_cast<int>(state.range(0)));
+		auto const& batch = queries();
+		auto found = std::vector<std::vector<comp6771::neighbour>>(query_count);
+		for (auto _ : state) {
+			for (auto row = 0; row < batch.rows(); ++row) {
+				found[static_cast<std::size_t>(row)] = index.search(batch[row], k);
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * query_count);
+		state.counters["recall@10"] = recall(found);
+	}
+
+	// range(0) is lists
+	auto bm_ivf_build(benchmark::State& state) -> void {
+		auto const tuning = comp6771::ivf_parameters{.lists = static_cast<int>(state.range(0))};
+		auto const& batch = database();
+		for (auto _ : state) {
+			auto index = comp6771::ivf_index(batch, comp6771::metric::l2, tuning);
+			benchmark::DoNotOptimize(index.size());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * rows);
+	}
+
+	// range(0) is nprobe, over 128 lists; items are queries
+	auto bm_ivf_search(benchmark::State& state) -> void {
+		static auto index = comp6771::ivf_index(database(), comp6771::metric::l2, {.lists = 128});
+		index.set_nprobe(static_cast<int>(state.range(0)));
+		auto const& batch = queries();
+		auto found = std::vector<std::vector<comp6771::neighbour>>(query_count);
+		for (auto _ : state) {
+			for (auto row = 0; row < batch.rows(); ++row) {
+				found[static_cast<std::size_t>(row)] = index.search(batch[row], k);
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * query_count);
+		state.counters["recall@10"] = recall(found);
+	}
+
+	auto bm_brute_force_search(benchmark::State& state) -> void {
+		static auto const index = comp6771::brute_force_index(database());
+		auto const& batch = queries();
+		for (auto _ : state) {
+			for (auto row = 0; row < batch.rows(); ++row) {
+				benchmark::DoNotOptimize(index.search(batch[row], k));
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * query_count);
+	}
+} // namespace
+
+BENCHMARK(bm_hnsw_build)
+   ->ArgsProduct({{8, 16, 32}, {100, 200}})
+   ->ArgNames({"m", "ef_construction"})
+   ->Unit(benchmark::kMillisecond)
+   ->Iterations(1);
+BENCHMARK(bm_hnsw_search)
+   ->RangeMultiplier(2)
+   ->Range(16, 512)
+   ->ArgName("ef_search")
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_brute_force_search)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_ivf_build)
+   ->RangeMultiplier(4)
+   ->Range(32, 512)
+   ->ArgName("lists")
+   ->Unit(benchmark::kMillisecond)
+   ->Iterations(1);
+BENCHMARK(bm_ivf_search)
+   ->RangeMultiplier(2)
+   ->Range(1, 64)
+   ->ArgName("nprobe")
+   ->Unit(benchmark::kMillisecond);
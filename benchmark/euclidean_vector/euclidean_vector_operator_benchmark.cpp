@@ -0,0 +1,175 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures the EuclideanVector operators.
+//      The benchmarks are:
+//          1. the compound operators +=, -=, *= and /=
+//          2. the binary operators +, -, * and /, on lvalues and on temporaries
+//          3. negation, subscript and comparison
+
+#include "benchmark_helpers.hpp"
+
+#include <utility>
+
+namespace {
+	// The factor is one so that repeated scaling never overflows or reaches subnormals, which
+	// would time the slow paths of the FPU rather than the vector code.
+	template<typename T>
+	constexpr auto factor = static_cast<T>(1);
+
+	template<typename T>
+	auto bm_compound_addition(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v += w;
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 3);
+	}
+
+	template<typename T>
+	auto bm_compound_subtraction(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v -= w;
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 3);
+	}
+
+	template<typename T>
+	auto bm_compound_multiplication(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v *= factor<T>;
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_compound_division(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v /= factor<T>;
+			benchmark::DoNotOptimize(v);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_addition(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto sum = v + w;
+			benchmark::DoNotOptimize(sum);
+		}
+		benchmarks::set_throughput<T>(state, 3);
+	}
+
+	template<typename T>
+	auto bm_subtraction(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto difference = v - w;
+			benchmark::DoNotOptimize(difference);
+		}
+		benchmarks::set_throughput<T>(state, 3);
+	}
+
+	template<typename T>
+	auto bm_multiplication(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto product = v * factor<T>;
+			benchmark::DoNotOptimize(product);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_division(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto quotient = v / factor<T>;
+			benchmark::DoNotOptimize(quotient);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// a + b + c: the second addition reuses the temporary's storage instead of allocating.
+	template<typename T>
+	auto bm_chained_addition(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto sum = v + w + v;
+			benchmark::DoNotOptimize(sum);
+		}
+		benchmarks::set_throughput<T>(state, 5);
+	}
+
+	template<typename T>
+	auto bm_negation(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto negated = -v;
+			benchmark::DoNotOptimize(negated);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_subscript(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const dimension = v.dimensions();
+		for (auto _ : state) {
+			auto sum = T{0};
+			for (auto i = 0; i < dimension; ++i) {
+				sum += v[i];
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		benchmarks::set_throughput<T>(state, 1);
+	}
+
+	// Equal vectors, so every element is compared.
+	template<typename T>
+	auto bm_equal(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(v == w);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_compound_addition, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_addition, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_subtraction, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_subtraction, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_multiplication, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_multiplication, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_division, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_compound_division, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_addition, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_addition, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_subtraction, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_subtraction, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_multiplication, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_multiplication, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_division, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_division, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_chained_addition, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_chained_addition, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_negation, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_negation, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_subscript, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_subscript, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_equal, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_equal, float)->Apply(benchmarks::dimensions);
@@ -0,0 +1,139 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures nearest-neighbour search.
+//      The benchmarks are:
+//          1. brute_force_index::search() one query at a time
+//          2. brute_force_index::search() on a batch of queries
+//          3. building a kd_tree over 3-D points
+//          4. kd_tree::search(), radius_search() and brute force over the same 3-D points
+
+#include "benchmark_helpers.hpp"
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/kd_tree.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+	constexpr auto dimension = 128;
+
+	auto random_batch(std::int64_t rows, unsigned seed) -> comp6771::euclidean_vector_batch {
+		auto engine = std::mt19937_64(seed);
+		auto value = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto batch = comp6771::euclidean_vector_batch(static_cast<int>(rows), dimension);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			for (auto i = std::size_t{0}; i < dimension; ++i) {
+				batch[row][i] = value(engine);
+			}
+		}
+		return batch;
+	}
+
+	// range(0) database rows, range(1) queries searched one at a time for their 10 nearest
+	auto bm_brute_force_single(benchmark::State& state) -> void {
+		auto const index = comp6771::brute_force_index(random_batch(state.range(0), 1));
+		auto const queries = random_batch(state.range(1), 2);
+		for (auto _ : state) {
+			for (auto row = 0; row < queries.rows(); ++row) {
+				benchmark::DoNotOptimize(index.search(queries[row], 10));
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(1));
+	}
+
+	// The same queries as one batch, so the database is read once per iteration
+	auto bm_brute_force_batch(benchmark::State& state) -> void {
+		auto const index = comp6771::brute_force_index(random_batch(state.range(0), 1));
+		auto const queries = random_batch(state.range(1), 2);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(index.search(queries, 10));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(1));
+	}
+
+	auto random_points(std::int64_t count, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto value = std::uniform_real_distribution<double>(-100.0, 100.0);
+		auto points = std::vector<comp6771::euclidean_vector>();
+		points.reserve(static_cast<std::size_t>(count));
+		for (auto i = std::int64_t{0}; i < count; ++i) {
+			points.push_back(comp6771::euclidean_vector{value(engine), value(engine), value(engine)});
+		}
+		return points;
+	}
+
+	auto bm_kd_tree_build(benchmark::State& state) -> void {
+		auto const points = random_points(state.range(0), 1);
+		for (auto _ : state) {
+			auto tree = comp6771::kd_tree(points);
+			benchmark::DoNotOptimize(tree.size());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+	}
+
+	// range(0) points, 1000 queries for their range(1) nearest
+	auto bm_kd_tree_search(benchmark::State& state) -> void {
+		auto const tree = comp6771::kd_tree(random_points(state.range(0), 1));
+		auto const queries = random_points(1000, 2);
+		auto const k = static_cast<int>(state.range(1));
+		for (auto _ : state) {
+			for (auto const& query : queries) {
+				benchmark::DoNotOptimize(tree.search(query, k));
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000);
+	}
+
+	// range(0) points, 1000 queries for every point within 5 (about 16 on average at 2^20 points)
+	auto bm_kd_tree_radius(benchmark::State& state) -> void {
+		auto const tree = comp6771::kd_tree(random_points(state.range(0), 1));
+		auto const queries = random_points(1000, 2);
+		for (auto _ : state) {
+			for (auto const& query : queries) {
+				benchmark::DoNotOptimize(tree.radius_search(query, 5.0));
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000);
+	}
+
+	auto bm_brute_force_3d(benchmark::State& state) -> void {
+		auto const index = comp6771::brute_force_index(random_points(state.range(0), 1));
+		auto const queries = random_points(1000, 2);
+		auto const k = static_cast<int>(state.range(1));
+		for (auto _ : state) {
+			for (auto const& query : queries) {
+				benchmark::DoNotOptimize(index.search(query, k));
+			}
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * 1000);
+	}
+} // namespace
+
+BENCHMARK(bm_brute_force_single)
+   ->ArgsProduct({{1 << 12, 1 << 16}, {1, 64}})
+   ->ArgNames({"rows", "queries"})
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_brute_force_batch)
+   ->ArgsProduct({{1 << 12, 1 << 16}, {1, 64}})
+   ->ArgNames({"rows", "queries"})
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_kd_tree_build)
+   ->RangeMultiplier(16)
+   ->Range(1 << 12, 1 << 20)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_kd_tree_search)
+   ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20}, {1, 10}})
+   ->ArgNames({"points", "k"})
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_kd_tree_radius)
+   ->RangeMultiplier(16)
+   ->Range(1 << 12, 1 << 20)
+   ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_brute_force_3d)
+   ->ArgsProduct({{1 << 12, 1 << 16}, {1, 10}})
+   ->ArgNames({"points", "k"})
+   ->Unit(benchmark::kMillisecond);
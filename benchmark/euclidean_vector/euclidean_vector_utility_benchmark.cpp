@@ -0,0 +1,176 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This benchmark file measures the EuclideanVector utility functions.
+//      The benchmarks are:
+//          1. dot()
+//          2. euclidean_norm() with a cold cache, recomputed every call
+//          3. euclidean_norm() with a warm cache
+//          4. unit()
+//          5. a single-element write followed by euclidean_norm(), with and without the
+//             incremental norm mode
+//          6. distance(), against euclidean_norm() of the difference
+//          7. cosine_similarity() with cold and warm norm caches
+//          8. normalize() in place, on one vector and on a span of 1024 vectors
+
+#include "benchmark_helpers.hpp"
+
+#include <span>
+
+namespace {
+	template<typename T>
+	auto bm_dot(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(v, w));
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	template<typename T>
+	auto bm_euclidean_norm_cold(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			// writing through the non-const subscript discards the cached norm
+			v[0] = v[0];
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		benchmarks::set_throughput<T>(state, 1);
+	}
+
+	template<typename T>
+	auto bm_euclidean_norm_warm(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	// One write then one query per iteration; the items counted are queries, since with the
+	// incremental mode the cost no longer grows with the dimension.
+	template<typename T>
+	auto bm_sparse_update(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		v.set_incremental_norm(state.range(1) != 0);
+		auto i = 0;
+		for (auto _ : state) {
+			v[i] = static_cast<T>(i % 5);
+			i = i + 1 == v.dimensions() ? 0 : i + 1;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	template<typename T>
+	auto bm_distance(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::distance(v, w));
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// What distance() replaces: a temporary for the difference, then a second pass for its norm.
+	template<typename T>
+	auto bm_norm_of_difference(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v - w));
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// Every call starts with both norm caches empty, so each one needs the fused pass.
+	template<typename T>
+	auto bm_cosine_similarity_cold(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		auto w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v[0] = v[0];
+			w[0] = w[0];
+			benchmark::DoNotOptimize(comp6771::cosine_similarity(v, w));
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// Both norms are cached after the first call, so the rest only compute the dot product.
+	template<typename T>
+	auto bm_cosine_similarity_warm(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		auto const w = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::cosine_similarity(v, w));
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// The source keeps its norm cached, so this times the copy and the division.
+	template<typename T>
+	auto bm_unit(benchmark::State& state) -> void {
+		auto const v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			auto u = comp6771::unit(v);
+			benchmark::DoNotOptimize(u);
+		}
+		benchmarks::set_throughput<T>(state, 2);
+	}
+
+	// The norm is recomputed every call, so this times a reduction and a scale with no copy.
+	template<typename T>
+	auto bm_normalize(benchmark::State& state) -> void {
+		auto v = benchmarks::make_vector<T>(state.range(0));
+		for (auto _ : state) {
+			v[0] = v[0];
+			benchmark::DoNotOptimize(v.normalize());
+		}
+		benchmarks::set_throughput<T>(state, 3);
+	}
+
+	template<typename T>
+	auto bm_normalize_span(benchmark::State& state) -> void {
+		auto vectors = std::vector<comp6771::basic_euclidean_vector<T>>(
+		   1024,
+		   benchmarks::make_vector<T>(state.range(0)));
+		for (auto _ : state) {
+			for (auto& v : vectors) {
+				v[0] = v[0];
+			}
+			comp6771::normalize(std::span(vectors));
+			benchmark::ClobberMemory();
+		}
+		auto const vectors_processed = static_cast<std::int64_t>(state.iterations()) * 1024;
+		state.SetItemsProcessed(vectors_processed * state.range(0));
+	}
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_dot, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_dot, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_euclidean_norm_cold, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_euclidean_norm_cold, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_euclidean_norm_warm, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_euclidean_norm_warm, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_sparse_update, double)
+   ->ArgsProduct({benchmark::CreateRange(1, 1 << 20, 8), {0, 1}})
+   ->ArgNames({"dimension", "incremental"});
+BENCHMARK_TEMPLATE(bm_sparse_update, float)
+   ->ArgsProduct({benchmark::CreateRange(1, 1 << 20, 8), {0, 1}})
+   ->ArgNames({"dimension", "incremental"});
+BENCHMARK_TEMPLATE(bm_distance, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_distance, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_norm_of_difference, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_norm_of_difference, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_cosine_similarity_cold, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_cosine_similarity_cold, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_cosine_similarity_warm, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_cosine_similarity_warm, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_unit, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_unit, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_normalize, double)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_normalize, float)->Apply(benchmarks::dimensions);
+BENCHMARK_TEMPLATE(bm_normalize_span, double)->RangeMultiplier(8)->Range(1, 1 << 12);
+BENCHMARK_TEMPLATE(bm_normalize_span, float)->RangeMultiplier(8)->Range(1, 1 << 12);
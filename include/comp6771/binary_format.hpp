@@ -0,0 +1,137 @@
+#ifndef COMP6771_BINARY_FORMAT_HPP
+#define COMP6771_BINARY_FORMAT_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <span>
+#include <vector>
+
+// A binary format for checkpointing vectors without going through text. A file is a 64-byte header
+// followed by count * dimension packed float or double magnitudes, one vector after another, in the
+// writer's byte order. The header holds:
+//
+//    offset  size  field
+//         0     8  magic, "C6771VEC"
+//         8     4  version, binary_format_version
+//        12     4  byte order mark, 0x01020304 as the writer stores it
+//        16     4  scalar size in bytes: 4 for float, 8 for double
+//        20     4  reserved, zero
+//        24     8  dimension
+//        32     8  count
+//        40    24  reserved, zero
+//
+// The header keeps the magnitudes 64-byte aligned relative to the start of the file, so a file
+// that is mapped or read whole into aligned memory can be used in place through vector_file_view.
+namespace comp6771 {
+	inline constexpr auto binary_format_version = std::uint32_t{1};
+	inline constexpr auto binary_header_size = std::size_t{64};
+
+	// Every vector must have the same dimension, and a file can't hold vectors with no dimensions.
+	// Either mistake throws before anything is written. A std::vector of either vector type converts
+	// to the span overloads for it.
+	template<vector_scalar T>
+	auto save(std::ostream& os, basic_euclidean_vector<T> const& v) -> void;
+	template<vector_scalar T>
+	auto save(std::ostream& os, std::span<basic_euclidean_vector<T> const> vectors) -> void;
+	auto save(std::ostream& os, std::span<euclidean_vector const> vectors) -> void;
+	auto save(std::ostream& os, std::span<float_euclidean_vector const> vectors) -> void;
+	auto save(std::ostream& os, euclidean_vector_batch const& batch) -> void;
+
+	// The loaders accept either scalar size and either byte order, converting as they copy. Each
+	// reads exactly one file, so several files written back to back load one after another. A
+	// header claiming more than the stream holds throws before anything is allocated for it when
+	// the stream can seek; otherwise the result grows only as the magnitudes arrive.
+	template<vector_scalar T = double>
+	auto load_vector(std::istream& is) -> basic_euclidean_vector<T>; // Throws unless count is 1
+	template<vector_scalar T = double>
+	auto load_vectors(std::istream& is) -> std::vector<basic_euclidean_vector<T>>;
+	auto load_batch(std::istream& is) -> euclidean_vector_batch;
+
+	// Reads one file a row at a time, for files too large to load whole. The header is read and
+	// checked on construction, and rows are converted as load_batch() converts them.
+	class binary_reader {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit binary_reader(std::istream& is);
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto size() const noexcept -> int; // rows in the file
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto remaining() const noexcept -> int; // rows not yet read
+		// Reads the next row into `out`, which must have the file's dimension. Returns false, leaving
+		// `out` alone, once every row has been read.
+		auto read(mutable_euclidean_vector_view out) -> bool;
+
+	private:
+		std::istream* is_;
+		std::size_t scalar_size_;
+		std::size_t dimension_;
+		std::size_t count_;
+		std::size_t next_;
+		bool swapped_;
+	};
+
+	// Writes one file a row at a time, for files too large to hold whole. The header is written on
+	// construction with a count of zero, and finish() goes back to fill the count in, so the stream
+	// must be seekable, like an std::ofstream or std::stringstream.
+	class binary_writer {
+	public:
+		/*
+		 * Constructors
+		 */
+		binary_writer(std::ostream& os, int dimension);
+
+		/*
+		 * Member Functions
+		 */
+		auto write(euclidean_vector_view row) -> void; // Throws unless row has the file's dimension
+		auto finish() -> void; // Writes the count into the header, leaving the stream at the end
+		[[nodiscard]] auto rows() const noexcept -> int;
+
+	private:
+		std::ostream* os_;
+		std::streamoff start_; // where the header begins in the stream
+		std::size_t dimension_;
+		std::size_t count_;
+	};
+
+	// A file of doubles in this machine's byte order, used in place: the header is checked once and
+	// each row is a euclidean_vector_view into the bytes, with nothing parsed or copied. The bytes
+	// must be 8-byte aligned and outlive the view.
+	class vector_file_view {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit vector_file_view(std::span<std::byte const> file);
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator[](int row) const noexcept -> euclidean_vector_view;
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto at(int row) const -> euclidean_vector_view;
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto data() const noexcept -> double const*; // size() * dimensions(), packed
+
+	private:
+		double const* magnitude_;
+		std::size_t dimension_;
+		std::size_t count_;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_BINARY_FORMAT_HPP
@@ -0,0 +1,90 @@
+#ifndef COMP6771_BRUTE_FORCE_INDEX_HPP
+#define COMP6771_BRUTE_FORCE_INDEX_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	// How a nearest-neighbour search ranks the database against a query.
+	enum class metric {
+		l2, // smallest distance() first
+		inner_product, // largest dot() first
+		cosine, // largest cosine_similarity() first
+	};
+
+	// One search result: the database row and its distance (l2) or similarity (inner_product,
+	// cosine) to the query.
+	struct neighbour {
+		int id;
+		double score;
+
+		friend auto operator==(neighbour const&, neighbour const&) -> bool = default;
+	};
+
+	// Exact k-nearest-neighbour search that compares the query with every database row. It is the
+	// reference the approximate indexes are measured against.
+	//
+	// The database norms are computed once, so each comparison is a single dot product: l2 uses
+	// |q|^2 + |x|^2 - 2 q.x and cosine multiplies by the stored 1 / |x|. The scan is split across
+	// the hardware threads, and a batch of queries is matched against each block of rows while it
+	// is in cache, so the database is read from memory once per batch rather than once per query.
+	// Results are best first, with ties broken by the lower id. The expanded l2 form loses digits
+	// to cancellation when a row is very close to the query, so the reported distance is accurate
+	// to about sqrt(eps * (|q|^2 + |x|^2)) rather than to the last bit of distance().
+	class brute_force_index {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit brute_force_index(euclidean_vector_batch database, metric = metric::l2);
+		explicit brute_force_index(std::span<euclidean_vector const>, metric = metric::l2);
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto distance_metric() const noexcept -> metric;
+		[[nodiscard]] auto database() const noexcept -> euclidean_vector_batch const&;
+
+		// Appends a row; its id is the previous size()
+		auto add(euclidean_vector const&) -> void;
+
+		// The min(k, size()) rows nearest to the query, best first
+		[[nodiscard]] auto search(euclidean_vector const& query, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto search(euclidean_vector_view query, int k) const
+		   -> std::vector<neighbour>;
+		// The same for every row of `queries`, in one pass over the database
+		[[nodiscard]] auto search(euclidean_vector_batch const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>>;
+
+		/*
+		 * Helper Functions
+		 */
+		static auto throw_if_k_is_negative(int k) -> void;
+
+	private:
+		// A query row with the norm the metric needs: |q|^2 for l2, 1 / |q| for cosine.
+		struct query {
+			double const* magnitude;
+			double norm;
+		};
+
+		auto row_norm(double const* magnitude, std::size_t length) const -> double;
+		auto prepare(double const* magnitude, std::size_t length) const -> query;
+		auto scan(std::span<query const>, std::size_t length, int k) const
+		   -> std::vector<std::vector<neighbour>>;
+
+		euclidean_vector_batch database_;
+		std::vector<double> norms_; // |x|^2 for l2, 1 / |x| for cosine, unused for inner_product
+		metric metric_;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_BRUTE_FORCE_INDEX_HPP
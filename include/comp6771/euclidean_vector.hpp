@@ -1,17 +1,38 @@
 #ifndef COMP6771_EUCLIDEAN_VECTOR_HPP
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
+#include <comp6771/kernels.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <memory>
 #include <numeric>
+#include <ranges>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Vectors with at most this many dimensions store their magnitudes inside the object rather than on
+// the heap. Every translation unit must agree on the value, so set it through the build system.
+#ifndef COMP6771_EUCLIDEAN_VECTOR_INLINE_DIMENSIONS
+#	define COMP6771_EUCLIDEAN_VECTOR_INLINE_DIMENSIONS 8
+#endif
+
 namespace comp6771 {
 	class euclidean_vector_error : public std::runtime_error {
 	public:
@@ -19,105 +40,1122 @@ namespace comp6771 {
 		: std::runtime_error(what) {}
 	};
 
-	class euclidean_vector {
+	// Every lazy expression node derives from this tag; see "Expression Templates" below.
+	class vector_expression_base {};
+
+	template<typename E>
+	concept vector_expression = std::derived_from<E, vector_expression_base>;
+
+	// An expression whose elements already sit contiguously in memory, so the SIMD kernels can be
+	// used on it directly.
+	template<typename E>
+	concept contiguous_vector_expression = vector_expression<E> and requires(E const& e) {
+		{ e.data() } -> std::convertible_to<double const*>;
+	};
+
+	// The same for an expression stored as floats, such as a row of an .fvecs file, which the float
+	// kernels take directly.
+	template<typename E>
+	concept contiguous_float_expression = vector_expression<E> and requires(E const& e) {
+		{ e.data() } -> std::same_as<float const*>;
+	};
+
+	class vector_reference;
+
+	template<std::size_t N>
+	class fixed_euclidean_vector;
+
+	namespace detail {
+		// A copyable atomic for the caches that const members fill in. Concurrent const calls on a
+		// shared vector may race to store the same value, which is only well-defined through an
+		// atomic; relaxed loads and stores compile to plain moves, so single-threaded code pays
+		// nothing for it. Copying is not atomic and, like any write, must not overlap other access.
+		template<typename T>
+		class relaxed_atomic {
+		public:
+			static_assert(std::atomic<T>::is_always_lock_free);
+
+			constexpr relaxed_atomic(T value) noexcept // NOLINT(google-explicit-constructor)
+			: value_{value} {}
+
+			relaxed_atomic(relaxed_atomic const& other) noexcept
+			: value_{other.load()} {}
+
+			auto operator=(relaxed_atomic const& other) noexcept -> relaxed_atomic& {
+				store(other.load());
+				return *this;
+			}
+
+			auto operator=(T value) noexcept -> relaxed_atomic& {
+				store(value);
+				return *this;
+			}
+
+			operator T() const noexcept { // NOLINT(google-explicit-constructor)
+				return load();
+			}
+
+			[[nodiscard]] auto load(std::memory_order order = std::memory_order_relaxed) const noexcept
+			   -> T {
+				return value_.load(order);
+			}
+
+			auto store(T value, std::memory_order order = std::memory_order_relaxed) noexcept -> void {
+				value_.store(value, order);
+			}
+
+		private:
+			std::atomic<T> value_;
+		};
+	} // namespace detail
+
+	// The scalar types basic_euclidean_vector is built for.
+	template<typename T>
+	concept vector_scalar = std::same_as<T, float> or std::same_as<T, double>;
+
+	template<vector_scalar T>
+	class basic_euclidean_vector;
+
+	namespace detail {
+		// Appends "[a b c]" to `out`. std::to_chars prints each element in the shortest form that
+		// reads back to the same value, without consulting a locale or the stream's flags.
+		template<vector_scalar T>
+		auto append_text(std::string& out, T const* magnitude, std::size_t dimension) -> void;
+		// A per-thread buffer for append_text(), reused from one call to the next
+		auto text_buffer() noexcept -> std::string&;
+		// Hands the buffer to the stream in one os.write() and empties it. A buffer grown past
+		// 1 MiB by a very long vector is released rather than kept for the rest of the thread.
+		auto flush_text(std::ostream& os, std::string& buffer) -> std::ostream&;
+		// Reads "[a b c]" into `vec`, skipping whitespace before it. Malformed text sets failbit
+		// and leaves `vec` as it was.
+		template<vector_scalar T>
+		auto read_text(std::istream& is, basic_euclidean_vector<T>& vec) -> std::istream&;
+	} // namespace detail
+
+	// A vector of magnitudes stored as T. float halves the memory and bandwidth of double and
+	// doubles the SIMD width of the element-wise operations. Reductions (dot, euclidean_norm and the
+	// norm behind unit) accumulate in double and return double for either scalar type, so float
+	// storage doesn't lose precision to long sums.
+	template<vector_scalar T>
+	class basic_euclidean_vector {
 	public:
+		using value_type = T;
+		class reference;
+
+		static constexpr std::size_t inline_dimensions = COMP6771_EUCLIDEAN_VECTOR_INLINE_DIMENSIONS;
+		// Largest rounding error, relative to the sum of squares, that the incremental norm mode
+		// lets build up before it recomputes the sum exactly.
+		static constexpr double incremental_norm_tolerance = 0x1p-36;
+
 		/*
 		 * Constructors
 		 */
-		euclidean_vector() noexcept;
-		explicit euclidean_vector(int) noexcept;
-		euclidean_vector(int, double) noexcept;
-		euclidean_vector(std::vector<double>::const_iterator,
-		                 std::vector<double>::const_iterator) noexcept;
-		euclidean_vector(std::initializer_list<double>) noexcept;
+		basic_euclidean_vector() noexcept;
+		explicit basic_euclidean_vector(int) noexcept;
+		basic_euclidean_vector(int, T) noexcept;
+		basic_euclidean_vector(typename std::vector<T>::const_iterator,
+		                       typename std::vector<T>::const_iterator) noexcept;
+		basic_euclidean_vector(std::initializer_list<T>) noexcept;
 
 		// Copy Constructor
-		euclidean_vector(euclidean_vector const&) noexcept;
+		basic_euclidean_vector(basic_euclidean_vector const&) noexcept;
 
 		// Move Constructor
-		euclidean_vector(euclidean_vector&&) noexcept;
+		basic_euclidean_vector(basic_euclidean_vector&&) noexcept;
+
+		// Evaluates a lazy expression in a single pass
+		template<vector_expression E>
+		explicit basic_euclidean_vector(E const&) noexcept;
 
 		// Destructor
-		~euclidean_vector() noexcept = default;
+		~basic_euclidean_vector() noexcept = default;
 
 		/*
 		 * Operator Overloads
 		 */
-		auto operator=(euclidean_vector const&) noexcept -> euclidean_vector&; // Copy Assignment
-		auto operator=(euclidean_vector&&) noexcept -> euclidean_vector&; // Move Assignment
+		auto operator=(basic_euclidean_vector const&) -> basic_euclidean_vector&; // Copy Assignment
+		auto operator=(basic_euclidean_vector&&) noexcept
+		   -> basic_euclidean_vector&; // Move Assignment
+		template<vector_expression E>
+		auto operator=(E const&) noexcept -> basic_euclidean_vector&; // Expression Assignment
 
-		// Subscript
-		auto operator[](int index) noexcept -> double&;
-		auto operator[](int index) const noexcept -> const double&;
+		// Subscript. Reading through the returned reference keeps the cached norm.
+		auto operator[](int index) noexcept -> reference;
+		auto operator[](int index) const noexcept -> T const&;
 
-		auto operator+() const noexcept -> euclidean_vector; // Unary Plus
-		auto operator-() const noexcept -> euclidean_vector; // Negation
+		auto operator+() const noexcept -> basic_euclidean_vector; // Unary Plus
+		auto operator-() const noexcept -> basic_euclidean_vector; // Negation
 
-		auto operator+=(euclidean_vector const&) -> euclidean_vector&; // Compound Addition
-		auto operator-=(euclidean_vector const&) -> euclidean_vector&; // Compound Subtraction
-		auto operator*=(double) noexcept -> euclidean_vector&; // Compound Multiplication
-		auto operator/=(double) -> euclidean_vector&; // Compound Division
+		auto operator+=(basic_euclidean_vector const&)
+		   -> basic_euclidean_vector&; // Compound Addition
+		auto operator-=(basic_euclidean_vector const&)
+		   -> basic_euclidean_vector&; // Compound Subtraction
+		auto operator*=(T) noexcept -> basic_euclidean_vector&; // Compound Multiplication
+		auto operator/=(T) -> basic_euclidean_vector&; // Compound Division
+		template<vector_expression E>
+		auto operator+=(E const&) -> basic_euclidean_vector&; // Fused Compound Addition
+		template<vector_expression E>
+		auto operator-=(E const&) -> basic_euclidean_vector&; // Fused Compound Subtraction
 
-		explicit operator std::vector<double>() const noexcept; // Vector Type Conversion
-		explicit operator std::list<double>() const noexcept; // List Type Conversion
+		explicit operator std::vector<T>() const noexcept; // Vector Type Conversion
+		explicit operator std::list<T>() const noexcept; // List Type Conversion
 
 		/*
 		 * Member Functions
 		 */
-		[[nodiscard]] auto at(int) const -> double; // Returns the value of the magnitude
-		[[nodiscard]] auto at(int) -> double&; // Returns the reference of the magnitude
+		[[nodiscard]] auto at(int) const -> T; // Returns the value of the magnitude
+		[[nodiscard]] auto at(int) -> reference; // Returns the reference of the magnitude
 		[[nodiscard]] auto dimensions() const -> int; // Return the number of dimensions
 
+		auto set(int index, T value) noexcept -> void; // Writes one magnitude
+		[[nodiscard]] auto data() const noexcept -> T const*; // Read-only access to the magnitudes
+		// Writable access to the magnitudes. The cached norm is dropped now, so finish writing
+		// through the pointer before the next euclidean_norm() or unit().
+		[[nodiscard]] auto data_mut() noexcept -> T*;
+
+		// Scales the vector to unit length in place, multiplying by the reciprocal of the norm, and
+		// caches a norm of 1. Throws the same errors as unit(). The result can differ from unit()
+		// in the last bit of each element, since unit() divides.
+		auto normalize() -> basic_euclidean_vector&;
+
+		// Incremental norm mode, off by default. The vector keeps its sum of squares and adjusts it
+		// in O(1) whenever one element is written through operator[], at() or set(), so
+		// euclidean_norm() after a few element writes costs a square root instead of a pass over
+		// every element. Each adjustment adds to a bound on the rounding error; once that bound
+		// passes incremental_norm_tolerance of the sum, the next euclidean_norm() recomputes it
+		// exactly. Whole-vector operations and data_mut() also cause an exact recomputation. The
+		// mode is copied along with the vector.
+		auto set_incremental_norm(bool enabled) noexcept -> void;
+		[[nodiscard]] auto incremental_norm() const noexcept -> bool;
+
 		/*
 		 * Friend Functions
 		 */
-		friend auto operator==(euclidean_vector const&,
-		                       euclidean_vector const&) noexcept -> bool; // Equal
-		friend auto operator!=(euclidean_vector const&,
-		                       euclidean_vector const&) noexcept -> bool; // Not Equal
+		friend auto operator==(basic_euclidean_vector const& v1,
+		                       basic_euclidean_vector const& v2) noexcept -> bool { // Equal
+			return is_dimension_equal(v1, v2)
+			       and std::equal(v1.data(), v1.data() + v1.dimension_, v2.data());
+		}
+
+		friend auto operator!=(basic_euclidean_vector const& v1,
+		                       basic_euclidean_vector const& v2) noexcept -> bool { // Not Equal
+			return not(v1 == v2);
+		}
+
+		friend auto operator+(basic_euclidean_vector const& v1, basic_euclidean_vector const& v2)
+		   -> basic_euclidean_vector { // Addition
+			auto lhs_cp = basic_euclidean_vector(v1);
+			return lhs_cp += v2;
+		}
+
+		friend auto operator-(basic_euclidean_vector const& v1, basic_euclidean_vector const& v2)
+		   -> basic_euclidean_vector { // Subtraction
+			auto lhs_cp = basic_euclidean_vector(v1);
+			return lhs_cp -= v2;
+		}
+
+		friend auto operator*(basic_euclidean_vector const& vec, T factor) noexcept
+		   -> basic_euclidean_vector { // Multiply
+			auto vec_cp = basic_euclidean_vector(vec);
+			return vec_cp *= factor;
+		}
+
+		friend auto operator/(basic_euclidean_vector const& vec, T factor)
+		   -> basic_euclidean_vector { // Divide
+			auto vec_cp = basic_euclidean_vector(vec);
+			return vec_cp /= factor;
+		}
+
+		// Overloads for temporaries compute into the temporary's storage and move it out
+		friend auto operator+(basic_euclidean_vector&& v1, basic_euclidean_vector const& v2)
+		   -> basic_euclidean_vector {
+			v1 += v2;
+			return std::move(v1);
+		}
 
-		friend auto operator+(euclidean_vector const&,
-		                      euclidean_vector const&) -> euclidean_vector; // Addition
-		friend auto operator-(euclidean_vector const&,
-		                      euclidean_vector const&) -> euclidean_vector; // Subtraction
+		friend auto operator+(basic_euclidean_vector const& v1, basic_euclidean_vector&& v2)
+		   -> basic_euclidean_vector {
+			throw_if_dimension_not_equal(v1, v2);
+			// floating-point addition is commutative, so this matches v1 + v2 exactly
+			v2 += v1;
+			return std::move(v2);
+		}
 
-		friend auto operator*(euclidean_vector const&, double) noexcept -> euclidean_vector; // Multiply
-		friend auto operator/(euclidean_vector const&, double) -> euclidean_vector; // Divide
+		friend auto operator+(basic_euclidean_vector&& v1, basic_euclidean_vector&& v2)
+		   -> basic_euclidean_vector {
+			v1 += v2;
+			return std::move(v1);
+		}
 
-		friend auto operator<<(std::ostream&,
-		                       euclidean_vector const&) noexcept -> std::ostream&; // Output Stream
+		friend auto operator-(basic_euclidean_vector&& v1, basic_euclidean_vector const& v2)
+		   -> basic_euclidean_vector {
+			v1 -= v2;
+			return std::move(v1);
+		}
+
+		friend auto operator-(basic_euclidean_vector const& v1, basic_euclidean_vector&& v2)
+		   -> basic_euclidean_vector {
+			throw_if_dimension_not_equal(v1, v2);
+			auto* const magnitude = v2.storage();
+			std::transform(v1.data(), v1.data() + v1.dimension_, magnitude, magnitude, std::minus<>());
+			v2.invalidate_norm();
+			return std::move(v2);
+		}
+
+		friend auto operator-(basic_euclidean_vector&& v1, basic_euclidean_vector&& v2)
+		   -> basic_euclidean_vector {
+			v1 -= v2;
+			return std::move(v1);
+		}
+
+		friend auto operator*(basic_euclidean_vector&& vec, T factor) noexcept
+		   -> basic_euclidean_vector {
+			vec *= factor;
+			return std::move(vec);
+		}
+
+		friend auto operator/(basic_euclidean_vector&& vec, T factor) -> basic_euclidean_vector {
+			vec /= factor;
+			return std::move(vec);
+		}
+
+		friend auto operator<<(std::ostream& os, basic_euclidean_vector const& vec) noexcept
+		   -> std::ostream& { // Output Stream
+			auto& buffer = detail::text_buffer();
+			buffer.clear();
+			detail::append_text(buffer, vec.data(), vec.dimension_);
+			return detail::flush_text(os, buffer);
+		}
+
+		friend auto operator>>(std::istream& is, basic_euclidean_vector& vec)
+		   -> std::istream& { // Input Stream
+			return detail::read_text(is, vec);
+		}
 
 		/*
 		 * Helper Functions
 		 */
-		static auto is_dimension_equal(euclidean_vector const& v1, euclidean_vector const& v2) -> bool;
+		static auto is_dimension_equal(basic_euclidean_vector const& v1,
+		                               basic_euclidean_vector const& v2) -> bool;
 
-		static auto
-		throw_if_dimension_not_equal(euclidean_vector const& v1, euclidean_vector const& v2) -> void;
+		static auto throw_if_dimension_not_equal(basic_euclidean_vector const& v1,
+		                                         basic_euclidean_vector const& v2) -> void;
+		static auto throw_if_dimension_not_equal(std::size_t, std::size_t) -> void;
 		auto static throw_if_factor_is_zero(double) -> void;
 		auto static throw_if_index_out_of_range(int, int) -> void;
 
-		friend auto euclidean_norm(euclidean_vector const& v) noexcept -> double;
+		template<vector_scalar U>
+		friend auto euclidean_norm(basic_euclidean_vector<U> const& v) noexcept -> double;
 		static auto throw_if_dimension_is_zero(int) -> void;
 		static auto throw_if_norm_is_zero(double) -> void;
+		static auto throw_if_cosine_is_undefined(double, double) -> void;
 
-		friend auto dot(euclidean_vector const& v1, euclidean_vector const& v2) -> double;
+		template<vector_scalar U>
+		friend auto dot(basic_euclidean_vector<U> const& v1, basic_euclidean_vector<U> const& v2)
+		   -> double;
+
+		template<vector_scalar U>
+		friend auto cosine_similarity(basic_euclidean_vector<U> const& v1,
+		                              basic_euclidean_vector<U> const& v2) -> double;
+
+		friend auto lazy(basic_euclidean_vector<double> const&) noexcept -> vector_reference;
+
+		template<std::size_t N>
+		friend class fixed_euclidean_vector;
 
 	private:
-		// ass2 spec requires we use std::unique_ptr<double[]>
+		// State for the incremental norm mode, allocated only while the mode is on so that other
+		// vectors pay one pointer for it. store_norm() refreshes it from const calls, so its fields
+		// are atomics like e_norm_.
+		struct norm_tracker {
+			detail::relaxed_atomic<double> sum_of_squares = -1; // -1 when it must be recomputed
+			detail::relaxed_atomic<double> drift = 0; // rounding error bound since it was exact
+		};
+
+		// ass2 spec requires we use std::unique_ptr<double[]>, which euclidean_vector still does
 		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-		std::unique_ptr<double[]> magnitude_;
+		std::unique_ptr<T[]> magnitude_; // only owns storage above inline_dimensions
 		std::size_t dimension_;
-		mutable double e_norm_;
+		mutable detail::relaxed_atomic<double> e_norm_;
+		std::unique_ptr<norm_tracker> tracker_; // null unless the incremental norm mode is on
+		// left uninitialised; constructors write the first dimension_ elements
+		std::array<T, inline_dimensions> inline_magnitude_;
+
+		// Copies [first, last) with a single write per element
+		basic_euclidean_vector(T const* first, T const* last) noexcept;
+
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		static auto make_storage(std::size_t dimension) -> std::unique_ptr<T[]>;
+		static auto copy_tracker(basic_euclidean_vector const& org) -> std::unique_ptr<norm_tracker>;
+		[[nodiscard]] auto is_inline() const noexcept -> bool;
+		// The magnitudes, for members that keep e_norm_ up to date themselves
+		[[nodiscard]] auto storage() noexcept -> T*;
+		auto write(T* element, T value) noexcept -> void;
+
+		// The norm if it is known without a pass over the elements, otherwise -1
+		[[nodiscard]] auto known_norm() const noexcept -> double;
+		// Caches the norm from an exact sum of squares, and returns it
+		auto store_norm(double sum_of_squares) const noexcept -> double;
+
+		// Drops every cached quantity after a change to more than one element
+		auto invalidate_norm() noexcept -> void {
+			e_norm_ = -1;
+			if (tracker_) {
+				tracker_->sum_of_squares = -1;
+			}
+		}
 	};
 
+	// What the non-const subscript and at() return. It converts to T for reads and writes through
+	// on assignment, so only real writes cost the vector its cached norm. Like any proxy, it refers
+	// to the vector: `auto x = v[0]` is a reference, not a copy, so use T to keep the value. It
+	// can't bind to a T&, and swapping two of them needs the swap() below, found by ADL or through
+	// std::ranges::swap, rather than std::swap.
+	template<vector_scalar T>
+	class basic_euclidean_vector<T>::reference {
+	public:
+		reference(reference const&) noexcept = default;
+
+		operator T() const noexcept { // NOLINT(google-explicit-constructor)
+			return *element_;
+		}
+
+		auto operator=(T value) noexcept -> reference& {
+			vec_->write(element_, value);
+			return *this;
+		}
+
+		// Copies the referenced value, like assigning one T& to another
+		auto operator=(reference const& other) noexcept -> reference& {
+			return *this = static_cast<T>(other);
+		}
+
+		auto operator+=(T value) noexcept -> reference& {
+			return *this = *element_ + value;
+		}
+
+		auto operator-=(T value) noexcept -> reference& {
+			return *this = *element_ - value;
+		}
+
+		auto operator*=(T value) noexcept -> reference& {
+			return *this = *element_ * value;
+		}
+
+		auto operator/=(T value) noexcept -> reference& {
+			return *this = *element_ / value;
+		}
+
+		// Swaps the referenced values, not the references
+		friend auto swap(reference a, reference b) noexcept -> void {
+			auto const value = static_cast<T>(a);
+			a = static_cast<T>(b);
+			b = value;
+		}
+
+	private:
+		friend class basic_euclidean_vector;
+
+		reference(basic_euclidean_vector* vec, T* element) noexcept
+		: vec_{vec}
+		, element_{element} {}
+
+		basic_euclidean_vector* vec_;
+		T* element_;
+	};
+
+	using euclidean_vector = basic_euclidean_vector<double>;
+	using float_euclidean_vector = basic_euclidean_vector<float>;
+
+	// Both instantiations are compiled once, in euclidean_vector.cpp.
+	extern template class basic_euclidean_vector<float>;
+	extern template class basic_euclidean_vector<double>;
+
 	/*
 	 * Utility Functions
 	 */
-	auto euclidean_norm(euclidean_vector const& v) noexcept -> double; // Euclidean Norm
-	auto unit(euclidean_vector const& v) -> euclidean_vector; // Unit Vector
-	auto dot(euclidean_vector const& v1,
-	         euclidean_vector const& v2) -> double; // Dot Product
+	template<vector_scalar T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) noexcept -> double; // Euclidean Norm
+	template<vector_scalar T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T>; // Unit Vector
+	template<vector_scalar T>
+	auto unit(basic_euclidean_vector<T>&& v)
+	   -> basic_euclidean_vector<T>; // Unit Vector, reusing v's storage
+	template<vector_scalar T>
+	auto dot(basic_euclidean_vector<T> const& v1,
+	         basic_euclidean_vector<T> const& v2) -> double; // Dot Product
+	// Calls normalize() on every vector, spreading them across the hardware threads. Every
+	// dimension is checked first, so a vector with no dimensions throws before anything changes.
+	// A vector with zero norm is left as it is and throws once the others are normalised.
+	// Deduction can't see through a std::vector, so the two element types are also spelled out.
+	template<vector_scalar T>
+	auto normalize(std::span<basic_euclidean_vector<T>> vectors) -> void;
+	auto normalize(std::span<euclidean_vector> vectors) -> void;
+	auto normalize(std::span<float_euclidean_vector> vectors) -> void;
+	template<vector_scalar T>
+	auto squared_distance(basic_euclidean_vector<T> const& v1,
+	                      basic_euclidean_vector<T> const& v2) -> double; // euclidean_norm(v1 - v2)^2
+	template<vector_scalar T>
+	auto distance(basic_euclidean_vector<T> const& v1,
+	              basic_euclidean_vector<T> const& v2) -> double; // euclidean_norm(v1 - v2)
+	// dot(v1, v2) / (euclidean_norm(v1) * euclidean_norm(v2)), clamped to [-1, 1]. Cached norms are
+	// reused; otherwise the norms come from the same pass as the dot product, and are cached.
+	template<vector_scalar T>
+	auto cosine_similarity(basic_euclidean_vector<T> const& v1,
+	                       basic_euclidean_vector<T> const& v2) -> double;
+	template<vector_scalar T>
+	auto cosine_distance(basic_euclidean_vector<T> const& v1,
+	                     basic_euclidean_vector<T> const& v2) -> double; // 1 - cosine_similarity
+
+	// Anything whose magnitudes sit contiguously: basic_euclidean_vector and the batch row views
+	template<typename V>
+	concept writable_vector = requires(V const& v) {
+		requires vector_scalar<std::remove_cvref_t<decltype(*v.data())>>;
+		{ v.dimensions() } -> std::convertible_to<int>;
+	};
+
+	// Writes each vector as operator<< would, one per line. The text of many vectors is gathered
+	// and handed to the stream about 64 KiB at a time.
+	template<std::ranges::input_range R>
+	requires writable_vector<std::ranges::range_reference_t<R>>
+	auto write_vectors(std::ostream& os, R&& vectors) -> std::ostream& {
+		constexpr auto flush_size = std::size_t{1} << 16;
+		auto& buffer = detail::text_buffer();
+		buffer.clear();
+		for (auto const& v : vectors) {
+			detail::append_text(buffer, v.data(), static_cast<std::size_t>(v.dimensions()));
+			buffer.push_back('\n');
+			if (buffer.size() >= flush_size and not detail::flush_text(os, buffer)) {
+				return os;
+			}
+		}
+		return detail::flush_text(os, buffer);
+	}
+
+	// Parses every "[a b c]" in `text`, separated by any whitespace, with std::from_chars. Text
+	// over a few MiB is split at '[' boundaries and parsed on several threads. Malformed text
+	// throws, naming the byte offset of the first problem.
+	template<vector_scalar T = double>
+	auto parse_vectors(std::string_view text) -> std::vector<basic_euclidean_vector<T>>;
+
+	/*
+	 * Expression Templates
+	 *
+	 * lazy(v) starts an expression that records +, -, * and / instead of evaluating them. The whole
+	 * expression is computed in one loop, without temporaries, when it is assigned to or used to
+	 * construct a euclidean_vector, or passed to euclidean_norm() or dot(). Construction is
+	 * explicit, so an expression never turns into a new vector behind a `euclidean_vector const&`
+	 * parameter:
+	 *
+	 *     x = comp6771::lazy(a) + comp6771::lazy(b) * 2.0 - c;
+	 *
+	 * Plain euclidean_vectors can be mixed in once one operand is lazy; `b * 2.0` on its own is
+	 * still evaluated eagerly.
+	 * Dimensions and division by zero are checked when the expression is built, with the same
+	 * errors as the eager operators. Expressions refer to their vectors rather than copying them,
+	 * so they must be consumed before any of those vectors is destroyed; don't store one in `auto`.
+	 */
+	class vector_reference : public vector_expression_base {
+	public:
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return static_cast<int>(dimension_);
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double {
+			return magnitude_[index];
+		}
+
+		[[nodiscard]] auto data() const noexcept -> double const* {
+			return magnitude_;
+		}
+
+	private:
+		friend auto lazy(euclidean_vector const&) noexcept -> vector_reference;
+
+		vector_reference(double const* magnitude, std::size_t dimension) noexcept
+		: magnitude_{magnitude}
+		, dimension_{dimension} {}
+
+		double const* magnitude_;
+		std::size_t dimension_;
+	};
+
+	template<vector_expression L, vector_expression R, typename Op>
+	class binary_expression : public vector_expression_base {
+	public:
+		binary_expression(L const& lhs, R const& rhs)
+		: lhs_{lhs}
+		, rhs_{rhs} {
+			euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(lhs.dimensions()),
+			                                               static_cast<std::size_t>(rhs.dimensions()));
+		}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return lhs_.dimensions();
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double {
+			return Op()(lhs_[index], rhs_[index]);
+		}
+
+	private:
+		L lhs_;
+		R rhs_;
+	};
+
+	template<vector_expression E, typename Op>
+	class scalar_expression : public vector_expression_base {
+	public:
+		scalar_expression(E const& expr, double factor) noexcept
+		: expr_{expr}
+		, factor_{factor} {}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return expr_.dimensions();
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double {
+			return Op()(expr_[index], factor_);
+		}
+
+	private:
+		E expr_;
+		double factor_;
+	};
+
+	inline auto lazy(euclidean_vector const& v) noexcept -> vector_reference {
+		return vector_reference(v.data(), v.dimension_);
+	}
+
+	// A temporary would be destroyed before the expression is evaluated.
+	auto lazy(euclidean_vector&&) -> vector_reference = delete;
+
+	namespace detail {
+		inline auto as_expression(euclidean_vector const& v) noexcept -> vector_reference {
+			return lazy(v);
+		}
+
+		template<vector_expression E>
+		auto as_expression(E const& expr) noexcept -> E const& {
+			return expr;
+		}
+
+		template<typename T>
+		using expression_t = std::remove_cvref_t<decltype(as_expression(std::declval<T const&>()))>;
+	} // namespace detail
+
+	// Either a lazy expression or a euclidean_vector that can be mixed into one.
+	template<typename T>
+	concept vector_operand = vector_expression<T> or std::same_as<T, euclidean_vector>;
+
+	template<vector_operand L, vector_operand R>
+	requires vector_expression<L> or vector_expression<R>
+	auto operator+(L const& lhs, R const& rhs) {
+		return binary_expression<detail::expression_t<L>, detail::expression_t<R>, std::plus<>>(
+		   detail::as_expression(lhs),
+		   detail::as_expression(rhs));
+	}
+
+	template<vector_operand L, vector_operand R>
+	requires vector_expression<L> or vector_expression<R>
+	auto operator-(L const& lhs, R const& rhs) {
+		return binary_expression<detail::expression_t<L>, detail::expression_t<R>, std::minus<>>(
+		   detail::as_expression(lhs),
+		   detail::as_expression(rhs));
+	}
+
+	template<vector_expression E>
+	auto operator-(E const& expr) noexcept {
+		return scalar_expression<E, std::multiplies<>>(expr, -1.0);
+	}
+
+	template<vector_expression E>
+	auto operator*(E const& expr, double factor) noexcept {
+		return scalar_expression<E, std::multiplies<>>(expr, factor);
+	}
+
+	template<vector_expression E>
+	auto operator/(E const& expr, double factor) {
+		euclidean_vector::throw_if_factor_is_zero(factor);
+		return scalar_expression<E, std::divides<>>(expr, factor);
+	}
+
+	// Compares element by element without materialising either side
+	template<vector_operand L, vector_operand R>
+	requires vector_expression<L> or vector_expression<R>
+	auto operator==(L const& lhs, R const& rhs) noexcept -> bool {
+		auto const& v1 = detail::as_expression(lhs);
+		auto const& v2 = detail::as_expression(rhs);
+		if (v1.dimensions() != v2.dimensions()) {
+			return false;
+		}
+
+		auto const dimension = static_cast<std::size_t>(v1.dimensions());
+		for (auto i = std::size_t{0}; i < dimension; ++i) {
+			if (v1[i] != v2[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<vector_operand L, vector_operand R>
+	requires vector_expression<L> or vector_expression<R>
+	auto operator!=(L const& lhs, R const& rhs) noexcept -> bool {
+		return not(lhs == rhs);
+	}
+
+	template<vector_expression E>
+	auto euclidean_norm(E const& expr) noexcept -> double {
+		auto const dimension = static_cast<std::size_t>(expr.dimensions());
+		if constexpr (contiguous_vector_expression<E>) {
+			return std::sqrt(kernels::active().sum_of_squares(expr.data(), dimension));
+		}
+		else if constexpr (contiguous_float_expression<E>) {
+			return std::sqrt(kernels::active<float>().sum_of_squares(expr.data(), dimension));
+		}
+
+		auto sum = 0.0;
+		for (auto i = std::size_t{0}; i < dimension; ++i) {
+			auto const x = expr[i];
+			sum += x * x;
+		}
+		return std::sqrt(sum);
+	}
+
+	template<vector_operand A, vector_operand B>
+	requires vector_expression<A> or vector_expression<B>
+	auto dot(A const& a, B const& b) -> double {
+		auto const& lhs = detail::as_expression(a);
+		auto const& rhs = detail::as_expression(b);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(lhs.dimensions()),
+		                                               static_cast<std::size_t>(rhs.dimensions()));
+		auto const dimension = static_cast<std::size_t>(lhs.dimensions());
+		using lhs_type = std::remove_cvref_t<decltype(lhs)>;
+		using rhs_type = std::remove_cvref_t<decltype(rhs)>;
+		if constexpr (contiguous_vector_expression<lhs_type> and contiguous_vector_expression<rhs_type>) {
+			return kernels::active().dot(lhs.data(), rhs.data(), dimension);
+		}
+		else if constexpr (contiguous_float_expression<lhs_type>
+		                   and contiguous_float_expression<rhs_type>)
+		{
+			return kernels::active<float>().dot(lhs.data(), rhs.data(), dimension);
+		}
+
+		auto sum = 0.0;
+		for (auto i = std::size_t{0}; i < dimension; ++i) {
+			sum += lhs[i] * rhs[i];
+		}
+		return sum;
+	}
+
+	template<vector_operand A, vector_operand B>
+	requires vector_expression<A> or vector_expression<B>
+	auto squared_distance(A const& a, B const& b) -> double {
+		auto const& lhs = detail::as_expression(a);
+		auto const& rhs = detail::as_expression(b);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(lhs.dimensions()),
+		                                               static_cast<std::size_t>(rhs.dimensions()));
+		auto const dimension = static_cast<std::size_t>(lhs.dimensions());
+		using lhs_type = std::remove_cvref_t<decltype(lhs)>;
+		using rhs_type = std::remove_cvref_t<decltype(rhs)>;
+		if constexpr (contiguous_vector_expression<lhs_type> and contiguous_vector_expression<rhs_type>) {
+			return kernels::active().squared_distance(lhs.data(), rhs.data(), dimension);
+		}
+		else if constexpr (contiguous_float_expression<lhs_type>
+		                   and contiguous_float_expression<rhs_type>)
+		{
+			return kernels::active<float>().squared_distance(lhs.data(), rhs.data(), dimension);
+		}
+
+		auto sum = 0.0;
+		for (auto i = std::size_t{0}; i < dimension; ++i) {
+			auto const difference = lhs[i] - rhs[i];
+			sum += difference * difference;
+		}
+		return sum;
+	}
+
+	template<vector_operand A, vector_operand B>
+	requires vector_expression<A> or vector_expression<B>
+	auto distance(A const& a, B const& b) -> double {
+		return std::sqrt(squared_distance(a, b));
+	}
+
+	template<vector_operand A, vector_operand B>
+	requires vector_expression<A> or vector_expression<B>
+	auto cosine_similarity(A const& a, B const& b) -> double {
+		auto const& lhs = detail::as_expression(a);
+		auto const& rhs = detail::as_expression(b);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(lhs.dimensions()),
+		                                               static_cast<std::size_t>(rhs.dimensions()));
+		auto const dimension = static_cast<std::size_t>(lhs.dimensions());
+		using lhs_type = std::remove_cvref_t<decltype(lhs)>;
+		using rhs_type = std::remove_cvref_t<decltype(rhs)>;
+		auto sums = kernels::fused_sums{};
+		if constexpr (contiguous_vector_expression<lhs_type> and contiguous_vector_expression<rhs_type>) {
+			sums = kernels::active().dot_and_squares(lhs.data(), rhs.data(), dimension);
+		}
+		else if constexpr (contiguous_float_expression<lhs_type>
+		                   and contiguous_float_expression<rhs_type>)
+		{
+			sums = kernels::active<float>().dot_and_squares(lhs.data(), rhs.data(), dimension);
+		}
+		else {
+			for (auto i = std::size_t{0}; i < dimension; ++i) {
+				auto const x = lhs[i];
+				auto const y = rhs[i];
+				sums.dot += x * y;
+				sums.a_squares += x * x;
+				sums.b_squares += y * y;
+			}
+		}
+
+		auto const norm1 = std::sqrt(sums.a_squares);
+		auto const norm2 = std::sqrt(sums.b_squares);
+		euclidean_vector::throw_if_cosine_is_undefined(norm1, norm2);
+		return std::clamp(sums.dot / norm1 / norm2, -1.0, 1.0);
+	}
+
+	template<vector_operand A, vector_operand B>
+	requires vector_expression<A> or vector_expression<B>
+	auto cosine_distance(A const& a, B const& b) -> double {
+		return 1.0 - cosine_similarity(a, b);
+	}
+
+	// Evaluates the expression once, then normalises the result in place
+	template<vector_expression E>
+	auto unit(E const& expr) -> euclidean_vector {
+		return unit(euclidean_vector(expr));
+	}
+
+	template<vector_scalar T>
+	template<vector_expression E>
+	basic_euclidean_vector<T>::basic_euclidean_vector(E const& expr) noexcept
+	: magnitude_{make_storage(static_cast<std::size_t>(expr.dimensions()))}
+	, dimension_{static_cast<std::size_t>(expr.dimensions())}
+	, e_norm_{-1} {
+		auto* const magnitude = storage();
+		for (auto i = std::size_t{0}; i < dimension_; ++i) {
+			magnitude[i] = static_cast<T>(expr[i]);
+		}
+	}
+
+	template<vector_scalar T>
+	template<vector_expression E>
+	auto basic_euclidean_vector<T>::operator=(E const& expr) noexcept -> basic_euclidean_vector& {
+		// Every element only depends on the same index of its operands, so writing in place is safe
+		// even when *this appears in the expression.
+		if (static_cast<std::size_t>(expr.dimensions()) != dimension_) {
+			return *this = basic_euclidean_vector(expr);
+		}
+		auto* const magnitude = storage();
+		for (auto i = std::size_t{0}; i < dimension_; ++i) {
+			magnitude[i] = static_cast<T>(expr[i]);
+		}
+		invalidate_norm();
+		return *this;
+	}
+
+	template<vector_scalar T>
+	template<vector_expression E>
+	auto basic_euclidean_vector<T>::operator+=(E const& expr) -> basic_euclidean_vector& {
+		throw_if_dimension_not_equal(dimension_, static_cast<std::size_t>(expr.dimensions()));
+		auto* const magnitude = storage();
+		if constexpr (contiguous_vector_expression<E> and std::same_as<T, double>) {
+			kernels::active().add(magnitude, expr.data(), dimension_);
+		}
+		else {
+			for (auto i = std::size_t{0}; i < dimension_; ++i) {
+				magnitude[i] += static_cast<T>(expr[i]);
+			}
+		}
+		invalidate_norm();
+		return *this;
+	}
+
+	template<vector_scalar T>
+	template<vector_expression E>
+	auto basic_euclidean_vector<T>::operator-=(E const& expr) -> basic_euclidean_vector& {
+		throw_if_dimension_not_equal(dimension_, static_cast<std::size_t>(expr.dimensions()));
+		auto* const magnitude = storage();
+		if constexpr (contiguous_vector_expression<E> and std::same_as<T, double>) {
+			kernels::active().subtract(magnitude, expr.data(), dimension_);
+		}
+		else {
+			for (auto i = std::size_t{0}; i < dimension_; ++i) {
+				magnitude[i] -= static_cast<T>(expr[i]);
+			}
+		}
+		invalidate_norm();
+		return *this;
+	}
+
+	/*
+	 * Fixed-Dimension Vectors
+	 *
+	 * fixed_euclidean_vector<N> mirrors euclidean_vector for a dimension known at compile time. The
+	 * magnitudes live inside the object, every operation is constexpr, and mixing dimensions is a
+	 * compile error rather than a euclidean_vector_error. There is no norm cache: the norm is a
+	 * handful of multiply-adds that the compiler can hoist when the vector doesn't change.
+	 */
+	namespace detail {
+		// Loops over up to this many elements are expanded at compile time; longer ones are left to
+		// the optimiser so compile times and code size stay reasonable.
+		inline constexpr auto max_unrolled_dimensions = std::size_t{64};
+
+		template<std::size_t N, typename F>
+		constexpr auto unrolled_for(F&& f) -> void {
+			if constexpr (N <= max_unrolled_dimensions) {
+				[&]<std::size_t... I>(std::index_sequence<I...>) {
+					(f(I), ...);
+				}(std::make_index_sequence<N>());
+			}
+			else {
+				for (auto i = std::size_t{0}; i < N; ++i) {
+					f(i);
+				}
+			}
+		}
+
+		// std::sqrt is not usable in constant expressions until C++26.
+		constexpr auto sqrt(double x) noexcept -> double {
+			if (not std::is_constant_evaluated()) {
+				return std::sqrt(x);
+			}
+			if (x < 0 or x != x) {
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			if (x == 0 or x == std::numeric_limits<double>::infinity()) {
+				return x;
+			}
+
+			// Newton's method approaches the root from above, so stop once it stops decreasing.
+			auto current = x > 1 ? x : 1.0;
+			while (true) {
+				auto const next = 0.5 * (current + x / current);
+				if (next >= current) {
+					return current;
+				}
+				current = next;
+			}
+		}
+	} // namespace detail
+
+	template<std::size_t N>
+	class fixed_euclidean_vector {
+	public:
+		/*
+		 * Constructors
+		 */
+		constexpr fixed_euclidean_vector() noexcept = default;
+
+		constexpr explicit fixed_euclidean_vector(double value) noexcept requires(N != 1) {
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] = value; });
+		}
+
+		template<std::convertible_to<double>... Ts>
+		requires(sizeof...(Ts) == N)
+		constexpr fixed_euclidean_vector(Ts... values) noexcept // NOLINT(google-explicit-constructor)
+		: magnitude_{static_cast<double>(values)...} {}
+
+		// Throws if the dimensions differ
+		explicit fixed_euclidean_vector(euclidean_vector const& v) {
+			euclidean_vector::throw_if_dimension_not_equal(N, static_cast<std::size_t>(v.dimensions()));
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] = v[static_cast<int>(i)]; });
+		}
+
+		/*
+		 * Operator Overloads
+		 */
+		// Subscript
+		constexpr auto operator[](int index) noexcept -> double& {
+			assert(index >= 0 and index < dimensions());
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto operator[](int index) const noexcept -> double const& {
+			assert(index >= 0 and index < dimensions());
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto operator+() const noexcept -> fixed_euclidean_vector { // Unary Plus
+			return *this;
+		}
+
+		constexpr auto operator-() const noexcept -> fixed_euclidean_vector { // Negation
+			auto negated = fixed_euclidean_vector();
+			detail::unrolled_for<N>([&](std::size_t i) { negated.magnitude_[i] = -magnitude_[i]; });
+			return negated;
+		}
+
+		// Compound Addition
+		constexpr auto operator+=(fixed_euclidean_vector const& v2) noexcept -> fixed_euclidean_vector& {
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] += v2.magnitude_[i]; });
+			return *this;
+		}
+
+		// Compound Subtraction
+		constexpr auto operator-=(fixed_euclidean_vector const& v2) noexcept -> fixed_euclidean_vector& {
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] -= v2.magnitude_[i]; });
+			return *this;
+		}
+
+		// Compound Multiplication
+		constexpr auto operator*=(double v2) noexcept -> fixed_euclidean_vector& {
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] *= v2; });
+			return *this;
+		}
+
+		// Compound Division
+		constexpr auto operator/=(double v2) -> fixed_euclidean_vector& {
+			// the helpers aren't constexpr, so only call them on the error path
+			if (v2 == 0) {
+				euclidean_vector::throw_if_factor_is_zero(v2);
+			}
+			detail::unrolled_for<N>([&](std::size_t i) { magnitude_[i] /= v2; });
+			return *this;
+		}
+
+		// Dynamic Type Conversion
+		explicit operator euclidean_vector() const noexcept {
+			return euclidean_vector(magnitude_.data(), magnitude_.data() + N);
+		}
+
+		explicit operator std::vector<double>() const noexcept { // Vector Type Conversion
+			return std::vector<double>(magnitude_.begin(), magnitude_.end());
+		}
+
+		explicit operator std::list<double>() const noexcept { // List Type Conversion
+			return std::list<double>(magnitude_.begin(), magnitude_.end());
+		}
+
+		/*
+		 * Member Functions
+		 */
+		// Returns the value of the magnitude
+		[[nodiscard]] constexpr auto at(int index) const -> double {
+			if (index < 0 or index >= dimensions()) {
+				euclidean_vector::throw_if_index_out_of_range(index, dimensions());
+			}
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		// Returns the reference of the magnitude
+		[[nodiscard]] constexpr auto at(int index) -> double& {
+			if (index < 0 or index >= dimensions()) {
+				euclidean_vector::throw_if_index_out_of_range(index, dimensions());
+			}
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		// Return the number of dimensions
+		[[nodiscard]] static constexpr auto dimensions() noexcept -> int {
+			return static_cast<int>(N);
+		}
+
+		/*
+		 * Friend Functions
+		 */
+		friend constexpr auto operator==(fixed_euclidean_vector const& v1,
+		                                 fixed_euclidean_vector const& v2) noexcept -> bool = default;
+
+		friend constexpr auto operator+(fixed_euclidean_vector v1,
+		                                fixed_euclidean_vector const& v2) noexcept
+		   -> fixed_euclidean_vector {
+			return v1 += v2;
+		}
+
+		friend constexpr auto operator-(fixed_euclidean_vector v1,
+		                                fixed_euclidean_vector const& v2) noexcept
+		   -> fixed_euclidean_vector {
+			return v1 -= v2;
+		}
+
+		friend constexpr auto operator*(fixed_euclidean_vector vec, double factor) noexcept
+		   -> fixed_euclidean_vector {
+			return vec *= factor;
+		}
+
+		friend constexpr auto operator/(fixed_euclidean_vector vec, double factor)
+		   -> fixed_euclidean_vector {
+			return vec /= factor;
+		}
+
+		friend auto operator<<(std::ostream& os, fixed_euclidean_vector const& vec) -> std::ostream& {
+			auto& buffer = detail::text_buffer();
+			buffer.clear();
+			detail::append_text(buffer, vec.magnitude_.data(), N);
+			return detail::flush_text(os, buffer);
+		}
+
+	private:
+		std::array<double, N> magnitude_{};
+	};
+
+	template<std::size_t N>
+	constexpr auto dot(fixed_euclidean_vector<N> const& v1,
+	                   fixed_euclidean_vector<N> const& v2) noexcept -> double {
+		auto sum = 0.0;
+		detail::unrolled_for<N>([&](std::size_t i) {
+			auto const index = static_cast<int>(i);
+			sum += v1[index] * v2[index];
+		});
+		return sum;
+	}
+
+	template<std::size_t N>
+	constexpr auto euclidean_norm(fixed_euclidean_vector<N> const& v) noexcept -> double {
+		return detail::sqrt(dot(v, v));
+	}
+
+	template<std::size_t N>
+	constexpr auto squared_distance(fixed_euclidean_vector<N> const& v1,
+	                                fixed_euclidean_vector<N> const& v2) noexcept -> double {
+		auto sum = 0.0;
+		detail::unrolled_for<N>([&](std::size_t i) {
+			auto const index = static_cast<int>(i);
+			auto const difference = v1[index] - v2[index];
+			sum += difference * difference;
+		});
+		return sum;
+	}
+
+	template<std::size_t N>
+	constexpr auto distance(fixed_euclidean_vector<N> const& v1,
+	                        fixed_euclidean_vector<N> const& v2) noexcept -> double {
+		return detail::sqrt(squared_distance(v1, v2));
+	}
+
+	template<std::size_t N>
+	constexpr auto cosine_similarity(fixed_euclidean_vector<N> const& v1,
+	                                 fixed_euclidean_vector<N> const& v2) -> double {
+		auto const norm1 = euclidean_norm(v1);
+		auto const norm2 = euclidean_norm(v2);
+		if (norm1 == 0 or norm2 == 0) {
+			euclidean_vector::throw_if_cosine_is_undefined(norm1, norm2);
+		}
+		return std::clamp(dot(v1, v2) / norm1 / norm2, -1.0, 1.0);
+	}
+
+	template<std::size_t N>
+	constexpr auto cosine_distance(fixed_euclidean_vector<N> const& v1,
+	                               fixed_euclidean_vector<N> const& v2) -> double {
+		return 1.0 - cosine_similarity(v1, v2);
+	}
+
+	template<std::size_t N>
+	requires(N > 0)
+	constexpr auto unit(fixed_euclidean_vector<N> const& v) -> fixed_euclidean_vector<N> {
+		auto const e_norm = euclidean_norm(v);
+		if (e_norm == 0) {
+			euclidean_vector::throw_if_norm_is_zero(e_norm);
+		}
+		return v / e_norm;
+	}
+
+	template<std::convertible_to<double>... Ts>
+	fixed_euclidean_vector(Ts...) -> fixed_euclidean_vector<sizeof...(Ts)>;
 
 } // namespace comp6771
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
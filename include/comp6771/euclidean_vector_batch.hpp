@@ -0,0 +1,94 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	// A rows x dimensions matrix of magnitudes held in one allocation. Each row is padded to a whole
+	// number of cache lines, so every row starts on a 64-byte boundary and the padding is always
+	// zero. Rows are accessed through euclidean_vector_view and mutable_euclidean_vector_view.
+	class euclidean_vector_batch {
+	public:
+		static constexpr std::size_t alignment = 64;
+
+		/*
+		 * Constructors
+		 */
+		euclidean_vector_batch(int rows, int dimension);
+		explicit euclidean_vector_batch(std::span<euclidean_vector const>); // Throws on mixed dimensions
+
+		euclidean_vector_batch(euclidean_vector_batch const&);
+		euclidean_vector_batch(euclidean_vector_batch&&) noexcept;
+		~euclidean_vector_batch() noexcept = default;
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator=(euclidean_vector_batch const&) -> euclidean_vector_batch&;
+		auto operator=(euclidean_vector_batch&&) noexcept -> euclidean_vector_batch&;
+
+		// Row Subscript
+		auto operator[](int row) noexcept -> mutable_euclidean_vector_view;
+		auto operator[](int row) const noexcept -> euclidean_vector_view;
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto at(int row) -> mutable_euclidean_vector_view;
+		[[nodiscard]] auto at(int row) const -> euclidean_vector_view;
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		// Distance in doubles between the starts of consecutive rows
+		[[nodiscard]] auto stride() const noexcept -> std::size_t;
+
+		// Appends a row, growing the storage geometrically
+		auto push_back(euclidean_vector const&) -> void;
+		// Keeps the first rows and appends zero rows as needed. Shrinking keeps the storage, so a
+		// batch can be refilled without reallocating; growing past it allocates exactly `rows`.
+		auto resize(int rows) -> void;
+		// Makes room for `rows` rows in all, so growing to them later doesn't reallocate. Does
+		// nothing when the storage already fits them.
+		auto reserve(std::size_t rows) -> void;
+
+		/*
+		 * Bulk Operations
+		 */
+		auto add_to_rows(euclidean_vector const&) -> void; // Adds the vector to every row
+		auto subtract_from_rows(euclidean_vector const&) -> void; // Subtracts it from every row
+		auto scale_rows(double) noexcept -> void; // Multiplies every row by the factor
+		[[nodiscard]] auto norms() const -> std::vector<double>; // Euclidean norm of every row
+		auto norms(std::span<double>) const -> void; // Same, into caller-supplied storage
+		// Scales every row to unit length, spreading the rows across the hardware threads. Throws
+		// like unit(); a row with zero norm is left as it is and throws once the others are done.
+		auto normalize_rows() -> void;
+
+	private:
+		struct aligned_delete {
+			auto operator()(double*) const noexcept -> void;
+		};
+
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		using storage = std::unique_ptr<double[], aligned_delete>;
+
+		// Throws std::bad_array_new_length when rows * stride doubles cannot be sized
+		static auto allocate(std::size_t rows, std::size_t stride) -> storage;
+		auto throw_if_row_out_of_range(int row) const -> void;
+
+		storage magnitude_;
+		std::size_t rows_;
+		std::size_t dimension_;
+		std::size_t stride_;
+		std::size_t capacity_; // rows that fit in magnitude_
+	};
+
+	// Writes every row as operator<< would, one per line, like write_vectors() over a range
+	auto write_vectors(std::ostream& os, euclidean_vector_batch const& batch) -> std::ostream&;
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
@@ -0,0 +1,159 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace comp6771 {
+	// A read-only window of `dimension` magnitudes starting at `magnitude`. Views don't own their
+	// storage and are cheap to copy, so they give zero-copy access to buffers owned elsewhere:
+	// network frames, mapped files or another library's arrays. They are lazy expressions, so they
+	// work with dot(), euclidean_norm(), ==, != and the expression operators, and their results can
+	// be written into a euclidean_vector or a mutable_euclidean_vector_view. The viewed storage must
+	// outlive the view.
+	class euclidean_vector_view : public vector_expression_base {
+	public:
+		euclidean_vector_view(double const* magnitude, int dimension) noexcept
+		: magnitude_{magnitude}
+		, dimension_{static_cast<std::size_t>(dimension)} {}
+
+		explicit euclidean_vector_view(std::span<double const> magnitude) noexcept
+		: magnitude_{magnitude.data()}
+		, dimension_{magnitude.size()} {}
+
+		euclidean_vector_view(euclidean_vector const& v) noexcept // NOLINT(google-explicit-constructor)
+		: magnitude_{v.data()}
+		, dimension_{static_cast<std::size_t>(v.dimensions())} {}
+
+		// A temporary would be destroyed while the view still refers to it.
+		euclidean_vector_view(euclidean_vector&&) = delete;
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return static_cast<int>(dimension_);
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double {
+			assert(index < dimension_);
+			return magnitude_[index];
+		}
+
+		[[nodiscard]] auto data() const noexcept -> double const* {
+			return magnitude_;
+		}
+
+	private:
+		double const* magnitude_;
+		std::size_t dimension_;
+	};
+
+	// A writable window of `dimension` magnitudes. Assigning to it writes through to the underlying
+	// storage rather than rebinding the view.
+	class mutable_euclidean_vector_view : public vector_expression_base {
+	public:
+		mutable_euclidean_vector_view(double* magnitude, int dimension) noexcept
+		: magnitude_{magnitude}
+		, dimension_{static_cast<std::size_t>(dimension)} {}
+
+		explicit mutable_euclidean_vector_view(std::span<double> magnitude) noexcept
+		: magnitude_{magnitude.data()}
+		, dimension_{magnitude.size()} {}
+
+		mutable_euclidean_vector_view(mutable_euclidean_vector_view const&) noexcept = default;
+
+		// Copies the magnitudes of `other`
+		auto operator=(mutable_euclidean_vector_view const& other) const
+		   -> mutable_euclidean_vector_view const& {
+			return *this = euclidean_vector_view(other);
+		}
+
+		// Evaluates a lazy expression into the viewed storage
+		template<vector_operand E>
+		auto operator=(E const& expr) const -> mutable_euclidean_vector_view const& {
+			auto const& rhs = detail::as_expression(expr);
+			euclidean_vector::throw_if_dimension_not_equal(dimension_,
+			                                               static_cast<std::size_t>(rhs.dimensions()));
+			for (auto i = std::size_t{0}; i < dimension_; ++i) {
+				magnitude_[i] = rhs[i];
+			}
+			return *this;
+		}
+
+		operator euclidean_vector_view() const noexcept { // NOLINT(google-explicit-constructor)
+			return euclidean_vector_view(magnitude_, dimensions());
+		}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return static_cast<int>(dimension_);
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double& {
+			assert(index < dimension_);
+			return magnitude_[index];
+		}
+
+		[[nodiscard]] auto data() const noexcept -> double* {
+			return magnitude_;
+		}
+
+		template<vector_operand E>
+		auto operator+=(E const& expr) const -> mutable_euclidean_vector_view const& {
+			auto const& rhs = detail::as_expression(expr);
+			euclidean_vector::throw_if_dimension_not_equal(dimension_,
+			                                               static_cast<std::size_t>(rhs.dimensions()));
+			if constexpr (contiguous_vector_expression<std::remove_cvref_t<decltype(rhs)>>) {
+				kernels::active().add(magnitude_, rhs.data(), dimension_);
+			}
+			else {
+				for (auto i = std::size_t{0}; i < dimension_; ++i) {
+					magnitude_[i] += rhs[i];
+				}
+			}
+			return *this;
+		}
+
+		template<vector_operand E>
+		auto operator-=(E const& expr) const -> mutable_euclidean_vector_view const& {
+			auto const& rhs = detail::as_expression(expr);
+			euclidean_vector::throw_if_dimension_not_equal(dimension_,
+			                                               static_cast<std::size_t>(rhs.dimensions()));
+			if constexpr (contiguous_vector_expression<std::remove_cvref_t<decltype(rhs)>>) {
+				kernels::active().subtract(magnitude_, rhs.data(), dimension_);
+			}
+			else {
+				for (auto i = std::size_t{0}; i < dimension_; ++i) {
+					magnitude_[i] -= rhs[i];
+				}
+			}
+			return *this;
+		}
+
+		auto operator*=(double factor) const noexcept -> mutable_euclidean_vector_view const& {
+			kernels::active().scale(magnitude_, factor, dimension_);
+			return *this;
+		}
+
+		auto operator/=(double factor) const -> mutable_euclidean_vector_view const& {
+			euclidean_vector::throw_if_factor_is_zero(factor);
+			kernels::active().divide(magnitude_, factor, dimension_);
+			return *this;
+		}
+
+	private:
+		double* magnitude_;
+		std::size_t dimension_;
+	};
+
+	/*
+	 * Utility Functions
+	 */
+	// Writes the unit vector of `v` into `out`, which must have the same dimension. `out` may
+	// refer to the same storage as `v`.
+	auto unit(euclidean_vector_view v, mutable_euclidean_vector_view out) -> void;
+	auto unit(euclidean_vector_view v, euclidean_vector& out) -> void;
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
@@ -0,0 +1,141 @@
+#ifndef COMP6771_HNSW_INDEX_HPP
+#define COMP6771_HNSW_INDEX_HPP
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	// Tuning for hnsw_index. Larger values give better recall for more time and memory.
+	struct hnsw_parameters {
+		int m = 16; // links per node on the upper layers, twice this on layer 0
+		int ef_construction = 200; // candidates kept while linking a new node
+		int ef_search = 64; // candidates kept while searching; raised to k when smaller
+		unsigned seed = 100; // for the random layer assignment
+	};
+
+	// Approximate k-nearest-neighbour search over a Hierarchical Navigable Small World graph
+	// (Malkov and Yashunin, 2016). Every row is a node on layer 0, and each layer above holds an
+	// exponentially thinning sample of the one below. A search descends greedily through the upper
+	// layers and then runs a best-first search of width ef_search on layer 0, so it compares the
+	// query with a few thousand rows instead of all of them. Recall is traded against speed
+	// through m, ef_construction and ef_search; brute_force_index gives the exact answer.
+	//
+	// Distances come straight from the SIMD kernels on the stored rows: squared_distance for l2,
+	// dot for inner_product and dot times the stored inverse norms for cosine. No temporary vector
+	// is built per comparison.
+	//
+	// Layer-0 links live in one flat array with 2 * m + 1 ints per node (a count, then the ids),
+	// and each node's upper layers are one more array of m + 1 ints per layer, so following an
+	// edge costs one indexed load. search() is safe to call concurrently; add() is not safe to call
+	// concurrently with anything else.
+	class hnsw_index {
+	public:
+		using parameters = hnsw_parameters;
+
+		/*
+		 * Constructors
+		 */
+		explicit hnsw_index(int dimension, metric = metric::l2, parameters = {});
+		// Builds the graph over every row, linking them on all the hardware threads
+		explicit hnsw_index(euclidean_vector_batch database, metric = metric::l2, parameters = {});
+		explicit hnsw_index(std::span<euclidean_vector const>,
+		                    metric = metric::l2,
+		                    parameters = {});
+
+		hnsw_index(hnsw_index&&) noexcept;
+		~hnsw_index() noexcept;
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator=(hnsw_index&&) noexcept -> hnsw_index&;
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto distance_metric() const noexcept -> metric;
+		[[nodiscard]] auto tuning() const noexcept -> parameters const&;
+		[[nodiscard]] auto database() const noexcept -> euclidean_vector_batch const&;
+		// Number of layers above layer 0
+		[[nodiscard]] auto max_level() const noexcept -> int;
+		// The layer-`level` links of a node, for inspecting the graph
+		[[nodiscard]] auto neighbours(int id, int level) const -> std::span<int const>;
+
+		auto set_ef_search(int) -> void;
+
+		// Links a new row into the graph; its id is the previous size()
+		auto add(euclidean_vector const&) -> void;
+
+		// Approximately the min(k, size()) rows nearest to the query, best first
+		[[nodiscard]] auto search(euclidean_vector const& query, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto search(euclidean_vector_view query, int k) const
+		   -> std::vector<neighbour>;
+		// The same for every row of `queries`, spread across the hardware threads
+		[[nodiscard]] auto search(euclidean_vector_batch const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>>;
+
+		/*
+		 * Helper Functions
+		 */
+		static auto throw_if_parameters_are_invalid(parameters const&) -> void;
+
+	private:
+		class visited_pool;
+		using candidate = std::pair<double, int>; // key, id; smaller keys are nearer
+
+		auto query_norm(double const* magnitude) const -> double;
+		auto key(double const* query, double norm, int node) const noexcept -> double;
+		auto links(int node, int level) noexcept -> int*;
+		auto links(int node, int level) const noexcept -> int const*;
+		auto random_level() -> int;
+		auto reserve_node(int level) -> void;
+
+		auto insert(int node, std::mutex* node_locks) -> void;
+		auto greedy(double const* query,
+		            double norm,
+		            candidate entry,
+		            int level,
+		            std::mutex* node_locks) const -> candidate;
+		auto search_layer(double const* query,
+		                  double norm,
+		                  candidate entry,
+		                  std::size_t ef,
+		                  int level,
+		                  std::mutex* node_locks) const -> std::vector<candidate>;
+		auto select_neighbours(std::vector<candidate> const& nearest, std::size_t m) const
+		   -> std::vector<int>;
+		auto connect(int node, int neighbour, int level, std::mutex* node_locks) -> void;
+
+		euclidean_vector_batch database_;
+		std::vector<double> norms_; // 1 / |x| for cosine, unused otherwise
+		metric metric_;
+		parameters parameters_;
+		std::size_t max_m0_;
+		double level_multiplier_;
+		std::mt19937_64 engine_;
+
+		std::vector<int> levels_;
+		std::vector<int> links0_; // per node: count, then up to max_m0_ ids
+		std::vector<std::vector<int>> upper_links_; // per node and upper layer: count, then m ids
+		int entry_point_;
+		int max_level_;
+
+		std::unique_ptr<std::mutex> entry_mutex_; // guards the entry point during a parallel build
+		std::unique_ptr<visited_pool> visited_;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_HNSW_INDEX_HPP
@@ -0,0 +1,99 @@
+#ifndef COMP6771_IVF_INDEX_HPP
+#define COMP6771_IVF_INDEX_HPP
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	// Tuning for ivf_index. More lists make each probe cheaper; more probes raise recall.
+	struct ivf_parameters {
+		int lists = 256; // k-means centroids, each owning one inverted list
+		int nprobe = 8; // lists scanned per query
+		int samples_per_list = 256; // k-means trains on at most lists * samples_per_list rows
+		int iterations = 20; // Lloyd iterations; training stops early once no row moves
+		unsigned seed = 100; // for the training sample and the initial centroids
+	};
+
+	// Approximate k-nearest-neighbour search with an inverted file. k-means partitions the rows
+	// into `lists` cells; a query ranks the centroids and scans only the rows of the nprobe
+	// nearest cells. Unlike hnsw_index it stores no graph, only the centroids and one id per row,
+	// and nprobe trades recall against latency at query time.
+	//
+	// Each list keeps its rows in its own euclidean_vector_batch, so a probe is one sequential
+	// scan. Distances come straight from the SIMD kernels (squared_distance for l2, dot for
+	// inner_product and cosine) without building temporaries. Rows are assigned to the centroid
+	// nearest by l2, or by cosine similarity for the cosine metric, where k-means runs on the
+	// normalised rows. Training and assignment are spread across the hardware threads.
+	class ivf_index {
+	public:
+		using parameters = ivf_parameters;
+
+		/*
+		 * Constructors
+		 */
+		explicit ivf_index(euclidean_vector_batch const& database,
+		                   metric = metric::l2,
+		                   parameters = {});
+		explicit ivf_index(std::span<euclidean_vector const>, metric = metric::l2, parameters = {});
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto distance_metric() const noexcept -> metric;
+		[[nodiscard]] auto tuning() const noexcept -> parameters const&;
+		[[nodiscard]] auto centroids() const noexcept -> euclidean_vector_batch const&;
+		// The ids of the rows in one list
+		[[nodiscard]] auto list(int) const -> std::span<int const>;
+
+		auto set_nprobe(int) -> void;
+
+		// Adds a row to the list of its nearest centroid; its id is the previous size(). The
+		// centroids are not retrained.
+		auto add(euclidean_vector const&) -> void;
+
+		// Approximately the min(k, size()) rows nearest to the query, best first. Fewer come back
+		// when the probed lists hold fewer than k rows between them.
+		[[nodiscard]] auto search(euclidean_vector const& query, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto search(euclidean_vector_view query, int k) const
+		   -> std::vector<neighbour>;
+		// The same for every row of `queries`, spread across the hardware threads
+		[[nodiscard]] auto search(euclidean_vector_batch const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>>;
+
+		/*
+		 * Helper Functions
+		 */
+		static auto throw_if_parameters_are_invalid(parameters const&) -> void;
+		static auto throw_if_too_few_rows(int rows, int lists) -> void;
+
+	private:
+		struct inverted_list {
+			euclidean_vector_batch rows;
+			std::vector<int> ids;
+			std::vector<double> norms; // 1 / |x| for cosine, unused otherwise
+		};
+
+		auto row_norm(double const* magnitude) const -> double;
+		auto coarse_key(double const* magnitude, int list) const noexcept -> double;
+		auto nearest_list(double const* magnitude) const noexcept -> int;
+		auto assign(euclidean_vector_batch const& rows) const -> std::vector<int>;
+		auto train(euclidean_vector_batch const& database) -> void;
+
+		metric metric_;
+		parameters parameters_;
+		euclidean_vector_batch centroids_; // unit length for cosine
+		std::vector<inverted_list> lists_;
+		int size_;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_IVF_INDEX_HPP
@@ -0,0 +1,83 @@
+#ifndef COMP6771_KD_TREE_HPP
+#define COMP6771_KD_TREE_HPP
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/euclidean_vector.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	// A KD-tree over low-dimensional points (robot poses, 3-D points and the like), answering
+	// nearest-neighbour, radius and box queries by Euclidean distance. Beyond about 16 dimensions
+	// pruning stops paying off and brute_force_index or hnsw_index is the better choice.
+	//
+	// The tree lives in two flat arrays. The points are copied into one contiguous block in tree
+	// order, so a leaf is a short sequential scan. The nodes are stored in pre-order, so a node's
+	// lower child immediately follows it. Each node splits on the axis with the largest spread in
+	// a sample of its points, at the sample's median; a sample keeps the build O(n log n) without
+	// sorting, and falls back to the exact median when the sample would leave one side empty.
+	// Subtrees of large point sets are built on separate threads.
+	class kd_tree {
+	public:
+		static constexpr int default_leaf_size = 16;
+
+		/*
+		 * Constructors
+		 */
+		explicit kd_tree(std::span<euclidean_vector const> points,
+		                 int leaf_size = default_leaf_size);
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto leaf_size() const noexcept -> int;
+
+		// Replaces every point and rebuilds the tree; ids restart from 0
+		auto rebuild(std::span<euclidean_vector const> points) -> void;
+
+		// The min(k, size()) points nearest to the query, nearest first, with their distances
+		[[nodiscard]] auto search(euclidean_vector const& query, int k) const
+		   -> std::vector<neighbour>;
+		// Every point within `radius` of the query (inclusive), nearest first
+		[[nodiscard]] auto radius_search(euclidean_vector const& query, double radius) const
+		   -> std::vector<neighbour>;
+		// The ids of every point p with lower[i] <= p[i] <= upper[i] in every dimension, ascending
+		[[nodiscard]] auto box_search(euclidean_vector const& lower,
+		                              euclidean_vector const& upper) const -> std::vector<int>;
+
+		/*
+		 * Helper Functions
+		 */
+		static auto throw_if_leaf_size_is_invalid(int) -> void;
+		static auto throw_if_radius_is_negative(double) -> void;
+
+	private:
+		// Points [first, last) of the tree order. A leaf has axis -1; an inner node's lower child
+		// is the next node, its upper child is `upper`, and split separates them: lower points are
+		// <= split on `axis`, upper points are >= split.
+		struct node {
+			double split;
+			int axis;
+			int first;
+			int last;
+			int upper;
+		};
+
+		class builder;
+
+		[[nodiscard]] auto point(int position) const noexcept -> double const*;
+		auto squared_distance(double const* query, int position) const noexcept -> double;
+
+		std::vector<double> points_; // size() * dimension_, in tree order
+		std::vector<int> ids_; // the caller's index of each point, in tree order
+		std::vector<node> nodes_;
+		std::size_t dimension_;
+		int leaf_size_;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_KD_TREE_HPP
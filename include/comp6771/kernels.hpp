@@ -0,0 +1,69 @@
+#ifndef COMP6771_KERNELS_HPP
+#define COMP6771_KERNELS_HPP
+
+#include <cstddef>
+
+// Element-wise and reduction loops over contiguous floats or doubles, with one implementation per
+// instruction set. The best implementation the CPU supports is chosen the first time active() is
+// called and reused for the rest of the program.
+//
+// Element-wise kernels (add, subtract, scale, divide) give bit-identical results on every
+// instruction set. The reductions (dot, sum_of_squares, squared_distance and the three sums of
+// dot_and_squares) split the sum across several accumulators, so they round differently from the
+// sequential scalar loop. Both orders are bounded by (n - 1) * eps * sum(|a[i] * b[i]|) away from
+// the exact value, so the two agree to within twice that. For sums of squares every term is
+// non-negative, which makes it a relative bound of 2 * (n - 1) * eps on the result; in practice
+// the difference is a few ULP.
+//
+// Reductions always accumulate and return double. The product of two floats is exact in double,
+// so the float kernels meet the same bound with eps taken from double.
+namespace comp6771::kernels {
+	enum class isa { scalar, sse2, avx2, avx512 };
+
+	// The three sums behind cosine similarity, from one pass over a and b.
+	struct fused_sums {
+		double dot = 0; // sum(a[i] * b[i])
+		double a_squares = 0; // sum(a[i]^2)
+		double b_squares = 0; // sum(b[i]^2)
+	};
+
+	template<typename T>
+	using dot_kernel = auto(T const*, T const*, std::size_t) noexcept -> double;
+	template<typename T>
+	using dot_and_squares_kernel = auto(T const*, T const*, std::size_t) noexcept -> fused_sums;
+	template<typename T>
+	using sum_of_squares_kernel = auto(T const*, std::size_t) noexcept -> double;
+	template<typename T>
+	using binary_kernel = auto(T*, T const*, std::size_t) noexcept -> void;
+	template<typename T>
+	using scalar_kernel = auto(T*, T, std::size_t) noexcept -> void;
+
+	template<typename T>
+	struct basic_kernel_table {
+		isa instruction_set;
+		dot_kernel<T>* dot;
+		sum_of_squares_kernel<T>* sum_of_squares;
+		dot_kernel<T>* squared_distance; // sum((a[i] - b[i])^2), with no temporary
+		dot_and_squares_kernel<T>* dot_and_squares; // dot(a, b), dot(a, a) and dot(b, b) together
+		binary_kernel<T>* add; // a[i] += b[i]
+		binary_kernel<T>* subtract; // a[i] -= b[i]
+		scalar_kernel<T>* scale; // a[i] *= factor
+		scalar_kernel<T>* divide; // a[i] /= factor
+	};
+
+	using kernel_table = basic_kernel_table<double>;
+
+	// Returns the kernels for the given instruction set, or nullptr when either the build or the
+	// CPU does not support it. Defined for float and double.
+	template<typename T = double>
+	auto table(isa) noexcept -> basic_kernel_table<T> const*;
+
+	// Returns the kernels for the widest instruction set the CPU supports.
+	template<typename T = double>
+	auto active() noexcept -> basic_kernel_table<T> const&;
+
+	// Returns a printable name for the instruction set.
+	auto name(isa) noexcept -> char const*;
+} // namespace comp6771::kernels
+
+#endif // COMP6771_KERNELS_HPP
@@ -0,0 +1,220 @@
+#ifndef COMP6771_MAPPED_VECTOR_FILE_HPP
+#define COMP6771_MAPPED_VECTOR_FILE_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Read-only memory-mapped files, and the .fvecs/.bvecs/.ivecs formats used by the common nearest-
+// neighbour corpora. Each row of those formats is a little-endian int32 dimension followed by that
+// many float, uint8 or int32 elements. Mapping a file only reserves address space; pages are read
+// from disk as the rows are touched, so opening a file takes the same time whatever its size.
+// Rows are used in place, so opening or writing a vecs file throws on a big-endian machine.
+namespace comp6771 {
+	// Passed to madvise() so the kernel can read ahead, or not, to suit the scan
+	enum class access_pattern { normal, sequential, random };
+
+	struct map_options {
+		access_pattern access = access_pattern::normal;
+		bool populate = false; // MAP_POPULATE: read the whole file in while mapping it
+	};
+
+	// The whole of a file, mapped read-only. A mapping is page aligned, so a binary_format file of
+	// doubles can be used in place with vector_file_view(mapped.bytes()).
+	class mapped_file {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit mapped_file(std::filesystem::path const& path, map_options options = {});
+		mapped_file(mapped_file&& org) noexcept;
+		mapped_file(mapped_file const&) = delete;
+
+		/*
+		 * Destructor
+		 */
+		~mapped_file();
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator=(mapped_file&& org) noexcept -> mapped_file&;
+		auto operator=(mapped_file const&) -> mapped_file& = delete;
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto bytes() const noexcept -> std::span<std::byte const>;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		auto advise(access_pattern access) const -> void;
+
+	private:
+		std::byte const* bytes_;
+		std::size_t size_;
+
+		auto unmap() noexcept -> void;
+	};
+
+	// A read-only row of a vecs file. Elements are converted to double as they are read, so a row
+	// works with dot(), euclidean_norm(), distance() and the expression operators like any other
+	// view, and can be copied into a euclidean_vector. Two .fvecs rows go to the float kernels.
+	template<typename S>
+	class vecs_view : public vector_expression_base {
+	public:
+		vecs_view(S const* element, int dimension) noexcept
+		: element_{element}
+		, dimension_{static_cast<std::size_t>(dimension)} {}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return static_cast<int>(dimension_);
+		}
+
+		auto operator[](std::size_t index) const noexcept -> double {
+			assert(index < dimension_);
+			return static_cast<double>(element_[index]);
+		}
+
+		[[nodiscard]] auto data() const noexcept -> S const* {
+			return element_;
+		}
+
+	private:
+		S const* element_;
+		std::size_t dimension_;
+	};
+
+	// A mapped .fvecs, .bvecs or .ivecs file. Every row must have the dimension of the first; the
+	// file size is checked against it on opening, and at() checks each row's own dimension.
+	template<typename S>
+	class vecs_file {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit vecs_file(std::filesystem::path const& path, map_options options = {});
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator[](int row) const noexcept -> vecs_view<S> {
+			assert(row >= 0 and row < size());
+			auto const* const first = file_.bytes().data() + static_cast<std::size_t>(row) * stride_;
+			return vecs_view<S>(reinterpret_cast<S const*>(first + sizeof(std::int32_t)),
+			                    dimensions());
+		}
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto at(int row) const -> vecs_view<S>;
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		auto advise(access_pattern access) const -> void;
+
+		// Every row, as a random-access range of views
+		[[nodiscard]] auto rows() const {
+			return std::views::iota(0, size())
+			       | std::views::transform([this](int row) { return (*this)[row]; });
+		}
+
+	private:
+		mapped_file file_;
+		std::size_t dimension_;
+		std::size_t stride_; // bytes per row, including its dimension
+	};
+
+	using fvecs_file = vecs_file<float>;
+	using bvecs_file = vecs_file<std::uint8_t>;
+	using ivecs_file = vecs_file<std::int32_t>;
+
+	// Writes rows in the vecs format, gathering them into blocks of about 64 KiB. Every row must
+	// have the dimension of the first. A magnitude that the element type cannot hold exactly, such
+	// as 2.5 or 300 in a .bvecs file, throws before any of its row is written. The stream must
+	// outlive the writer, which flushes when it is destroyed.
+	template<typename S>
+	class vecs_writer {
+	public:
+		/*
+		 * Constructors
+		 */
+		explicit vecs_writer(std::ostream& os);
+		vecs_writer(vecs_writer const&) = delete;
+
+		/*
+		 * Destructor
+		 */
+		~vecs_writer();
+
+		/*
+		 * Operator Overloads
+		 */
+		auto operator=(vecs_writer const&) -> vecs_writer& = delete;
+
+		/*
+		 * Member Functions
+		 */
+		template<vector_operand E>
+		auto write(E const& v) -> void {
+			auto const& expr = detail::as_expression(v);
+			auto* const out = begin_row(expr.dimensions());
+			for (auto i = std::size_t{0}; i < static_cast<std::size_t>(expr.dimensions()); ++i) {
+				out[i] = element(expr[i]);
+			}
+			end_row();
+		}
+
+		auto write(float_euclidean_vector const& v) -> void;
+		auto flush() -> void;
+		[[nodiscard]] auto rows() const noexcept -> int;
+
+	private:
+		std::ostream* os_;
+		std::vector<std::byte> buffer_;
+		std::size_t committed_; // bytes of whole rows in buffer_
+		int dimension_;
+		int rows_;
+
+		// Makes room for a row in the buffer and returns where its elements go
+		auto begin_row(int dimension) -> S*;
+		auto end_row() -> void;
+		[[noreturn]] static auto throw_element_out_of_range(double magnitude) -> void;
+
+		static auto element(double magnitude) -> S {
+			if constexpr (std::is_floating_point_v<S>) {
+				return static_cast<S>(magnitude);
+			}
+			else {
+				// the range check comes first, as converting an out-of-range double is undefined
+				if (not(magnitude >= std::numeric_limits<S>::min()
+				        and magnitude <= std::numeric_limits<S>::max())
+				    or static_cast<double>(static_cast<S>(magnitude)) != magnitude)
+				{
+					throw_element_out_of_range(magnitude);
+				}
+				return static_cast<S>(magnitude);
+			}
+		}
+	};
+
+	using fvecs_writer = vecs_writer<float>;
+	using bvecs_writer = vecs_writer<std::uint8_t>;
+	using ivecs_writer = vecs_writer<std::int32_t>;
+
+	extern template class vecs_file<float>;
+	extern template class vecs_file<std::uint8_t>;
+	extern template class vecs_file<std::int32_t>;
+	extern template class vecs_writer<float>;
+	extern template class vecs_writer<std::uint8_t>;
+	extern template class vecs_writer<std::int32_t>;
+} // namespace comp6771
+
+#endif // COMP6771_MAPPED_VECTOR_FILE_HPP
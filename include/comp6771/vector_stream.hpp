@@ -0,0 +1,162 @@
+#ifndef COMP6771_VECTOR_STREAM_HPP
+#define COMP6771_VECTOR_STREAM_HPP
+
+#include <comp6771/binary_format.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <optional>
+
+// Processing vector files larger than memory, a chunk of rows at a time:
+//
+//     auto in = std::ifstream("in.txt");
+//     auto out = std::ofstream("out.bin", std::ios::binary);
+//     auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+//     auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::binary);
+//     comp6771::stream_vectors(reader, writer, {}, comp6771::filter_by_norm{1e-9},
+//                              comp6771::normalize_chunk{});
+//
+// The next chunk is read on another thread while the transforms and the writer work on this one.
+namespace comp6771 {
+	// Text is what operator<< and write_vectors() produce; binary is the format of binary_format.hpp
+	enum class vector_file_format { text, binary };
+
+	// Reads a file of vectors with one dimension into chunks
+	class vector_reader {
+	public:
+		/*
+		 * Constructors
+		 */
+		// Reads the binary header, or the first vector of text, to learn the dimension
+		vector_reader(std::istream& is, vector_file_format format);
+
+		/*
+		 * Member Functions
+		 */
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		// Replaces the rows of `chunk`, which must have this dimension, with up to `max_rows` more
+		// vectors and returns how many were read: zero once the file is exhausted. The chunk only
+		// grows while it has fewer than `max_rows` rows.
+		auto read(euclidean_vector_batch& chunk, int max_rows) -> int;
+
+	private:
+		std::istream* is_;
+		std::optional<binary_reader> binary_;
+		euclidean_vector pending_; // the next text vector, read ahead to learn the dimension
+		bool has_pending_;
+		int dimension_;
+		int text_rows_; // text vectors read, for error messages
+
+		auto read_text() -> bool;
+	};
+
+	// Writes chunks to a file of vectors. A binary file's header is written with the first chunk and
+	// completed by finish(), which also needs a seekable stream.
+	class vector_writer {
+	public:
+		/*
+		 * Constructors
+		 */
+		vector_writer(std::ostream& os, vector_file_format format);
+
+		/*
+		 * Member Functions
+		 */
+		auto write(euclidean_vector_batch const& chunk) -> void;
+		auto finish() -> void; // Completes the file; an empty binary file has dimension 0
+		[[nodiscard]] auto rows() const noexcept -> int;
+
+	private:
+		std::ostream* os_;
+		vector_file_format format_;
+		std::optional<binary_writer> binary_;
+		int rows_;
+	};
+
+	struct stream_options {
+		// Bytes of rows held by the two chunks in flight, whatever the size of the file. A chunk
+		// always has room for at least one row.
+		std::size_t memory_budget = std::size_t{64} << 20;
+	};
+
+	struct stream_summary {
+		int rows_per_chunk;
+		int chunks;
+		int rows_read;
+		int rows_kept; // rows left after the transforms, which the writer wrote
+	};
+
+	/*
+	 * Transforms
+	 */
+	// Scales every row to unit length, throwing like euclidean_vector_batch::normalize_rows()
+	struct normalize_chunk {
+		auto operator()(euclidean_vector_batch& chunk) const -> void;
+	};
+
+	struct scale_chunk {
+		double factor;
+
+		auto operator()(euclidean_vector_batch& chunk) const -> void;
+	};
+
+	// Keeps the rows whose euclidean norm is in [min_norm, max_norm], in their order
+	struct filter_by_norm {
+		double min_norm = 0;
+		double max_norm = std::numeric_limits<double>::infinity();
+
+		auto operator()(euclidean_vector_batch& chunk) const -> void;
+	};
+
+	namespace detail {
+		using chunk_function = void (*)(void const* transforms, euclidean_vector_batch& chunk);
+
+		auto stream_chunks(vector_reader& reader,
+		                   vector_writer* writer,
+		                   stream_options const& options,
+		                   chunk_function process,
+		                   void const* transforms) -> stream_summary;
+
+		// Passes the transforms through a plain function pointer, so the threads stay out of headers
+		template<typename... Transforms>
+		auto stream_transformed(vector_reader& reader,
+		                        vector_writer* writer,
+		                        stream_options const& options,
+		                        Transforms const&... transforms) -> stream_summary {
+			auto const apply = [&](euclidean_vector_batch& chunk) { (transforms(chunk), ...); };
+			using apply_type = decltype(apply);
+			auto const process = [](void const* context, euclidean_vector_batch& chunk) {
+				(*static_cast<apply_type const*>(context))(chunk);
+			};
+			return stream_chunks(reader, writer, options, process, &apply);
+		}
+	} // namespace detail
+
+	// Reads every chunk of `reader`, applies the transforms to it in order and writes what is left
+	// to `writer`, which is finished at the end. A transform is anything callable with an
+	// euclidean_vector_batch&; it may change rows in place or resize() the chunk to drop them.
+	template<typename... Transforms>
+	requires(std::invocable<Transforms const&, euclidean_vector_batch&> and ...)
+	auto stream_vectors(vector_reader& reader,
+	                    vector_writer& writer,
+	                    stream_options const& options,
+	                    Transforms const&... transforms) -> stream_summary {
+		return detail::stream_transformed(reader, &writer, options, transforms...);
+	}
+
+	// The same without a writer, for jobs whose last transform consumes the rows, such as
+	// collecting their norms
+	template<typename... Transforms>
+	requires(std::invocable<Transforms const&, euclidean_vector_batch&> and ...)
+	auto stream_vectors(vector_reader& reader,
+	                    stream_options const& options,
+	                    Transforms const&... transforms) -> stream_summary {
+		return detail::stream_transformed(reader, nullptr, options, transforms...);
+	}
+} // namespace comp6771
+
+#endif // COMP6771_VECTOR_STREAM_HPP
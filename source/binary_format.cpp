@@ -0,0 +1,477 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/binary_format.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto file_magic = std::array<char, 8>{'C', '6', '7', '7', '1', 'V', 'E', 'C'};
+		constexpr auto byte_order_mark = std::uint32_t{0x01020304};
+
+		struct file_header {
+			std::array<char, 8> magic;
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint32_t scalar_size;
+			std::uint32_t reserved;
+			std::uint64_t dimension;
+			std::uint64_t count;
+			std::array<std::byte, 24> padding;
+		};
+		static_assert(sizeof(file_header) == binary_header_size);
+		static_assert(std::is_trivially_copyable_v<file_header>);
+
+		// A checked header, in this machine's byte order
+		struct file_shape {
+			std::size_t scalar_size;
+			std::size_t dimension;
+			std::size_t count;
+			std::size_t payload_size; // bytes of magnitudes after the header
+			bool swapped; // written with the other byte order
+			bool payload_present; // the stream was seen to hold payload_size more bytes
+		};
+
+		template<typename U>
+		auto byte_swap(U value) noexcept -> U {
+			auto bytes = std::bit_cast<std::array<std::byte, sizeof(U)>>(value);
+			std::reverse(bytes.begin(), bytes.end());
+			return std::bit_cast<U>(bytes);
+		}
+
+		auto throw_truncated() -> void {
+			throw euclidean_vector_error("euclidean_vector binary file is truncated");
+		}
+
+		// A vector with no dimensions has no magnitudes to show it is really there, so a header
+		// could claim any number of them
+		auto throw_if_no_dimensions(std::size_t dimension, std::size_t count) -> void {
+			if (dimension == 0 and count != 0) {
+				throw euclidean_vector_error("euclidean_vector binary files cannot hold vectors with no "
+				                             "dimensions");
+			}
+		}
+
+		auto throw_if_write_failed(std::ostream const& os) -> void {
+			if (not os) {
+				throw euclidean_vector_error("Could not write the euclidean_vector binary file");
+			}
+		}
+
+		auto check_header(file_header header) -> file_shape {
+			if (header.magic != file_magic) {
+				throw euclidean_vector_error("Not a euclidean_vector binary file");
+			}
+			auto const swapped = header.byte_order != byte_order_mark;
+			if (swapped) {
+				header.byte_order = byte_swap(header.byte_order);
+				header.version = byte_swap(header.version);
+				header.scalar_size = byte_swap(header.scalar_size);
+				header.dimension = byte_swap(header.dimension);
+				header.count = byte_swap(header.count);
+			}
+			if (header.byte_order != byte_order_mark) {
+				throw euclidean_vector_error("Not a euclidean_vector binary file");
+			}
+			if (header.version != binary_format_version) {
+				throw euclidean_vector_error("Unsupported euclidean_vector binary file version "
+				                             + std::to_string(header.version));
+			}
+			if (header.scalar_size != sizeof(float) and header.scalar_size != sizeof(double)) {
+				throw euclidean_vector_error("Unsupported euclidean_vector binary file scalar size "
+				                             + std::to_string(header.scalar_size));
+			}
+			// dimensions and row indices are ints throughout the library
+			if (header.dimension > INT_MAX or header.count > INT_MAX) {
+				throw euclidean_vector_error("euclidean_vector binary file holds "
+				                             + std::to_string(header.count) + " vectors of dimension "
+				                             + std::to_string(header.dimension)
+				                             + ", more than an int can index");
+			}
+			if (header.dimension == 0 and header.count != 0) {
+				throw euclidean_vector_error("Not a euclidean_vector binary file");
+			}
+			auto const scalar_size = std::size_t{header.scalar_size};
+			if (header.count != 0 and header.dimension > SIZE_MAX / scalar_size / header.count) {
+				throw euclidean_vector_error("euclidean_vector binary file holds "
+				                             + std::to_string(header.count) + " vectors of dimension "
+				                             + std::to_string(header.dimension)
+				                             + ", more bytes than memory can address");
+			}
+			auto const payload_size = header.count * header.dimension * scalar_size;
+			return file_shape{scalar_size,
+			                  header.dimension,
+			                  header.count,
+			                  payload_size,
+			                  swapped,
+			                  false};
+		}
+
+		auto write_header(std::ostream& os,
+		                  std::size_t scalar_size,
+		                  std::size_t dimension,
+		                  std::size_t count) -> void {
+			auto header = file_header{};
+			header.magic = file_magic;
+			header.version = binary_format_version;
+			header.byte_order = byte_order_mark;
+			header.scalar_size = static_cast<std::uint32_t>(scalar_size);
+			header.dimension = dimension;
+			header.count = count;
+			os.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		}
+
+		auto read_bytes(std::istream& is, void* out, std::size_t size) -> void {
+			is.read(static_cast<char*>(out), static_cast<std::streamsize>(size));
+			if (static_cast<std::size_t>(is.gcount()) != size) {
+				throw_truncated();
+			}
+		}
+
+		// Checks the header against what the stream holds when the stream can seek, so that a file
+		// claiming more than it has throws before anything is allocated for it
+		auto read_header(std::istream& is) -> file_shape {
+			auto header = file_header{};
+			read_bytes(is, &header, sizeof(header));
+			auto shape = check_header(header);
+
+			auto* const buffer = is.rdbuf();
+			auto const here = buffer->pubseekoff(0, std::ios::cur, std::ios::in);
+			if (here == std::streampos(-1)) {
+				return shape;
+			}
+			auto const end = buffer->pubseekoff(0, std::ios::end, std::ios::in);
+			buffer->pubseekpos(here, std::ios::in);
+			if (end == std::streampos(-1)) {
+				return shape;
+			}
+			if (static_cast<std::size_t>(end - here) < shape.payload_size) {
+				throw_truncated();
+			}
+			shape.payload_present = true;
+			return shape;
+		}
+
+		// Reads `size` magnitudes stored as From, converting them to T a block at a time
+		template<typename From, vector_scalar T>
+		auto read_converted(std::istream& is, bool swapped, T* out, std::size_t size) -> void {
+			auto block = std::array<From, 1024>();
+			for (auto first = std::size_t{0}; first < size; first += block.size()) {
+				auto const length = std::min(block.size(), size - first);
+				read_bytes(is, block.data(), length * sizeof(From));
+				for (auto i = std::size_t{0}; i < length; ++i) {
+					auto const value = swapped ? byte_swap(block[i]) : block[i];
+					out[first + i] = static_cast<T>(value);
+				}
+			}
+		}
+
+		// Reads the next `size` magnitudes of the file as T. A file of T in this machine's byte
+		// order is read straight into `out`.
+		template<vector_scalar T>
+		auto read_magnitudes(std::istream& is, file_shape const& shape, T* out, std::size_t size)
+		   -> void {
+			if (shape.scalar_size != sizeof(T)) {
+				if (shape.scalar_size == sizeof(float)) {
+					read_converted<float>(is, shape.swapped, out, size);
+				}
+				else {
+					read_converted<double>(is, shape.swapped, out, size);
+				}
+				return;
+			}
+
+			read_bytes(is, out, size * sizeof(T));
+			if (shape.swapped) {
+				std::transform(out, out + size, out, byte_swap<T>);
+			}
+		}
+
+		// Reads the whole payload. On a stream that can't seek, the result grows as the magnitudes
+		// arrive, so a header that claims more than the stream holds throws after taking about
+		// twice what the stream really had, not what the header claimed.
+		template<vector_scalar T>
+		auto read_payload(std::istream& is, file_shape const& shape) -> std::vector<T> {
+			constexpr auto first_block = std::size_t{1} << 16;
+			auto const size = shape.count * shape.dimension;
+			auto magnitudes = std::vector<T>();
+			if (shape.payload_present) {
+				magnitudes.resize(size);
+				read_magnitudes(is, shape, magnitudes.data(), size);
+				return magnitudes;
+			}
+			while (magnitudes.size() < size) {
+				auto const read = magnitudes.size();
+				magnitudes.resize(read + std::min(size - read, std::max(first_block, read)));
+				read_magnitudes(is, shape, magnitudes.data() + read, magnitudes.size() - read);
+			}
+			return magnitudes;
+		}
+	} // namespace
+
+	/*
+	 * Saving
+	 */
+	template<vector_scalar T>
+	auto save(std::ostream& os, basic_euclidean_vector<T> const& v) -> void {
+		save(os, std::span(&v, 1));
+	}
+
+	template<vector_scalar T>
+	auto save(std::ostream& os, std::span<basic_euclidean_vector<T> const> vectors) -> void {
+		auto const dimension =
+		   vectors.empty() ? std::size_t{0} : static_cast<std::size_t>(vectors[0].dimensions());
+		for (auto const& v : vectors) {
+			basic_euclidean_vector<T>::throw_if_dimension_not_equal(
+			   dimension,
+			   static_cast<std::size_t>(v.dimensions()));
+		}
+		throw_if_no_dimensions(dimension, vectors.size());
+
+		write_header(os, sizeof(T), dimension, vectors.size());
+		for (auto const& v : vectors) {
+			os.write(reinterpret_cast<char const*>(v.data()),
+			         static_cast<std::streamsize>(dimension * sizeof(T)));
+		}
+		throw_if_write_failed(os);
+	}
+
+	auto save(std::ostream& os, std::span<euclidean_vector const> vectors) -> void {
+		save<double>(os, vectors);
+	}
+
+	auto save(std::ostream& os, std::span<float_euclidean_vector const> vectors) -> void {
+		save<float>(os, vectors);
+	}
+
+	auto save(std::ostream& os, euclidean_vector_batch const& batch) -> void {
+		auto const dimension = static_cast<std::size_t>(batch.dimensions());
+		throw_if_no_dimensions(dimension, static_cast<std::size_t>(batch.rows()));
+		write_header(os, sizeof(double), dimension, static_cast<std::size_t>(batch.rows()));
+		// rows are padded in memory but packed in the file
+		for (auto row = 0; row < batch.rows(); ++row) {
+			os.write(reinterpret_cast<char const*>(batch[row].data()),
+			         static_cast<std::streamsize>(dimension * sizeof(double)));
+		}
+		throw_if_write_failed(os);
+	}
+
+	/*
+	 * Loading
+	 */
+	template<vector_scalar T>
+	auto load_vector(std::istream& is) -> basic_euclidean_vector<T> {
+		auto const shape = read_header(is);
+		if (shape.count != 1) {
+			throw euclidean_vector_error("euclidean_vector binary file holds "
+			                             + std::to_string(shape.count) + " vectors, not 1");
+		}
+		auto const magnitudes = read_payload<T>(is, shape);
+		return basic_euclidean_vector<T>(magnitudes.begin(), magnitudes.end());
+	}
+
+	template<vector_scalar T>
+	auto load_vectors(std::istream& is) -> std::vector<basic_euclidean_vector<T>> {
+		auto const shape = read_header(is);
+		auto vectors = std::vector<basic_euclidean_vector<T>>();
+		if (not shape.payload_present) {
+			auto const magnitudes = read_payload<T>(is, shape);
+			vectors.reserve(shape.count);
+			auto const dimension = static_cast<std::ptrdiff_t>(shape.dimension);
+			for (auto first = magnitudes.begin(); vectors.size() < shape.count; first += dimension) {
+				vectors.emplace_back(first, first + dimension);
+			}
+			return vectors;
+		}
+
+		vectors.reserve(shape.count);
+		for (auto i = std::size_t{0}; i < shape.count; ++i) {
+			auto& v = vectors.emplace_back(static_cast<int>(shape.dimension));
+			read_magnitudes(is, shape, v.data_mut(), shape.dimension);
+		}
+		return vectors;
+	}
+
+	auto load_batch(std::istream& is) -> euclidean_vector_batch {
+		auto const shape = read_header(is);
+		// A stream that can't seek is read whole first, so the batch is sized by what arrived
+		auto const staged =
+		   shape.payload_present ? std::vector<double>() : read_payload<double>(is, shape);
+		auto batch =
+		   euclidean_vector_batch(static_cast<int>(shape.count), static_cast<int>(shape.dimension));
+		for (auto row = 0; row < batch.rows(); ++row) {
+			if (shape.payload_present) {
+				read_magnitudes(is, shape, batch[row].data(), shape.dimension);
+			}
+			else {
+				std::copy_n(staged.data() + static_cast<std::size_t>(row) * shape.dimension,
+				            shape.dimension,
+				            batch[row].data());
+			}
+		}
+		return batch;
+	}
+
+	/*
+	 * binary_reader
+	 */
+	binary_reader::binary_reader(std::istream& is)
+	: is_{&is}
+	, scalar_size_{0}
+	, dimension_{0}
+	, count_{0}
+	, next_{0}
+	, swapped_{false} {
+		auto const shape = read_header(is);
+		scalar_size_ = shape.scalar_size;
+		dimension_ = shape.dimension;
+		count_ = shape.count;
+		swapped_ = shape.swapped;
+	}
+
+	auto binary_reader::size() const noexcept -> int {
+		return static_cast<int>(count_);
+	}
+
+	auto binary_reader::dimensions() const noexcept -> int {
+		return static_cast<int>(dimension_);
+	}
+
+	auto binary_reader::remaining() const noexcept -> int {
+		return static_cast<int>(count_ - next_);
+	}
+
+	auto binary_reader::read(mutable_euclidean_vector_view out) -> bool {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(out.dimensions()));
+		if (next_ == count_) {
+			return false;
+		}
+		auto const shape = file_shape{scalar_size_,
+		                              dimension_,
+		                              count_,
+		                              count_ * dimension_ * scalar_size_,
+		                              swapped_,
+		                              true};
+		read_magnitudes(*is_, shape, out.data(), dimension_);
+		++next_;
+		return true;
+	}
+
+	/*
+	 * binary_writer
+	 */
+	binary_writer::binary_writer(std::ostream& os, int dimension)
+	: os_{&os}
+	, start_{os.tellp()}
+	, dimension_{static_cast<std::size_t>(dimension)}
+	, count_{0} {
+		if (start_ < 0) {
+			throw euclidean_vector_error("binary_writer needs a seekable stream");
+		}
+		write_header(os, sizeof(double), dimension_, 0);
+		throw_if_write_failed(os);
+	}
+
+	auto binary_writer::write(euclidean_vector_view row) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(row.dimensions()));
+		throw_if_no_dimensions(dimension_, 1);
+		os_->write(reinterpret_cast<char const*>(row.data()),
+		           static_cast<std::streamsize>(dimension_ * sizeof(double)));
+		throw_if_write_failed(*os_);
+		++count_;
+	}
+
+	auto binary_writer::finish() -> void {
+		auto const end = os_->tellp();
+		auto const count = std::uint64_t{count_};
+		os_->seekp(start_ + static_cast<std::streamoff>(offsetof(file_header, count)));
+		os_->write(reinterpret_cast<char const*>(&count), sizeof(count));
+		os_->seekp(end);
+		throw_if_write_failed(*os_);
+	}
+
+	auto binary_writer::rows() const noexcept -> int {
+		return static_cast<int>(count_);
+	}
+
+	/*
+	 * vector_file_view
+	 */
+	vector_file_view::vector_file_view(std::span<std::byte const> file)
+	: magnitude_{nullptr}
+	, dimension_{0}
+	, count_{0} {
+		if (file.size() < binary_header_size) {
+			throw_truncated();
+		}
+		auto header = file_header{};
+		std::memcpy(&header, file.data(), sizeof(header));
+		auto const shape = check_header(header);
+		if (shape.scalar_size != sizeof(double)) {
+			throw euclidean_vector_error("vector_file_view needs a file of doubles, not "
+			                             + std::to_string(shape.scalar_size) + "-byte scalars");
+		}
+		if (shape.swapped) {
+			throw euclidean_vector_error("vector_file_view needs a file in this machine's byte "
+			                             "order; use load_batch() to convert it");
+		}
+		auto const* const first = file.data() + binary_header_size;
+		if (reinterpret_cast<std::uintptr_t>(first) % alignof(double) != 0) {
+			throw euclidean_vector_error("vector_file_view needs 8-byte aligned bytes");
+		}
+		if (file.size() - binary_header_size < shape.payload_size) {
+			throw_truncated();
+		}
+
+		magnitude_ = reinterpret_cast<double const*>(first);
+		dimension_ = shape.dimension;
+		count_ = shape.count;
+	}
+
+	auto vector_file_view::operator[](int row) const noexcept -> euclidean_vector_view {
+		return euclidean_vector_view(magnitude_ + static_cast<std::size_t>(row) * dimension_,
+		                             static_cast<int>(dimension_));
+	}
+
+	auto vector_file_view::at(int row) const -> euclidean_vector_view {
+		if (row < 0 or row >= size()) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " is not valid for this vector_file_view object");
+		}
+		return (*this)[row];
+	}
+
+	auto vector_file_view::size() const noexcept -> int {
+		return static_cast<int>(count_);
+	}
+
+	auto vector_file_view::dimensions() const noexcept -> int {
+		return static_cast<int>(dimension_);
+	}
+
+	auto vector_file_view::data() const noexcept -> double const* {
+		return magnitude_;
+	}
+
+	template auto save(std::ostream&, basic_euclidean_vector<float> const&) -> void;
+	template auto save(std::ostream&, basic_euclidean_vector<double> const&) -> void;
+	template auto save(std::ostream&, std::span<basic_euclidean_vector<float> const>) -> void;
+	template auto save(std::ostream&, std::span<basic_euclidean_vector<double> const>) -> void;
+	template auto load_vector(std::istream&) -> basic_euclidean_vector<float>;
+	template auto load_vector(std::istream&) -> basic_euclidean_vector<double>;
+	template auto load_vectors(std::istream&) -> std::vector<basic_euclidean_vector<float>>;
+	template auto load_vectors(std::istream&) -> std::vector<basic_euclidean_vector<double>>;
+} // namespace comp6771
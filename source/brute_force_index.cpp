@@ -0,0 +1,184 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/brute_force_index.hpp>
+#include <comp6771/kernels.hpp>
+
+#include "parallel.hpp"
+#include "top_k.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		// Rows are scanned in blocks of about this many doubles (256 KiB), small enough to stay in
+		// L2 while every query in a batch is compared with them.
+		constexpr auto block_elements = std::size_t{1} << 15;
+	} // namespace
+
+	/*
+	 * Constructors
+	 */
+	brute_force_index::brute_force_index(euclidean_vector_batch database, metric m)
+	: database_{std::move(database)}
+	, metric_{m} {
+		norms_.reserve(static_cast<std::size_t>(database_.rows()));
+		for (auto row = 0; row < database_.rows(); ++row) {
+			// The padding is zero, so the whole padded row can be summed.
+			norms_.push_back(row_norm(database_[row].data(), database_.stride()));
+		}
+	}
+
+	brute_force_index::brute_force_index(std::span<euclidean_vector const> vectors, metric m)
+	: brute_force_index(euclidean_vector_batch(vectors), m) {}
+
+	/*
+	 * Member Functions
+	 */
+	auto brute_force_index::size() const noexcept -> int {
+		return database_.rows();
+	}
+
+	auto brute_force_index::dimensions() const noexcept -> int {
+		return database_.dimensions();
+	}
+
+	auto brute_force_index::distance_metric() const noexcept -> metric {
+		return metric_;
+	}
+
+	auto brute_force_index::database() const noexcept -> euclidean_vector_batch const& {
+		return database_;
+	}
+
+	auto brute_force_index::add(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const norm = row_norm(v.data(), static_cast<std::size_t>(v.dimensions()));
+		norms_.reserve(norms_.size() + 1);
+		database_.push_back(v);
+		norms_.push_back(norm);
+	}
+
+	auto brute_force_index::search(euclidean_vector const& query, int k) const
+	   -> std::vector<neighbour> {
+		return search(euclidean_vector_view(query), k);
+	}
+
+	auto brute_force_index::search(euclidean_vector_view query, int k) const
+	   -> std::vector<neighbour> {
+		throw_if_k_is_negative(k);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(query.dimensions()));
+		auto const length = static_cast<std::size_t>(query.dimensions());
+		auto const prepared = prepare(query.data(), length);
+		return std::move(scan(std::span(&prepared, 1), length, k).front());
+	}
+
+	auto brute_force_index::search(euclidean_vector_batch const& queries, int k) const
+	   -> std::vector<std::vector<neighbour>> {
+		throw_if_k_is_negative(k);
+		auto const dimension = static_cast<std::size_t>(queries.dimensions());
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               dimension);
+		// Equal dimensions give equal strides, and both paddings are zero, so the dot products can
+		// run over whole padded rows.
+		auto const length = queries.stride();
+		auto prepared = std::vector<query>();
+		prepared.reserve(static_cast<std::size_t>(queries.rows()));
+		for (auto row = 0; row < queries.rows(); ++row) {
+			prepared.push_back(prepare(queries[row].data(), length));
+		}
+		return scan(prepared, length, k);
+	}
+
+	/*
+	 * Helper Functions
+	 */
+	auto brute_force_index::throw_if_k_is_negative(int k) -> void {
+		if (k < 0) {
+			throw euclidean_vector_error("Cannot search for " + std::to_string(k) + " neighbours");
+		}
+	}
+
+	auto brute_force_index::row_norm(double const* magnitude, std::size_t length) const -> double {
+		switch (metric_) {
+		case metric::l2: return kernels::active().sum_of_squares(magnitude, length);
+		case metric::inner_product: return 0;
+		case metric::cosine: {
+			auto const e_norm = std::sqrt(kernels::active().sum_of_squares(magnitude, length));
+			euclidean_vector::throw_if_cosine_is_undefined(e_norm, e_norm);
+			return 1.0 / e_norm;
+		}
+		}
+		return 0;
+	}
+
+	auto brute_force_index::prepare(double const* magnitude, std::size_t length) const -> query {
+		return query{magnitude, row_norm(magnitude, length)};
+	}
+
+	auto brute_force_index::scan(std::span<query const> queries, std::size_t length, int k) const
+	   -> std::vector<std::vector<neighbour>> {
+		auto const rows = static_cast<std::size_t>(size());
+		auto const wanted = std::min(static_cast<std::size_t>(k), rows);
+		auto best = std::vector<detail::top_k>(queries.size(), detail::top_k(wanted));
+		auto best_mutex = std::mutex();
+
+		auto const& kernels = kernels::active();
+		auto const block_rows =
+		   std::max(std::size_t{1}, block_elements / std::max(length, std::size_t{1}));
+		// Every key is "smaller is better", so one heap serves all three metrics.
+		auto const key = [this](double dot, query const& q, std::size_t row) noexcept {
+			switch (metric_) {
+			case metric::l2: return q.norm + norms_[row] - 2 * dot;
+			case metric::inner_product: return -dot;
+			case metric::cosine: return -dot * q.norm * norms_[row];
+			}
+			return 0.0;
+		};
+
+		auto const scan_rows = [&](std::size_t first, std::size_t last) {
+			auto local = std::vector<detail::top_k>(queries.size(), detail::top_k(wanted));
+			for (auto block = first; block < last; block += block_rows) {
+				auto const block_end = std::min(last, block + block_rows);
+				for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+					for (auto row = block; row < block_end; ++row) {
+						auto const* const x = database_[static_cast<int>(row)].data();
+						auto const dot = kernels.dot(queries[i].magnitude, x, length);
+						local[i].push(key(dot, queries[i], row), static_cast<int>(row));
+					}
+				}
+			}
+
+			auto const lock = std::scoped_lock(best_mutex);
+			for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+				best[i].merge(local[i]);
+			}
+		};
+
+		auto const work_per_row = std::max(length * queries.size(), std::size_t{1});
+		detail::parallel_for(rows, detail::elements_per_thread / work_per_row, scan_rows);
+
+		auto results = std::vector<std::vector<neighbour>>();
+		results.reserve(queries.size());
+		for (auto& candidates : best) {
+			auto result = std::move(candidates).sorted();
+			for (auto& found : result) {
+				switch (metric_) {
+				// rounding can take the expanded form slightly below zero for near-identical rows
+				case metric::l2: found.score = std::sqrt(std::max(found.score, 0.0)); break;
+				case metric::inner_product: found.score = -found.score; break;
+				case metric::cosine: found.score = std::clamp(-found.score, -1.0, 1.0); break;
+				}
+			}
+			results.push_back(std::move(result));
+		}
+		return results;
+	}
+} // namespace comp6771
@@ -3,297 +3,800 @@
 //
 
 #include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <system_error>
 
 namespace comp6771 {
 
 	/*
 	 * Constructors
 	 */
-	euclidean_vector::euclidean_vector() noexcept
-	: magnitude_{std::make_unique<double[]>(1)}
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector() noexcept
+	: magnitude_{nullptr}
 	, dimension_{1}
 	, e_norm_{-1} {
-		magnitude_[0] = 0;
+		inline_magnitude_[0] = 0;
 	}
 
-	euclidean_vector::euclidean_vector(int num_dimensions) noexcept
-	: magnitude_{std::make_unique<double[]>(static_cast<std::size_t>(num_dimensions))}
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int num_dimensions) noexcept
+	: magnitude_{make_storage(static_cast<std::size_t>(num_dimensions))}
 	, dimension_{static_cast<std::size_t>(num_dimensions)}
 	, e_norm_{-1} {
-		std::fill_n(magnitude_.get(), dimension_, 0);
+		std::fill_n(storage(), dimension_, 0);
 	}
 
-	euclidean_vector::euclidean_vector(int num_dimensions, double value) noexcept
-	: euclidean_vector(num_dimensions) {
-		std::fill_n(magnitude_.get(), dimension_, value);
+	// The remaining constructors allocate uninitialised storage and write each element once.
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int num_dimensions, T value) noexcept
+	: magnitude_{make_storage(static_cast<std::size_t>(num_dimensions))}
+	, dimension_{static_cast<std::size_t>(num_dimensions)}
+	, e_norm_{-1} {
+		std::fill_n(storage(), dimension_, value);
 	}
 
-	euclidean_vector::euclidean_vector(std::vector<double>::const_iterator begin,
-	                                   std::vector<double>::const_iterator end) noexcept
-	: euclidean_vector(static_cast<int>(std::distance(begin, end))) {
-		std::copy(begin, end, magnitude_.get());
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(
+	   typename std::vector<T>::const_iterator begin,
+	   typename std::vector<T>::const_iterator end) noexcept
+	: magnitude_{make_storage(static_cast<std::size_t>(std::distance(begin, end)))}
+	, dimension_{static_cast<std::size_t>(std::distance(begin, end))}
+	, e_norm_{-1} {
+		std::copy(begin, end, storage());
 	}
 
-	euclidean_vector::euclidean_vector(std::initializer_list<double> list) noexcept
-	: euclidean_vector(static_cast<int>(list.size()), 0) {
-		std::copy(list.begin(), list.end(), magnitude_.get());
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(std::initializer_list<T> list) noexcept
+	: magnitude_{make_storage(list.size())}
+	, dimension_{list.size()}
+	, e_norm_{-1} {
+		std::copy(list.begin(), list.end(), storage());
 	}
 
-	euclidean_vector::euclidean_vector(euclidean_vector const& org) noexcept
-	: euclidean_vector(static_cast<int>(org.dimension_)) {
-		std::copy(org.magnitude_.get(), org.magnitude_.get() + dimension_, magnitude_.get());
-		e_norm_ = org.e_norm_;
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector const& org) noexcept
+	: magnitude_{make_storage(org.dimension_)}
+	, dimension_{org.dimension_}
+	, e_norm_{org.e_norm_}
+	, tracker_{copy_tracker(org)} {
+		std::copy(org.data(), org.data() + dimension_, storage());
 	}
 
-	euclidean_vector::euclidean_vector(euclidean_vector&& org) noexcept
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(T const* first, T const* last) noexcept
+	: magnitude_{make_storage(static_cast<std::size_t>(last - first))}
+	, dimension_{static_cast<std::size_t>(last - first)}
+	, e_norm_{-1} {
+		std::copy(first, last, storage());
+	}
+
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector&& org) noexcept
 	: magnitude_{std::move(org.magnitude_)}
 	, dimension_{org.dimension_}
-	, e_norm_{org.e_norm_} {
+	, e_norm_{org.e_norm_}
+	, tracker_{std::move(org.tracker_)} {
+		if (is_inline()) {
+			std::copy(org.inline_magnitude_.data(),
+			          org.inline_magnitude_.data() + dimension_,
+			          inline_magnitude_.data());
+		}
 		org.dimension_ = 0;
-		org.e_norm_ = -1;
+		org.invalidate_norm();
 	}
 
 	/*
 	 * Operator Overloads
 	 */
-	auto euclidean_vector::operator=(euclidean_vector const& org) noexcept -> euclidean_vector& {
-		auto cp_vector = euclidean_vector(org);
-		std::swap(magnitude_, cp_vector.magnitude_);
-		std::swap(dimension_, cp_vector.dimension_);
-		std::swap(e_norm_, cp_vector.e_norm_);
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector const& org)
+	   -> basic_euclidean_vector& {
+		if (this == &org) {
+			return *this;
+		}
+
+		// Keep the current storage when it already has the right size; otherwise allocate storage
+		// sized for org before touching anything, so a failed allocation leaves *this unchanged.
+		auto tracker = copy_tracker(org);
+		if (dimension_ != org.dimension_) {
+			magnitude_ = make_storage(org.dimension_);
+			dimension_ = org.dimension_;
+		}
+
+		std::copy(org.data(), org.data() + dimension_, storage());
+		e_norm_ = org.e_norm_;
+		tracker_ = std::move(tracker);
 		return *this;
 	}
 
-	auto euclidean_vector::operator=(euclidean_vector&& org) noexcept -> euclidean_vector& {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector&& org) noexcept
+	   -> basic_euclidean_vector& {
 		if (this == &org) {
 			return *this;
 		}
 
-		std::swap(magnitude_, org.magnitude_);
-		std::swap(dimension_, org.dimension_);
-		std::swap(e_norm_, org.e_norm_);
+		magnitude_ = std::move(org.magnitude_);
+		dimension_ = org.dimension_;
+		e_norm_ = org.e_norm_;
+		tracker_ = std::move(org.tracker_);
+		if (is_inline()) {
+			std::copy(org.inline_magnitude_.data(),
+			          org.inline_magnitude_.data() + dimension_,
+			          inline_magnitude_.data());
+		}
 
 		// reset the moved-from vector
 		org.dimension_ = 0;
-		org.e_norm_ = -1;
-		org.magnitude_.reset();
+		org.invalidate_norm();
 
 		return *this;
 	}
 
-	auto euclidean_vector::operator[](int index) noexcept -> double& {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator[](int index) noexcept -> reference {
 		assert(index >= 0 and index < static_cast<int>(dimension_));
-		e_norm_ = -1;
-		return magnitude_[static_cast<std::size_t>(index)];
+		return reference(this, storage() + static_cast<std::size_t>(index));
 	}
 
-	auto euclidean_vector::operator[](int index) const noexcept -> const double& {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator[](int index) const noexcept -> T const& {
 		assert(index >= 0 and index < static_cast<int>(dimension_));
-		return magnitude_[static_cast<std::size_t>(index)];
+		return data()[static_cast<std::size_t>(index)];
 	}
 
-	auto euclidean_vector::operator+() const noexcept -> euclidean_vector {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator+() const noexcept -> basic_euclidean_vector {
 		return *this;
 	}
 
-	auto euclidean_vector::operator-() const noexcept -> euclidean_vector {
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimension_,
-		               magnitude_.get(),
-		               std::negate<>());
-		return *this;
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator-() const noexcept -> basic_euclidean_vector {
+		auto negated = basic_euclidean_vector(*this);
+		auto* const magnitude = negated.storage();
+		std::transform(magnitude, magnitude + dimension_, magnitude, std::negate<>());
+		return negated;
 	}
 
-	auto euclidean_vector::operator+=(euclidean_vector const& v2) -> euclidean_vector& {
-		euclidean_vector::throw_if_dimension_not_equal(*this, v2);
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimension_,
-		               v2.magnitude_.get(),
-		               magnitude_.get(),
-		               std::plus<>());
-		e_norm_ = -1;
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator+=(basic_euclidean_vector const& v2)
+	   -> basic_euclidean_vector& {
+		throw_if_dimension_not_equal(*this, v2);
+		kernels::active<T>().add(storage(), v2.data(), dimension_);
+		invalidate_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator-=(euclidean_vector const& v2) -> euclidean_vector& {
-		euclidean_vector::throw_if_dimension_not_equal(*this, v2);
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimension_,
-		               v2.magnitude_.get(),
-		               magnitude_.get(),
-		               std::minus<>());
-		e_norm_ = -1;
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator-=(basic_euclidean_vector const& v2)
+	   -> basic_euclidean_vector& {
+		throw_if_dimension_not_equal(*this, v2);
+		kernels::active<T>().subtract(storage(), v2.data(), dimension_);
+		invalidate_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator*=(double v2) noexcept -> euclidean_vector& {
-		std::transform(magnitude_.get(), magnitude_.get() + dimension_, magnitude_.get(), [&](double x) {
-			return std::multiplies<>()(x, v2);
-		});
-		e_norm_ = -1;
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator*=(T v2) noexcept -> basic_euclidean_vector& {
+		kernels::active<T>().scale(storage(), v2, dimension_);
+		invalidate_norm();
 		return *this;
 	}
 
-	auto euclidean_vector::operator/=(double v2) -> euclidean_vector& {
-		euclidean_vector::throw_if_factor_is_zero(v2);
-		std::transform(magnitude_.get(), magnitude_.get() + dimension_, magnitude_.get(), [&](double x) {
-			return std::divides<>()(x, v2);
-		});
-		e_norm_ = -1;
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::operator/=(T v2) -> basic_euclidean_vector& {
+		throw_if_factor_is_zero(v2);
+		kernels::active<T>().divide(storage(), v2, dimension_);
+		invalidate_norm();
 		return *this;
 	}
 
-	euclidean_vector::operator std::vector<double>() const noexcept {
-		return std::vector<double>(magnitude_.get(), magnitude_.get() + dimension_);
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::operator std::vector<T>() const noexcept {
+		return std::vector<T>(data(), data() + dimension_);
 	}
 
-	euclidean_vector::operator std::list<double>() const noexcept {
-		return std::list<double>(magnitude_.get(), magnitude_.get() + dimension_);
+	template<vector_scalar T>
+	basic_euclidean_vector<T>::operator std::list<T>() const noexcept {
+		return std::list<T>(data(), data() + dimension_);
 	}
 
 	/*
 	 * Member Functions
 	 */
-	[[nodiscard]] auto euclidean_vector::at(int index) const -> double {
-		euclidean_vector::throw_if_index_out_of_range(index, static_cast<int>(dimension_));
-		return magnitude_[static_cast<std::size_t>(index)];
+	template<vector_scalar T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::at(int index) const -> T {
+		throw_if_index_out_of_range(index, static_cast<int>(dimension_));
+		return data()[static_cast<std::size_t>(index)];
 	}
 
-	[[nodiscard]] auto euclidean_vector::at(int index) -> double& {
-		euclidean_vector::throw_if_index_out_of_range(index, static_cast<int>(dimension_));
-		e_norm_ = -1;
-		return magnitude_[static_cast<std::size_t>(index)];
+	template<vector_scalar T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::at(int index) -> reference {
+		throw_if_index_out_of_range(index, static_cast<int>(dimension_));
+		return reference(this, storage() + static_cast<std::size_t>(index));
 	}
 
-	[[nodiscard]] auto euclidean_vector::dimensions() const -> int {
+	template<vector_scalar T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::dimensions() const -> int {
 		return static_cast<int>(dimension_);
 	}
 
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::set(int index, T value) noexcept -> void {
+		assert(index >= 0 and index < static_cast<int>(dimension_));
+		write(storage() + static_cast<std::size_t>(index), value);
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::data() const noexcept -> T const* {
+		return is_inline() ? inline_magnitude_.data() : magnitude_.get();
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::data_mut() noexcept -> T* {
+		invalidate_norm();
+		return storage();
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::normalize() -> basic_euclidean_vector& {
+		throw_if_dimension_is_zero(dimensions());
+		auto const e_norm = euclidean_norm(*this);
+		throw_if_norm_is_zero(e_norm);
+		auto const& kernels = kernels::active<T>();
+		// The reciprocal overflows for the very smallest norms, which still divide cleanly.
+		if (auto const reciprocal = static_cast<T>(1.0 / e_norm); std::isfinite(reciprocal)) {
+			kernels.scale(storage(), reciprocal, dimension_);
+		}
+		else {
+			kernels.divide(storage(), static_cast<T>(e_norm), dimension_);
+		}
+		invalidate_norm();
+		e_norm_ = 1.0;
+		return *this;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::set_incremental_norm(bool enabled) noexcept -> void {
+		// the sum is only known once the next euclidean_norm() has computed it exactly
+		tracker_ = enabled ? std::make_unique<norm_tracker>() : nullptr;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::incremental_norm() const noexcept -> bool {
+		return tracker_ != nullptr;
+	}
+
 	/*
-	 * Friend Functions
+	 * Utility functions
 	 */
-	auto operator==(euclidean_vector const& v1, euclidean_vector const& v2) noexcept -> bool {
-		return euclidean_vector::is_dimension_equal(v1, v2)
-		       and std::equal(v1.magnitude_.get(),
-		                      v1.magnitude_.get() + v1.dimension_,
-		                      v2.magnitude_.get(),
-		                      v2.magnitude_.get() + v2.dimension_,
-		                      [](double x, double y) { return std::equal_to<>()(x, y); });
+	template<vector_scalar T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) noexcept -> double {
+		if (auto const known = v.known_norm(); known >= 0) {
+			return known;
+		}
+		return v.store_norm(kernels::active<T>().sum_of_squares(v.data(), v.dimension_));
 	}
 
-	auto operator!=(euclidean_vector const& v1, euclidean_vector const& v2) noexcept -> bool {
-		return not(v1 == v2);
+	template<vector_scalar T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T> {
+		basic_euclidean_vector<T>::throw_if_dimension_is_zero(v.dimensions());
+		auto e_norm = euclidean_norm(v);
+		auto unit_vec = basic_euclidean_vector<T>(v);
+		basic_euclidean_vector<T>::throw_if_norm_is_zero(e_norm);
+		return unit_vec /= static_cast<T>(e_norm);
 	}
 
-	auto operator+(euclidean_vector const& v1, euclidean_vector const& v2) -> euclidean_vector {
-		auto lhs_cp = euclidean_vector(v1);
-		return lhs_cp += v2;
+	template<vector_scalar T>
+	auto unit(basic_euclidean_vector<T>&& v) -> basic_euclidean_vector<T> {
+		basic_euclidean_vector<T>::throw_if_dimension_is_zero(v.dimensions());
+		auto e_norm = euclidean_norm(v);
+		basic_euclidean_vector<T>::throw_if_norm_is_zero(e_norm);
+		v /= static_cast<T>(e_norm);
+		return std::move(v);
 	}
 
-	auto operator-(euclidean_vector const& v1, euclidean_vector const& v2) -> euclidean_vector {
-		auto lhs_cp = euclidean_vector(v1);
-		return lhs_cp -= v2;
+	template<vector_scalar T>
+	auto dot(basic_euclidean_vector<T> const& v1, basic_euclidean_vector<T> const& v2) -> double {
+		basic_euclidean_vector<T>::throw_if_dimension_not_equal(v1, v2);
+		return kernels::active<T>().dot(v1.data(), v2.data(), v1.dimension_);
 	}
 
-	auto operator*(euclidean_vector const& vec, double factor) noexcept -> euclidean_vector {
-		auto vec_cp = euclidean_vector(vec);
-		return vec_cp *= factor;
+	template<vector_scalar T>
+	auto normalize(std::span<basic_euclidean_vector<T>> vectors) -> void {
+		for (auto const& v : vectors) {
+			basic_euclidean_vector<T>::throw_if_dimension_is_zero(v.dimensions());
+		}
+
+		auto zero_norm = std::atomic<bool>(false);
+		auto const normalize_range = [&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				if (euclidean_norm(vectors[i]) == 0) {
+					zero_norm.store(true, std::memory_order_relaxed);
+				}
+				else {
+					vectors[i].normalize();
+				}
+			}
+		};
+
+		auto const dimension = vectors.empty() ? 1 : static_cast<std::size_t>(vectors[0].dimensions());
+		detail::parallel_for(vectors.size(), detail::elements_per_thread / dimension, normalize_range);
+		if (zero_norm) {
+			basic_euclidean_vector<T>::throw_if_norm_is_zero(0);
+		}
 	}
 
-	auto operator/(euclidean_vector const& vec, double factor) -> euclidean_vector {
-		auto vec_cp = euclidean_vector(vec);
-		return vec_cp /= factor;
+	auto normalize(std::span<euclidean_vector> vectors) -> void {
+		normalize<double>(vectors);
 	}
 
-	auto operator<<(std::ostream& os, euclidean_vector const& vec) noexcept -> std::ostream& {
-		if (vec.dimension_ == 0) {
-			return os << "[]";
+	auto normalize(std::span<float_euclidean_vector> vectors) -> void {
+		normalize<float>(vectors);
+	}
+
+	// One pass over both vectors: no temporary for v1 - v2, and no norm cached on one.
+	template<vector_scalar T>
+	auto squared_distance(basic_euclidean_vector<T> const& v1, basic_euclidean_vector<T> const& v2)
+	   -> double {
+		basic_euclidean_vector<T>::throw_if_dimension_not_equal(v1, v2);
+		return kernels::active<T>().squared_distance(v1.data(),
+		                                             v2.data(),
+		                                             static_cast<std::size_t>(v1.dimensions()));
+	}
+
+	template<vector_scalar T>
+	auto distance(basic_euclidean_vector<T> const& v1, basic_euclidean_vector<T> const& v2)
+	   -> double {
+		return std::sqrt(squared_distance(v1, v2));
+	}
+
+	template<vector_scalar T>
+	auto cosine_similarity(basic_euclidean_vector<T> const& v1, basic_euclidean_vector<T> const& v2)
+	   -> double {
+		basic_euclidean_vector<T>::throw_if_dimension_not_equal(v1, v2);
+		auto const& kernels = kernels::active<T>();
+		auto norm1 = v1.known_norm();
+		auto norm2 = v2.known_norm();
+		auto dot = 0.0;
+		if (norm1 >= 0 and norm2 >= 0) {
+			dot = kernels.dot(v1.data(), v2.data(), v1.dimension_);
+		}
+		else {
+			// Reading both vectors for the dot product costs the same as reading them for the norms
+			// too, so fill in whichever cache is missing from the same pass.
+			auto const sums = kernels.dot_and_squares(v1.data(), v2.data(), v1.dimension_);
+			dot = sums.dot;
+			norm1 = norm1 >= 0 ? norm1 : v1.store_norm(sums.a_squares);
+			norm2 = norm2 >= 0 ? norm2 : v2.store_norm(sums.b_squares);
 		}
 
-		os << "[";
+		basic_euclidean_vector<T>::throw_if_cosine_is_undefined(norm1, norm2);
+		return std::clamp(dot / norm1 / norm2, -1.0, 1.0);
+	}
 
-		std::copy(vec.magnitude_.get(),
-		          vec.magnitude_.get() + vec.dimension_,
-		          std::ostream_iterator<double>(os, " "));
-		os.seekp(-1, std::ios_base::end);
-		return os << "]";
+	template<vector_scalar T>
+	auto cosine_distance(basic_euclidean_vector<T> const& v1, basic_euclidean_vector<T> const& v2)
+	   -> double {
+		return 1.0 - cosine_similarity(v1, v2);
 	}
 
 	/*
-	 * Utility functions
+	 * Text Output
 	 */
-	auto euclidean_norm(euclidean_vector const& v) noexcept -> double {
-		if (v.e_norm_ != -1) {
-			return v.e_norm_;
+	namespace detail {
+		namespace {
+			// Buffers larger than this are released after a flush rather than kept per thread.
+			constexpr auto retained_text_capacity = std::size_t{1} << 20;
+
+			// Writes what printf("%.*g") writes with the shortest precision that round-trips, and
+			// at least the default of 6: fixed notation for exponents in [-4, precision), scientific
+			// otherwise, with no trailing zeros. Values of up to six significant digits print as
+			// operator<< always printed them.
+			template<vector_scalar T>
+			auto to_general_chars(char* first, char* last, T value) -> char* {
+				auto const end = std::to_chars(first, last, value, std::chars_format::scientific).ptr;
+				auto* const e = std::find(first, end, 'e');
+				if (e == end) {
+					return end; // inf or nan
+				}
+
+				auto exponent = 0;
+				std::from_chars(e + (e[1] == '+' ? 2 : 1), end, exponent);
+				auto const is_digit = [](char c) { return c >= '0' and c <= '9'; };
+				auto const digits = std::count_if(first, e, is_digit);
+				if (exponent < -4 or exponent >= std::max(digits, std::ptrdiff_t{6})) {
+					return end;
+				}
+				return std::to_chars(first, last, value, std::chars_format::fixed).ptr;
+			}
+		} // namespace
+
+		template<vector_scalar T>
+		auto append_text(std::string& out, T const* magnitude, std::size_t dimension) -> void {
+			// The longest form: a sign, max_digits10 digits, a point and an exponent such as "e-308",
+			// or a sign, "0.000" and max_digits10 digits
+			constexpr auto longest = std::size_t{std::numeric_limits<T>::max_digits10 + 8};
+			auto const start = out.size();
+			out.resize(start + 2 + dimension * (longest + 1));
+			auto* first = out.data() + start;
+			auto* const last = out.data() + out.size();
+			*first++ = '[';
+			for (auto i = std::size_t{0}; i < dimension; ++i) {
+				if (i != 0) {
+					*first++ = ' ';
+				}
+				first = to_general_chars(first, last, magnitude[i]);
+			}
+			*first++ = ']';
+			out.resize(static_cast<std::size_t>(first - out.data()));
 		}
 
-		auto e_norm = std::sqrt(std::inner_product(v.magnitude_.get(),
-		                                           v.magnitude_.get() + v.dimension_,
-		                                           v.magnitude_.get(),
-		                                           0.0));
-		v.e_norm_ = e_norm;
-		return e_norm;
-	}
+		auto text_buffer() noexcept -> std::string& {
+			thread_local auto buffer = std::string();
+			return buffer;
+		}
 
-	auto unit(euclidean_vector const& v) -> euclidean_vector {
-		euclidean_vector::throw_if_dimension_is_zero(v.dimensions());
-		auto e_norm = euclidean_norm(v);
-		auto unit_vec = euclidean_vector(v);
-		euclidean_vector::throw_if_norm_is_zero(e_norm);
-		return unit_vec /= e_norm;
-	}
+		auto flush_text(std::ostream& os, std::string& buffer) -> std::ostream& {
+			os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+			if (buffer.capacity() > retained_text_capacity) {
+				buffer.shrink_to_fit();
+			}
+			return os;
+		}
+
+		template auto append_text(std::string&, float const*, std::size_t) -> void;
+		template auto append_text(std::string&, double const*, std::size_t) -> void;
+	} // namespace detail
+
+	/*
+	 * Text Input
+	 */
+	namespace {
+		// Text longer than this is split into pieces of about this size, parsed on separate threads.
+		constexpr auto parse_piece_bytes = std::size_t{1} << 22;
+
+		// Where and why parsing stopped
+		struct malformed_text {
+			std::size_t offset;
+			char const* problem;
+		};
+
+		auto throw_malformed(malformed_text const& error) -> void {
+			throw euclidean_vector_error("Malformed euclidean_vector text at byte "
+			                             + std::to_string(error.offset) + ": " + error.problem);
+		}
+
+		auto is_space(char c) noexcept -> bool {
+			return c == ' ' or c == '\t' or c == '\n' or c == '\r' or c == '\v' or c == '\f';
+		}
 
-	auto dot(euclidean_vector const& v1, euclidean_vector const& v2) -> double {
-		euclidean_vector::throw_if_dimension_not_equal(v1, v2);
-		return v1.dimensions() == 0 ? 0
-		                            : std::inner_product(v1.magnitude_.get(),
-		                                                 v1.magnitude_.get() + v1.dimension_,
-		                                                 v2.magnitude_.get(),
-		                                                 0.0);
+		auto skip_space(std::string_view text, std::size_t offset) noexcept -> std::size_t {
+			while (offset < text.size() and is_space(text[offset])) {
+				++offset;
+			}
+			return offset;
+		}
+
+		// Parses the vector whose '[' is at text[offset] into `magnitudes`, and returns the offset
+		// just past its ']'. Throws malformed_text.
+		template<vector_scalar T>
+		auto parse_magnitudes(std::string_view text, std::size_t offset, std::vector<T>& magnitudes)
+		   -> std::size_t {
+			if (offset == text.size() or text[offset] != '[') {
+				throw malformed_text{offset, "expected '['"};
+			}
+			magnitudes.clear();
+			for (offset = skip_space(text, offset + 1);; offset = skip_space(text, offset)) {
+				if (offset == text.size()) {
+					throw malformed_text{offset, "expected ']' before the end of the text"};
+				}
+				if (text[offset] == ']') {
+					return offset + 1;
+				}
+
+				auto value = T{};
+				auto const* const first = text.data() + offset;
+				auto const [last, error] = std::from_chars(first, text.data() + text.size(), value);
+				if (error == std::errc::invalid_argument) {
+					throw malformed_text{offset, "expected a number or ']'"};
+				}
+				if (error == std::errc::result_out_of_range) {
+					throw malformed_text{offset, "number out of range"};
+				}
+				offset += static_cast<std::size_t>(last - first);
+				if (offset < text.size() and not is_space(text[offset]) and text[offset] != ']') {
+					throw malformed_text{offset, "expected whitespace or ']'"};
+				}
+				magnitudes.push_back(value);
+			}
+		}
+
+		// Every vector whose '[' is in [first, last). The last one may run past `last`.
+		template<vector_scalar T>
+		auto parse_piece(std::string_view text, std::size_t first, std::size_t last)
+		   -> std::vector<basic_euclidean_vector<T>> {
+			// reused, so parsing allocates only for the vectors themselves
+			thread_local auto magnitudes = std::vector<T>();
+			auto vectors = std::vector<basic_euclidean_vector<T>>();
+			for (auto offset = skip_space(text, first); offset < last;
+			     offset = skip_space(text, offset)) {
+				offset = parse_magnitudes(text, offset, magnitudes);
+				vectors.emplace_back(magnitudes.cbegin(), magnitudes.cend());
+			}
+			return vectors;
+		}
+	} // namespace
+
+	namespace detail {
+		template<vector_scalar T>
+		auto read_text(std::istream& is, basic_euclidean_vector<T>& vec) -> std::istream& {
+			auto const sentry = std::istream::sentry(is);
+			if (not sentry) {
+				return is;
+			}
+			if (is.peek() != '[') {
+				is.setstate(std::ios_base::failbit);
+				return is;
+			}
+
+			auto& buffer = text_buffer();
+			buffer.clear();
+			if (not std::getline(is, buffer, ']') or is.eof()) {
+				is.setstate(std::ios_base::failbit);
+				return is;
+			}
+			buffer.push_back(']');
+
+			thread_local auto magnitudes = std::vector<T>();
+			try {
+				parse_magnitudes(buffer, 0, magnitudes);
+			} catch (malformed_text const&) {
+				is.setstate(std::ios_base::failbit);
+				return is;
+			}
+			vec = basic_euclidean_vector<T>(magnitudes.cbegin(), magnitudes.cend());
+			return is;
+		}
+
+		template auto read_text(std::istream&, basic_euclidean_vector<float>&) -> std::istream&;
+		template auto read_text(std::istream&, basic_euclidean_vector<double>&) -> std::istream&;
+	} // namespace detail
+
+	template<vector_scalar T>
+	auto parse_vectors(std::string_view text) -> std::vector<basic_euclidean_vector<T>> {
+		// Piece i holds the vectors whose '[' is in [bounds[i], bounds[i + 1]). Each inner bound is
+		// moved forward to a '[', which in well-formed text only ever starts a vector, so every
+		// piece starts where a serial parse would. A vector that runs past its bound meets that
+		// '[' and fails, so the first failing piece has the first problem in the text.
+		auto const pieces = std::max(std::size_t{1}, text.size() / parse_piece_bytes);
+		auto bounds = std::vector<std::size_t>{0};
+		for (auto i = std::size_t{1}; i < pieces; ++i) {
+			auto const bound = std::min(text.find('[', i * (text.size() / pieces)), text.size());
+			bounds.push_back(std::max(bound, bounds.back()));
+		}
+		bounds.push_back(text.size());
+
+		auto parsed = std::vector<std::vector<basic_euclidean_vector<T>>>(pieces);
+		auto errors = std::vector<std::optional<malformed_text>>(pieces);
+		detail::parallel_for(pieces, 1, [&](std::size_t first, std::size_t last) {
+			for (auto i = first; i < last; ++i) {
+				try {
+					parsed[i] = parse_piece<T>(text, bounds[i], bounds[i + 1]);
+				} catch (malformed_text const& error) {
+					errors[i] = error;
+				}
+			}
+		});
+		for (auto const& error : errors) {
+			if (error) {
+				throw_malformed(*error);
+			}
+		}
+
+		if (pieces == 1) {
+			return std::move(parsed.front());
+		}
+		auto total = std::size_t{0};
+		for (auto const& piece : parsed) {
+			total += piece.size();
+		}
+		auto vectors = std::vector<basic_euclidean_vector<T>>();
+		vectors.reserve(total);
+		for (auto& piece : parsed) {
+			std::move(piece.begin(), piece.end(), std::back_inserter(vectors));
+		}
+		return vectors;
 	}
 
 	/*
 	 * Helper Functions
 	 */
-	auto euclidean_vector::throw_if_norm_is_zero(double norm) -> void {
+	template<vector_scalar T>
+	// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+	auto basic_euclidean_vector<T>::make_storage(std::size_t dimension) -> std::unique_ptr<T[]> {
+		// Every constructor writes all of the elements, so don't value-initialise them first.
+		return dimension > inline_dimensions ? std::make_unique_for_overwrite<T[]>(dimension)
+		                                     : nullptr;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::copy_tracker(basic_euclidean_vector const& org)
+	   -> std::unique_ptr<norm_tracker> {
+		return org.tracker_ ? std::make_unique<norm_tracker>(*org.tracker_) : nullptr;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::is_inline() const noexcept -> bool {
+		return dimension_ <= inline_dimensions;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::storage() noexcept -> T* {
+		return is_inline() ? inline_magnitude_.data() : magnitude_.get();
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::known_norm() const noexcept -> double {
+		// Concurrent calls on the same const vector may all miss the cache and store it. They compute
+		// the same value from the same elements, so whichever store lands last is still correct.
+		if (auto const cached = e_norm_.load(); cached != -1) {
+			return cached;
+		}
+		if (not tracker_) {
+			return -1;
+		}
+
+		// A call that sees the drift reset by store_norm() must also see the exact sum stored with
+		// it, so the reset is published with release after the sum and read with acquire before it.
+		auto const drift = tracker_->drift.load(std::memory_order_acquire);
+		auto const sum = tracker_->sum_of_squares.load();
+		if (sum < 0 or drift > sum * incremental_norm_tolerance) {
+			return -1;
+		}
+		auto const e_norm = std::sqrt(sum);
+		e_norm_ = e_norm;
+		return e_norm;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::store_norm(double sum_of_squares) const noexcept -> double {
+		if (tracker_) {
+			tracker_->sum_of_squares = sum_of_squares;
+			tracker_->drift.store(0, std::memory_order_release);
+		}
+		auto const e_norm = std::sqrt(sum_of_squares);
+		e_norm_ = e_norm;
+		return e_norm;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::write(T* element, T value) noexcept -> void {
+		if (tracker_ and tracker_->sum_of_squares >= 0) {
+			auto const before = static_cast<double>(*element);
+			auto const after = static_cast<double>(value);
+			auto const old_square = before * before;
+			auto const new_square = after * after;
+			auto const sum = tracker_->sum_of_squares + (new_square - old_square);
+			tracker_->sum_of_squares = sum;
+			// The two products, the difference and the sum each round by at most eps / 2.
+			tracker_->drift = tracker_->drift
+			                 + std::numeric_limits<double>::epsilon()
+			                      * (old_square + new_square + std::abs(sum));
+		}
+		*element = value;
+		e_norm_ = -1;
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_norm_is_zero(double norm) -> void {
 		if (norm == 0) {
 			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not "
 			                             "have a unit vector");
 		}
 	}
 
-	auto euclidean_vector::throw_if_dimension_is_zero(int dimension) -> void {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_cosine_is_undefined(double norm1, double norm2)
+	   -> void {
+		if (norm1 == 0 or norm2 == 0) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean normal does not "
+			                             "have a cosine similarity");
+		}
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_dimension_is_zero(int dimension) -> void {
 		if (dimension == 0) {
 			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a unit "
 			                             "vector");
 		}
 	}
 
-	auto euclidean_vector::is_dimension_equal(euclidean_vector const& v1, euclidean_vector const& v2)
-	   -> bool {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::is_dimension_equal(basic_euclidean_vector const& v1,
+	                                                   basic_euclidean_vector const& v2) -> bool {
 		return v1.dimension_ == v2.dimension_;
 	}
 
-	auto euclidean_vector::throw_if_dimension_not_equal(euclidean_vector const& v1,
-	                                                    euclidean_vector const& v2) -> void {
-		if (not euclidean_vector::is_dimension_equal(v1, v2)) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(v1.dimension_)
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_dimension_not_equal(basic_euclidean_vector const& v1,
+	                                                             basic_euclidean_vector const& v2)
+	   -> void {
+		throw_if_dimension_not_equal(v1.dimension_, v2.dimension_);
+	}
+
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_dimension_not_equal(std::size_t lhs, std::size_t rhs)
+	   -> void {
+		if (lhs != rhs) {
+			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(lhs)
 			                             + ") "
 			                               "and RHS("
-			                             + std::to_string(v2.dimension_) + ") do not match");
+			                             + std::to_string(rhs) + ") do not match");
 		}
 	}
 
-	auto euclidean_vector::throw_if_factor_is_zero(double factor) -> void {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_factor_is_zero(double factor) -> void {
 		if (factor == 0) {
 			throw euclidean_vector_error("Invalid vector division by 0");
 		}
 	}
 
-	auto euclidean_vector::throw_if_index_out_of_range(int index, int dimension) -> void {
+	template<vector_scalar T>
+	auto basic_euclidean_vector<T>::throw_if_index_out_of_range(int index, int dimension) -> void {
 		if (index < 0 or index >= dimension) {
 			throw euclidean_vector_error("Index " + std::to_string(index)
 			                             + " is not valid for this euclidean_vector object");
 		}
 	}
-} // namespace comp6771
\ No newline at end of file
+
+	template class basic_euclidean_vector<float>;
+	template class basic_euclidean_vector<double>;
+	// The storage pointer, the dimension, the cached norm, the tracker pointer and the inline
+	// elements, with nothing else for vectors that never use the incremental norm mode
+	static_assert(sizeof(euclidean_vector)
+	              <= 4 * sizeof(std::uint64_t) + euclidean_vector::inline_dimensions * sizeof(double));
+
+	template auto euclidean_norm(basic_euclidean_vector<float> const&) noexcept -> double;
+	template auto euclidean_norm(basic_euclidean_vector<double> const&) noexcept -> double;
+	template auto unit(basic_euclidean_vector<float> const&) -> basic_euclidean_vector<float>;
+	template auto unit(basic_euclidean_vector<double> const&) -> basic_euclidean_vector<double>;
+	template auto unit(basic_euclidean_vector<float>&&) -> basic_euclidean_vector<float>;
+	template auto unit(basic_euclidean_vector<double>&&) -> basic_euclidean_vector<double>;
+	template auto dot(basic_euclidean_vector<float> const&, basic_euclidean_vector<float> const&)
+	   -> double;
+	template auto dot(basic_euclidean_vector<double> const&, basic_euclidean_vector<double> const&)
+	   -> double;
+	template auto squared_distance(basic_euclidean_vector<float> const&,
+	                               basic_euclidean_vector<float> const&) -> double;
+	template auto squared_distance(basic_euclidean_vector<double> const&,
+	                               basic_euclidean_vector<double> const&) -> double;
+	template auto distance(basic_euclidean_vector<float> const&,
+	                       basic_euclidean_vector<float> const&) -> double;
+	template auto distance(basic_euclidean_vector<double> const&,
+	                       basic_euclidean_vector<double> const&) -> double;
+	template auto cosine_similarity(basic_euclidean_vector<float> const&,
+	                                basic_euclidean_vector<float> const&) -> double;
+	template auto cosine_similarity(basic_euclidean_vector<double> const&,
+	                                basic_euclidean_vector<double> const&) -> double;
+	template auto cosine_distance(basic_euclidean_vector<float> const&,
+	                              basic_euclidean_vector<float> const&) -> double;
+	template auto cosine_distance(basic_euclidean_vector<double> const&,
+	                              basic_euclidean_vector<double> const&) -> double;
+	template auto normalize(std::span<basic_euclidean_vector<float>>) -> void;
+	template auto normalize(std::span<basic_euclidean_vector<double>>) -> void;
+	template auto parse_vectors(std::string_view) -> std::vector<basic_euclidean_vector<float>>;
+	template auto parse_vectors(std::string_view) -> std::vector<basic_euclidean_vector<double>>;
+} // namespace comp6771
@@ -0,0 +1,288 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/kernels.hpp>
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <ranges>
+#include <string>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto doubles_per_line = euclidean_vector_batch::alignment / sizeof(double);
+
+		auto padded(std::size_t dimension) noexcept -> std::size_t {
+			return (dimension + doubles_per_line - 1) / doubles_per_line * doubles_per_line;
+		}
+	} // namespace
+
+	/*
+	 * Constructors
+	 */
+	euclidean_vector_batch::euclidean_vector_batch(int rows, int dimension)
+	: magnitude_{nullptr}
+	, rows_{static_cast<std::size_t>(rows)}
+	, dimension_{static_cast<std::size_t>(dimension)}
+	, stride_{padded(dimension_)}
+	, capacity_{rows_} {
+		magnitude_ = allocate(rows_, stride_);
+		std::fill_n(magnitude_.get(), rows_ * stride_, 0.0);
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(std::span<euclidean_vector const> vectors)
+	: euclidean_vector_batch(static_cast<int>(vectors.size()),
+	                         vectors.empty() ? 0 : vectors.front().dimensions()) {
+		for (auto row = std::size_t{0}; row < rows_; ++row) {
+			(*this)[static_cast<int>(row)] = vectors[row];
+		}
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch const& org)
+	: magnitude_{allocate(org.rows_, org.stride_)}
+	, rows_{org.rows_}
+	, dimension_{org.dimension_}
+	, stride_{org.stride_}
+	, capacity_{org.rows_} {
+		std::copy_n(org.magnitude_.get(), rows_ * stride_, magnitude_.get());
+	}
+
+	euclidean_vector_batch::euclidean_vector_batch(euclidean_vector_batch&& org) noexcept
+	: magnitude_{std::move(org.magnitude_)}
+	, rows_{org.rows_}
+	, dimension_{org.dimension_}
+	, stride_{org.stride_}
+	, capacity_{org.capacity_} {
+		org.rows_ = 0;
+		org.capacity_ = 0;
+	}
+
+	/*
+	 * Operator Overloads
+	 */
+	auto euclidean_vector_batch::operator=(euclidean_vector_batch const& org)
+	   -> euclidean_vector_batch& {
+		auto cp_batch = euclidean_vector_batch(org);
+		return *this = std::move(cp_batch);
+	}
+
+	auto euclidean_vector_batch::operator=(euclidean_vector_batch&& org) noexcept
+	   -> euclidean_vector_batch& {
+		if (this == &org) {
+			return *this;
+		}
+
+		magnitude_ = std::move(org.magnitude_);
+		rows_ = org.rows_;
+		dimension_ = org.dimension_;
+		stride_ = org.stride_;
+		capacity_ = org.capacity_;
+
+		// reset the moved-from batch
+		org.rows_ = 0;
+		org.capacity_ = 0;
+		return *this;
+	}
+
+	auto euclidean_vector_batch::operator[](int row) noexcept -> mutable_euclidean_vector_view {
+		assert(row >= 0 and row < rows());
+		auto* const first = magnitude_.get() + static_cast<std::size_t>(row) * stride_;
+		return mutable_euclidean_vector_view(first, dimensions());
+	}
+
+	auto euclidean_vector_batch::operator[](int row) const noexcept -> euclidean_vector_view {
+		assert(row >= 0 and row < rows());
+		auto const* const first = magnitude_.get() + static_cast<std::size_t>(row) * stride_;
+		return euclidean_vector_view(first, dimensions());
+	}
+
+	/*
+	 * Member Functions
+	 */
+	auto euclidean_vector_batch::at(int row) -> mutable_euclidean_vector_view {
+		throw_if_row_out_of_range(row);
+		return (*this)[row];
+	}
+
+	auto euclidean_vector_batch::at(int row) const -> euclidean_vector_view {
+		throw_if_row_out_of_range(row);
+		return (*this)[row];
+	}
+
+	auto euclidean_vector_batch::rows() const noexcept -> int {
+		return static_cast<int>(rows_);
+	}
+
+	auto euclidean_vector_batch::dimensions() const noexcept -> int {
+		return static_cast<int>(dimension_);
+	}
+
+	auto euclidean_vector_batch::stride() const noexcept -> std::size_t {
+		return stride_;
+	}
+
+	auto euclidean_vector_batch::push_back(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(v.dimensions()));
+		if (rows_ == capacity_) {
+			reserve(std::max(std::size_t{1}, capacity_ * 2));
+		}
+
+		auto* const row = magnitude_.get() + rows_ * stride_;
+		std::fill(row + dimension_, row + stride_, 0.0);
+		++rows_;
+		(*this)[static_cast<int>(rows_ - 1)] = v;
+	}
+
+	auto euclidean_vector_batch::resize(int rows) -> void {
+		auto const new_rows = static_cast<std::size_t>(rows);
+		if (new_rows > capacity_) {
+			reserve(new_rows);
+		}
+		if (new_rows > rows_) {
+			std::fill(magnitude_.get() + rows_ * stride_, magnitude_.get() + new_rows * stride_, 0.0);
+		}
+		rows_ = new_rows;
+	}
+
+	auto euclidean_vector_batch::reserve(std::size_t rows) -> void {
+		if (rows <= capacity_) {
+			return;
+		}
+		auto grown = allocate(rows, stride_);
+		if (magnitude_ != nullptr) {
+			std::copy_n(magnitude_.get(), rows_ * stride_, grown.get());
+		}
+		magnitude_ = std::move(grown);
+		capacity_ = rows;
+	}
+
+	/*
+	 * Bulk Operations
+	 */
+	auto euclidean_vector_batch::add_to_rows(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const& kernels = kernels::active();
+		auto const* const rhs = v.data();
+		for (auto row = std::size_t{0}; row < rows_; ++row) {
+			kernels.add(magnitude_.get() + row * stride_, rhs, dimension_);
+		}
+	}
+
+	auto euclidean_vector_batch::subtract_from_rows(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const& kernels = kernels::active();
+		auto const* const rhs = v.data();
+		for (auto row = std::size_t{0}; row < rows_; ++row) {
+			kernels.subtract(magnitude_.get() + row * stride_, rhs, dimension_);
+		}
+	}
+
+	auto euclidean_vector_batch::scale_rows(double factor) noexcept -> void {
+		auto const& kernels = kernels::active();
+		if (std::isfinite(factor)) {
+			// A finite factor keeps the zero padding at zero, so the whole buffer is one stream.
+			kernels.scale(magnitude_.get(), factor, rows_ * stride_);
+			return;
+		}
+
+		for (auto row = std::size_t{0}; row < rows_; ++row) {
+			kernels.scale(magnitude_.get() + row * stride_, factor, dimension_);
+		}
+	}
+
+	auto euclidean_vector_batch::norms() const -> std::vector<double> {
+		auto result = std::vector<double>(rows_);
+		norms(result);
+		return result;
+	}
+
+	auto euclidean_vector_batch::norms(std::span<double> out) const -> void {
+		if (out.size() != rows_) {
+			throw euclidean_vector_error("Output of size " + std::to_string(out.size())
+			                             + " cannot hold the norms of "
+			                             + std::to_string(rows_) + " rows");
+		}
+		auto const& kernels = kernels::active();
+		for (auto row = std::size_t{0}; row < rows_; ++row) {
+			// The padding is zero, so summing the whole padded row lets the kernel skip its tail loop.
+			out[row] = std::sqrt(kernels.sum_of_squares(magnitude_.get() + row * stride_, stride_));
+		}
+	}
+
+	auto euclidean_vector_batch::normalize_rows() -> void {
+		if (rows_ == 0) {
+			return;
+		}
+		euclidean_vector::throw_if_dimension_is_zero(dimensions());
+
+		auto const& kernels = kernels::active();
+		auto zero_norm = std::atomic<bool>(false);
+		auto const normalize_range = [&](std::size_t first, std::size_t last) {
+			for (auto row = first; row < last; ++row) {
+				// The second pass over the row finds it still in cache.
+				auto* const magnitudes = magnitude_.get() + row * stride_;
+				auto const e_norm = std::sqrt(kernels.sum_of_squares(magnitudes, stride_));
+				if (e_norm == 0) {
+					zero_norm.store(true, std::memory_order_relaxed);
+				}
+				else if (auto const reciprocal = 1.0 / e_norm; std::isfinite(reciprocal)) {
+					// the padding stays zero, so the whole padded row is one stream
+					kernels.scale(magnitudes, reciprocal, stride_);
+				}
+				else {
+					kernels.divide(magnitudes, e_norm, stride_);
+				}
+			}
+		};
+
+		detail::parallel_for(rows_, detail::elements_per_thread / stride_, normalize_range);
+		if (zero_norm) {
+			euclidean_vector::throw_if_norm_is_zero(0);
+		}
+	}
+
+	/*
+	 * Helper Functions
+	 */
+	auto euclidean_vector_batch::aligned_delete::operator()(double* p) const noexcept -> void {
+		::operator delete[](p, std::align_val_t{alignment});
+	}
+
+	auto euclidean_vector_batch::allocate(std::size_t rows, std::size_t stride) -> storage {
+		if (rows == 0 or stride == 0) {
+			return storage(nullptr);
+		}
+		// rows * stride * sizeof(double) must not wrap, or a tiny buffer would be handed out
+		if (rows > std::numeric_limits<std::size_t>::max() / sizeof(double) / stride) {
+			throw std::bad_array_new_length();
+		}
+		return storage(static_cast<double*>(
+		   ::operator new[](rows * stride * sizeof(double), std::align_val_t{alignment})));
+	}
+
+	auto euclidean_vector_batch::throw_if_row_out_of_range(int row) const -> void {
+		if (row < 0 or row >= rows()) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " is not valid for this euclidean_vector_batch object");
+		}
+	}
+
+	/*
+	 * Text Output
+	 */
+	auto write_vectors(std::ostream& os, euclidean_vector_batch const& batch) -> std::ostream& {
+		auto const rows = std::views::iota(0, batch.rows())
+		                  | std::views::transform([&batch](int row) { return batch[row]; });
+		return write_vectors(os, rows);
+	}
+} // namespace comp6771
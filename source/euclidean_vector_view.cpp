@@ -0,0 +1,28 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/euclidean_vector_view.hpp>
+
+namespace comp6771 {
+	/*
+	 * Utility functions
+	 */
+	auto unit(euclidean_vector_view v, mutable_euclidean_vector_view out) -> void {
+		euclidean_vector::throw_if_dimension_is_zero(v.dimensions());
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(out.dimensions()),
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const e_norm = euclidean_norm(v);
+		euclidean_vector::throw_if_norm_is_zero(e_norm);
+		out = v;
+		out /= e_norm;
+	}
+
+	auto unit(euclidean_vector_view v, euclidean_vector& out) -> void {
+		euclidean_vector::throw_if_dimension_is_zero(v.dimensions());
+		auto const e_norm = euclidean_norm(v);
+		euclidean_vector::throw_if_norm_is_zero(e_norm);
+		out = v;
+		out /= e_norm;
+	}
+} // namespace comp6771
@@ -0,0 +1,515 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/hnsw_index.hpp>
+#include <comp6771/kernels.hpp>
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+	// Visited sets for search_layer(). Marking a node stores the current tag, so starting a new
+	// search only bumps the tag instead of clearing a size() array. The lists are pooled so
+	// concurrent searches each get their own without allocating one per call.
+	class hnsw_index::visited_pool {
+	public:
+		struct visited_list {
+			std::vector<std::uint32_t> marks;
+			std::uint32_t tag = 0;
+		};
+
+		class lease {
+		public:
+			lease(visited_pool& pool, std::size_t size)
+			: pool_{pool}
+			, list_{pool.take()} {
+				if (++list_->tag == 0) {
+					std::fill(list_->marks.begin(), list_->marks.end(), 0);
+					list_->tag = 1;
+				}
+				if (list_->marks.size() < size) {
+					list_->marks.resize(size, 0);
+				}
+			}
+
+			lease(lease const&) = delete;
+			auto operator=(lease const&) -> lease& = delete;
+
+			~lease() noexcept {
+				pool_.give_back(std::move(list_));
+			}
+
+			// Returns false when the node was already visited
+			auto insert(int id) noexcept -> bool {
+				auto& mark = list_->marks[static_cast<std::size_t>(id)];
+				if (mark == list_->tag) {
+					return false;
+				}
+				mark = list_->tag;
+				return true;
+			}
+
+		private:
+			visited_pool& pool_;
+			std::unique_ptr<visited_list> list_;
+		};
+
+	private:
+		auto take() -> std::unique_ptr<visited_list> {
+			auto const lock = std::scoped_lock(mutex_);
+			if (free_.empty()) {
+				return std::make_unique<visited_list>();
+			}
+			auto list = std::move(free_.back());
+			free_.pop_back();
+			return list;
+		}
+
+		auto give_back(std::unique_ptr<visited_list> list) noexcept -> void {
+			auto const lock = std::scoped_lock(mutex_);
+			try {
+				free_.push_back(std::move(list));
+			} catch (...) {
+				// the list is simply freed; the next search allocates a new one
+			}
+		}
+
+		std::mutex mutex_;
+		std::vector<std::unique_ptr<visited_list>> free_;
+	};
+
+	namespace {
+		// Locks a node's links during a parallel build, and does nothing otherwise.
+		auto lock_node(std::mutex* node_locks, int node) -> std::unique_lock<std::mutex> {
+			if (node_locks == nullptr) {
+				return std::unique_lock<std::mutex>();
+			}
+			return std::unique_lock<std::mutex>(node_locks[node]);
+		}
+
+		// Queries per thread in a batched search; each one is thousands of distance computations.
+		constexpr auto queries_per_thread = std::size_t{16};
+	} // namespace
+
+	/*
+	 * Constructors
+	 */
+	hnsw_index::hnsw_index(int dimension, metric m, parameters tuning)
+	: database_(0, dimension)
+	, metric_{m}
+	, parameters_{tuning}
+	, max_m0_{0}
+	, level_multiplier_{0}
+	, engine_{tuning.seed}
+	, entry_point_{-1}
+	, max_level_{0}
+	, entry_mutex_{std::make_unique<std::mutex>()}
+	, visited_{std::make_unique<visited_pool>()} {
+		throw_if_parameters_are_invalid(tuning);
+		max_m0_ = 2 * static_cast<std::size_t>(tuning.m);
+		level_multiplier_ = 1.0 / std::log(static_cast<double>(tuning.m));
+	}
+
+	hnsw_index::hnsw_index(euclidean_vector_batch database, metric m, parameters tuning)
+	: hnsw_index(database.dimensions(), m, tuning) {
+		database_ = std::move(database);
+		auto const rows = database_.rows();
+		norms_.reserve(static_cast<std::size_t>(rows));
+		for (auto row = 0; row < rows; ++row) {
+			norms_.push_back(query_norm(database_[row].data()));
+		}
+		// Levels are drawn up front so the graph's shape doesn't depend on the thread schedule.
+		for (auto row = 0; row < rows; ++row) {
+			reserve_node(random_level());
+		}
+		if (rows == 0) {
+			return;
+		}
+
+		insert(0, nullptr);
+		auto const node_locks = std::make_unique<std::mutex[]>(static_cast<std::size_t>(rows));
+		auto const dimension = static_cast<std::size_t>(std::max(dimensions(), 1));
+		auto const grain = detail::elements_per_thread
+		                   / (dimension * static_cast<std::size_t>(tuning.ef_construction));
+		detail::parallel_for(static_cast<std::size_t>(rows - 1),
+		                     grain,
+		                     [&](std::size_t first, std::size_t last) {
+			                     for (auto i = first; i < last; ++i) {
+				                     insert(static_cast<int>(i + 1), node_locks.get());
+			                     }
+		                     });
+	}
+
+	hnsw_index::hnsw_index(std::span<euclidean_vector const> vectors, metric m, parameters tuning)
+	: hnsw_index(euclidean_vector_batch(vectors), m, tuning) {}
+
+	hnsw_index::hnsw_index(hnsw_index&&) noexcept = default;
+
+	hnsw_index::~hnsw_index() noexcept = default;
+
+	/*
+	 * Operator Overloads
+	 */
+	auto hnsw_index::operator=(hnsw_index&&) noexcept -> hnsw_index& = default;
+
+	/*
+	 * Member Functions
+	 */
+	auto hnsw_index::size() const noexcept -> int {
+		return database_.rows();
+	}
+
+	auto hnsw_index::dimensions() const noexcept -> int {
+		return database_.dimensions();
+	}
+
+	auto hnsw_index::distance_metric() const noexcept -> metric {
+		return metric_;
+	}
+
+	auto hnsw_index::tuning() const noexcept -> parameters const& {
+		return parameters_;
+	}
+
+	auto hnsw_index::database() const noexcept -> euclidean_vector_batch const& {
+		return database_;
+	}
+
+	auto hnsw_index::max_level() const noexcept -> int {
+		return max_level_;
+	}
+
+	auto hnsw_index::neighbours(int id, int level) const -> std::span<int const> {
+		if (id < 0 or id >= size()) {
+			throw euclidean_vector_error("Node " + std::to_string(id)
+			                             + " is not valid for this hnsw_index object");
+		}
+		if (level < 0 or level > levels_[static_cast<std::size_t>(id)]) {
+			return {};
+		}
+		auto const* const slots = links(id, level);
+		return std::span<int const>(slots + 1, static_cast<std::size_t>(slots[0]));
+	}
+
+	auto hnsw_index::set_ef_search(int ef_search) -> void {
+		auto tuning = parameters_;
+		tuning.ef_search = ef_search;
+		throw_if_parameters_are_invalid(tuning);
+		parameters_ = tuning;
+	}
+
+	auto hnsw_index::add(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const norm = query_norm(v.data());
+		database_.push_back(v);
+		norms_.push_back(norm);
+		reserve_node(random_level());
+		insert(size() - 1, nullptr);
+	}
+
+	auto hnsw_index::search(euclidean_vector const& query, int k) const -> std::vector<neighbour> {
+		return search(euclidean_vector_view(query), k);
+	}
+
+	auto hnsw_index::search(euclidean_vector_view query, int k) const -> std::vector<neighbour> {
+		brute_force_index::throw_if_k_is_negative(k);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(query.dimensions()));
+		auto const norm = query_norm(query.data());
+		if (size() == 0 or k == 0) {
+			return {};
+		}
+
+		auto nearest = candidate{key(query.data(), norm, entry_point_), entry_point_};
+		for (auto level = max_level_; level > 0; --level) {
+			nearest = greedy(query.data(), norm, nearest, level, nullptr);
+		}
+		auto const ef = static_cast<std::size_t>(std::max(parameters_.ef_search, k));
+		auto const found = search_layer(query.data(), norm, nearest, ef, 0, nullptr);
+
+		auto result = std::vector<neighbour>();
+		result.reserve(std::min(found.size(), static_cast<std::size_t>(k)));
+		for (auto const& [found_key, id] : found) {
+			if (result.size() == static_cast<std::size_t>(k)) {
+				break;
+			}
+			switch (metric_) {
+			case metric::l2: result.push_back({id, std::sqrt(found_key)}); break;
+			case metric::inner_product: result.push_back({id, -found_key}); break;
+			case metric::cosine: result.push_back({id, std::clamp(-found_key, -1.0, 1.0)}); break;
+			}
+		}
+		return result;
+	}
+
+	auto hnsw_index::search(euclidean_vector_batch const& queries, int k) const
+	   -> std::vector<std::vector<neighbour>> {
+		brute_force_index::throw_if_k_is_negative(k);
+		auto const dimension = static_cast<std::size_t>(queries.dimensions());
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               dimension);
+		auto results = std::vector<std::vector<neighbour>>(static_cast<std::size_t>(queries.rows()));
+		detail::parallel_for(results.size(),
+		                     queries_per_thread,
+		                     [&](std::size_t first, std::size_t last) {
+			                     for (auto row = first; row < last; ++row) {
+				                     results[row] = search(queries[static_cast<int>(row)], k);
+			                     }
+		                     });
+		return results;
+	}
+
+	/*
+	 * Helper Functions
+	 */
+	auto hnsw_index::throw_if_parameters_are_invalid(parameters const& tuning) -> void {
+		if (tuning.m < 2) {
+			throw euclidean_vector_error("hnsw_index needs m of at least 2, not "
+			                             + std::to_string(tuning.m));
+		}
+		if (tuning.ef_construction < 1) {
+			throw euclidean_vector_error("hnsw_index needs ef_construction of at least 1, not "
+			                             + std::to_string(tuning.ef_construction));
+		}
+		if (tuning.ef_search < 1) {
+			throw euclidean_vector_error("hnsw_index needs ef_search of at least 1, not "
+			                             + std::to_string(tuning.ef_search));
+		}
+	}
+
+	auto hnsw_index::query_norm(double const* magnitude) const -> double {
+		if (metric_ != metric::cosine) {
+			return 0;
+		}
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		auto const e_norm = std::sqrt(kernels::active().sum_of_squares(magnitude, dimension));
+		euclidean_vector::throw_if_cosine_is_undefined(e_norm, e_norm);
+		return 1.0 / e_norm;
+	}
+
+	auto hnsw_index::key(double const* query, double norm, int node) const noexcept -> double {
+		auto const& kernels = kernels::active();
+		auto const* const x = database_[node].data();
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		switch (metric_) {
+		case metric::l2: return kernels.squared_distance(query, x, dimension);
+		case metric::inner_product: return -kernels.dot(query, x, dimension);
+		case metric::cosine:
+			return -kernels.dot(query, x, dimension) * norm * norms_[static_cast<std::size_t>(node)];
+		}
+		return 0;
+	}
+
+	auto hnsw_index::links(int node, int level) noexcept -> int* {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		return const_cast<int*>(std::as_const(*this).links(node, level));
+	}
+
+	auto hnsw_index::links(int node, int level) const noexcept -> int const* {
+		if (level == 0) {
+			return links0_.data() + static_cast<std::size_t>(node) * (max_m0_ + 1);
+		}
+		auto const m = static_cast<std::size_t>(parameters_.m);
+		return upper_links_[static_cast<std::size_t>(node)].data()
+		       + static_cast<std::size_t>(level - 1) * (m + 1);
+	}
+
+	auto hnsw_index::random_level() -> int {
+		auto const u = std::uniform_real_distribution<double>(0.0, 1.0)(engine_);
+		return static_cast<int>(-std::log(1.0 - u) * level_multiplier_);
+	}
+
+	auto hnsw_index::reserve_node(int level) -> void {
+		auto const m = static_cast<std::size_t>(parameters_.m);
+		levels_.push_back(level);
+		links0_.resize(links0_.size() + max_m0_ + 1, 0);
+		upper_links_.emplace_back(static_cast<std::size_t>(level) * (m + 1), 0);
+	}
+
+	// Links `node`, whose row and level are already stored, into every layer up to its level. With
+	// node_locks this runs concurrently with other inserts.
+	auto hnsw_index::insert(int node, std::mutex* node_locks) -> void {
+		auto const level = levels_[static_cast<std::size_t>(node)];
+		auto entry_lock = std::unique_lock<std::mutex>(*entry_mutex_);
+		if (entry_point_ < 0) {
+			entry_point_ = node;
+			max_level_ = level;
+			return;
+		}
+		auto const entry = entry_point_;
+		auto const top = max_level_;
+		// A node that will become the new entry point keeps other inserts out until it is linked.
+		if (level <= top) {
+			entry_lock.unlock();
+		}
+
+		auto const* const query = database_[node].data();
+		auto const norm = norms_[static_cast<std::size_t>(node)];
+		auto nearest = candidate{key(query, norm, entry), entry};
+		for (auto lc = top; lc > level; --lc) {
+			nearest = greedy(query, norm, nearest, lc, node_locks);
+		}
+
+		for (auto lc = std::min(level, top); lc >= 0; --lc) {
+			auto const found = search_layer(query,
+			                                norm,
+			                                nearest,
+			                                static_cast<std::size_t>(parameters_.ef_construction),
+			                                lc,
+			                                node_locks);
+			auto const chosen = select_neighbours(found, static_cast<std::size_t>(parameters_.m));
+			{
+				auto const lock = lock_node(node_locks, node);
+				auto* const slots = links(node, lc);
+				slots[0] = static_cast<int>(chosen.size());
+				std::copy(chosen.begin(), chosen.end(), slots + 1);
+			}
+			for (auto const id : chosen) {
+				connect(id, node, lc, node_locks);
+			}
+			nearest = found.front();
+		}
+
+		if (level > top) {
+			entry_point_ = node;
+			max_level_ = level;
+		}
+	}
+
+	// Walks to the nearest neighbour on `level` until no neighbour is nearer than the current node
+	auto hnsw_index::greedy(double const* query,
+	                        double norm,
+	                        candidate entry,
+	                        int level,
+	                        std::mutex* node_locks) const -> candidate {
+		auto nearest = entry;
+		auto adjacent = std::vector<int>();
+		for (auto improved = true; improved;) {
+			improved = false;
+			{
+				auto const lock = lock_node(node_locks, nearest.second);
+				auto const* const slots = links(nearest.second, level);
+				adjacent.assign(slots + 1, slots + 1 + slots[0]);
+			}
+			for (auto const id : adjacent) {
+				auto const next = candidate{key(query, norm, id), id};
+				if (next < nearest) {
+					nearest = next;
+					improved = true;
+				}
+			}
+		}
+		return nearest;
+	}
+
+	// Best-first search of one layer from `entry`, keeping the ef nearest nodes found. Returns them
+	// nearest first.
+	auto hnsw_index::search_layer(double const* query,
+	                              double norm,
+	                              candidate entry,
+	                              std::size_t ef,
+	                              int level,
+	                              std::mutex* node_locks) const -> std::vector<candidate> {
+		auto visited = visited_pool::lease(*visited_, static_cast<std::size_t>(size()));
+		auto candidates =
+		   std::priority_queue<candidate, std::vector<candidate>, std::greater<>>(); // nearest on top
+		auto nearest = std::priority_queue<candidate>(); // furthest on top
+		visited.insert(entry.second);
+		candidates.push(entry);
+		nearest.push(entry);
+
+		auto adjacent = std::vector<int>();
+		while (not candidates.empty()) {
+			auto const current = candidates.top();
+			if (current.first > nearest.top().first and nearest.size() >= ef) {
+				break;
+			}
+			candidates.pop();
+
+			{
+				auto const lock = lock_node(node_locks, current.second);
+				auto const* const slots = links(current.second, level);
+				adjacent.assign(slots + 1, slots + 1 + slots[0]);
+			}
+			for (auto const id : adjacent) {
+				if (not visited.insert(id)) {
+					continue;
+				}
+				auto const next = candidate{key(query, norm, id), id};
+				if (nearest.size() < ef or next < nearest.top()) {
+					candidates.push(next);
+					nearest.push(next);
+					if (nearest.size() > ef) {
+						nearest.pop();
+					}
+				}
+			}
+		}
+
+		auto result = std::vector<candidate>(nearest.size());
+		for (auto i = result.size(); i > 0; --i) {
+			result[i - 1] = nearest.top();
+			nearest.pop();
+		}
+		return result;
+	}
+
+	// The neighbour-selection heuristic: a candidate is kept only if it is nearer to the new node
+	// than to every candidate already kept. This spreads the links in different directions rather
+	// than clustering them, which keeps the graph navigable between clusters.
+	auto hnsw_index::select_neighbours(std::vector<candidate> const& nearest, std::size_t m) const
+	   -> std::vector<int> {
+		auto chosen = std::vector<int>();
+		chosen.reserve(m);
+		for (auto const& [distance, id] : nearest) {
+			if (chosen.size() == m) {
+				break;
+			}
+			auto const* const row = database_[id].data();
+			auto const norm = norms_[static_cast<std::size_t>(id)];
+			auto const diverse = std::none_of(chosen.begin(), chosen.end(), [&](int kept) {
+				return key(row, norm, kept) < distance;
+			});
+			if (diverse) {
+				chosen.push_back(id);
+			}
+		}
+		return chosen;
+	}
+
+	// Adds the link node -> neighbour on `level`, pruning node's links with the heuristic when they
+	// are full.
+	auto hnsw_index::connect(int node, int neighbour, int level, std::mutex* node_locks) -> void {
+		auto const max_links = level == 0 ? max_m0_ : static_cast<std::size_t>(parameters_.m);
+		auto const lock = lock_node(node_locks, node);
+		auto* const slots = links(node, level);
+		auto const count = static_cast<std::size_t>(slots[0]);
+		if (count < max_links) {
+			slots[count + 1] = neighbour;
+			++slots[0];
+			return;
+		}
+
+		auto const* const row = database_[node].data();
+		auto const norm = norms_[static_cast<std::size_t>(node)];
+		auto candidates = std::vector<candidate>();
+		candidates.reserve(count + 1);
+		candidates.emplace_back(key(row, norm, neighbour), neighbour);
+		for (auto i = std::size_t{1}; i <= count; ++i) {
+			candidates.emplace_back(key(row, norm, slots[i]), slots[i]);
+		}
+		std::sort(candidates.begin(), candidates.end());
+		auto const kept = select_neighbours(candidates, max_links);
+		slots[0] = static_cast<int>(kept.size());
+		std::copy(kept.begin(), kept.end(), slots + 1);
+	}
+} // namespace comp6771
@@ -0,0 +1,339 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/ivf_index.hpp>
+#include <comp6771/kernels.hpp>
+
+#include "parallel.hpp"
+#include "top_k.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <ranges>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		auto copy_row(euclidean_vector_view from, mutable_euclidean_vector_view to) noexcept -> void {
+			std::copy_n(from.data(), from.dimensions(), to.data());
+		}
+	} // namespace
+
+	/*
+	 * Constructors
+	 */
+	ivf_index::ivf_index(euclidean_vector_batch const& database, metric m, parameters tuning)
+	: metric_{m}
+	, parameters_{tuning}
+	, centroids_(0, database.dimensions())
+	, size_{database.rows()} {
+		throw_if_parameters_are_invalid(tuning);
+		throw_if_too_few_rows(database.rows(), tuning.lists);
+		auto norms = std::vector<double>();
+		norms.reserve(static_cast<std::size_t>(size_));
+		for (auto row = 0; row < size_; ++row) {
+			norms.push_back(row_norm(database[row].data()));
+		}
+
+		train(database);
+		auto const assignment = assign(database);
+		auto counts = std::vector<int>(static_cast<std::size_t>(tuning.lists), 0);
+		for (auto const list : assignment) {
+			++counts[static_cast<std::size_t>(list)];
+		}
+		lists_.reserve(counts.size());
+		for (auto const count : counts) {
+			auto& list = lists_.emplace_back(
+			   inverted_list{euclidean_vector_batch(count, dimensions()), {}, {}});
+			list.ids.reserve(static_cast<std::size_t>(count));
+			list.norms.reserve(static_cast<std::size_t>(count));
+		}
+		for (auto row = 0; row < size_; ++row) {
+			auto& list = lists_[static_cast<std::size_t>(assignment[static_cast<std::size_t>(row)])];
+			copy_row(database[row], list.rows[static_cast<int>(list.ids.size())]);
+			list.ids.push_back(row);
+			list.norms.push_back(norms[static_cast<std::size_t>(row)]);
+		}
+	}
+
+	ivf_index::ivf_index(std::span<euclidean_vector const> vectors, metric m, parameters tuning)
+	: ivf_index(euclidean_vector_batch(vectors), m, tuning) {}
+
+	/*
+	 * Member Functions
+	 */
+	auto ivf_index::size() const noexcept -> int {
+		return size_;
+	}
+
+	auto ivf_index::dimensions() const noexcept -> int {
+		return centroids_.dimensions();
+	}
+
+	auto ivf_index::distance_metric() const noexcept -> metric {
+		return metric_;
+	}
+
+	auto ivf_index::tuning() const noexcept -> parameters const& {
+		return parameters_;
+	}
+
+	auto ivf_index::centroids() const noexcept -> euclidean_vector_batch const& {
+		return centroids_;
+	}
+
+	auto ivf_index::list(int list) const -> std::span<int const> {
+		if (list < 0 or list >= centroids_.rows()) {
+			throw euclidean_vector_error("List " + std::to_string(list)
+			                             + " is not valid for this ivf_index object");
+		}
+		return lists_[static_cast<std::size_t>(list)].ids;
+	}
+
+	auto ivf_index::set_nprobe(int nprobe) -> void {
+		auto tuning = parameters_;
+		tuning.nprobe = nprobe;
+		throw_if_parameters_are_invalid(tuning);
+		parameters_ = tuning;
+	}
+
+	auto ivf_index::add(euclidean_vector const& v) -> void {
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(v.dimensions()));
+		auto const norm = row_norm(v.data());
+		auto& list = lists_[static_cast<std::size_t>(nearest_list(v.data()))];
+		list.ids.reserve(list.ids.size() + 1);
+		list.norms.reserve(list.norms.size() + 1);
+		list.rows.push_back(v);
+		list.ids.push_back(size_);
+		list.norms.push_back(norm);
+		++size_;
+	}
+
+	auto ivf_index::search(euclidean_vector const& query, int k) const -> std::vector<neighbour> {
+		return search(euclidean_vector_view(query), k);
+	}
+
+	auto ivf_index::search(euclidean_vector_view query, int k) const -> std::vector<neighbour> {
+		brute_force_index::throw_if_k_is_negative(k);
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               static_cast<std::size_t>(query.dimensions()));
+		auto const norm = row_norm(query.data());
+		auto const wanted = std::min(k, size_);
+		if (wanted == 0) {
+			return {};
+		}
+
+		auto ranked = std::vector<std::pair<double, int>>();
+		ranked.reserve(lists_.size());
+		for (auto list = 0; list < centroids_.rows(); ++list) {
+			ranked.emplace_back(coarse_key(query.data(), list), list);
+		}
+		auto const probes = std::min(ranked.size(), static_cast<std::size_t>(parameters_.nprobe));
+		std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(probes),
+		                  ranked.end());
+
+		auto const& kernels = kernels::active();
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		auto best = detail::top_k(static_cast<std::size_t>(wanted));
+		for (auto probe = std::size_t{0}; probe < probes; ++probe) {
+			auto const& list = lists_[static_cast<std::size_t>(ranked[probe].second)];
+			for (auto row = 0; row < list.rows.rows(); ++row) {
+				auto const* const x = list.rows[row].data();
+				auto const r = static_cast<std::size_t>(row);
+				switch (metric_) {
+				case metric::l2:
+					best.push(kernels.squared_distance(query.data(), x, dimension), list.ids[r]);
+					break;
+				case metric::inner_product:
+					best.push(-kernels.dot(query.data(), x, dimension), list.ids[r]);
+					break;
+				case metric::cosine:
+					best.push(-kernels.dot(query.data(), x, dimension) * norm * list.norms[r],
+					          list.ids[r]);
+					break;
+				}
+			}
+		}
+
+		auto result = std::move(best).sorted();
+		for (auto& found : result) {
+			switch (metric_) {
+			case metric::l2: found.score = std::sqrt(found.score); break;
+			case metric::inner_product: found.score = -found.score; break;
+			case metric::cosine: found.score = std::clamp(-found.score, -1.0, 1.0); break;
+			}
+		}
+		return result;
+	}
+
+	auto ivf_index::search(euclidean_vector_batch const& queries, int k) const
+	   -> std::vector<std::vector<neighbour>> {
+		brute_force_index::throw_if_k_is_negative(k);
+		auto const dimension = static_cast<std::size_t>(queries.dimensions());
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimensions()),
+		                                               dimension);
+		// A query ranks every centroid, then scans about nprobe / lists of the rows.
+		auto const lists = lists_.size();
+		auto const probes = std::min(lists, static_cast<std::size_t>(parameters_.nprobe));
+		auto const scanned = static_cast<std::size_t>(size_) * probes / lists;
+		auto const work_per_query = std::max((lists + scanned) * dimension, std::size_t{1});
+
+		auto results = std::vector<std::vector<neighbour>>(static_cast<std::size_t>(queries.rows()));
+		detail::parallel_for(results.size(),
+		                     detail::elements_per_thread / work_per_query,
+		                     [&](std::size_t first, std::size_t last) {
+			                     for (auto row = first; row < last; ++row) {
+				                     results[row] = search(queries[static_cast<int>(row)], k);
+			                     }
+		                     });
+		return results;
+	}
+
+	/*
+	 * Helper Functions
+	 */
+	auto ivf_index::throw_if_parameters_are_invalid(parameters const& tuning) -> void {
+		auto const check = [](int value, int minimum, char const* name) {
+			if (value < minimum) {
+				throw euclidean_vector_error("ivf_index needs " + std::string(name) + " of at least "
+				                             + std::to_string(minimum) + ", not "
+				                             + std::to_string(value));
+			}
+		};
+		check(tuning.lists, 1, "lists");
+		check(tuning.nprobe, 1, "nprobe");
+		check(tuning.samples_per_list, 1, "samples_per_list");
+		check(tuning.iterations, 0, "iterations");
+	}
+
+	auto ivf_index::throw_if_too_few_rows(int rows, int lists) -> void {
+		if (rows < lists) {
+			throw euclidean_vector_error("ivf_index needs at least " + std::to_string(lists)
+			                             + " rows to train " + std::to_string(lists)
+			                             + " lists, not " + std::to_string(rows));
+		}
+	}
+
+	auto ivf_index::row_norm(double const* magnitude) const -> double {
+		if (metric_ != metric::cosine) {
+			return 0;
+		}
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		auto const e_norm = std::sqrt(kernels::active().sum_of_squares(magnitude, dimension));
+		euclidean_vector::throw_if_cosine_is_undefined(e_norm, e_norm);
+		return 1.0 / e_norm;
+	}
+
+	// Smaller is nearer. The cosine centroids have unit length, so the dot product alone ranks them
+	// by cosine similarity, whatever the query's length.
+	auto ivf_index::coarse_key(double const* magnitude, int list) const noexcept -> double {
+		auto const& kernels = kernels::active();
+		auto const* const c = centroids_[list].data();
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		if (metric_ == metric::cosine) {
+			return -kernels.dot(magnitude, c, dimension);
+		}
+		return kernels.squared_distance(magnitude, c, dimension);
+	}
+
+	auto ivf_index::nearest_list(double const* magnitude) const noexcept -> int {
+		auto nearest = 0;
+		auto nearest_key = coarse_key(magnitude, 0);
+		for (auto list = 1; list < centroids_.rows(); ++list) {
+			auto const key = coarse_key(magnitude, list);
+			if (key < nearest_key) {
+				nearest = list;
+				nearest_key = key;
+			}
+		}
+		return nearest;
+	}
+
+	// The nearest centroid of every row, spread across the hardware threads
+	auto ivf_index::assign(euclidean_vector_batch const& rows) const -> std::vector<int> {
+		auto assignment = std::vector<int>(static_cast<std::size_t>(rows.rows()));
+		auto const work_per_row = std::max(
+		   static_cast<std::size_t>(centroids_.rows()) * static_cast<std::size_t>(dimensions()),
+		   std::size_t{1});
+		detail::parallel_for(assignment.size(),
+		                     detail::elements_per_thread / work_per_row,
+		                     [&](std::size_t first, std::size_t last) {
+			                     for (auto row = first; row < last; ++row) {
+				                     assignment[row] = nearest_list(rows[static_cast<int>(row)].data());
+			                     }
+		                     });
+		return assignment;
+	}
+
+	// Lloyd's k-means on a random sample of at most lists * samples_per_list rows, starting from
+	// randomly chosen sample rows. The cosine metric clusters the normalised rows and keeps the
+	// centroids at unit length (spherical k-means). A centroid left without rows is moved to a
+	// random sample row.
+	auto ivf_index::train(euclidean_vector_batch const& database) -> void {
+		auto engine = std::mt19937_64(parameters_.seed);
+		auto const lists = static_cast<std::size_t>(parameters_.lists);
+		auto const samples = std::min(static_cast<std::size_t>(database.rows()),
+		                              lists * static_cast<std::size_t>(parameters_.samples_per_list));
+		auto chosen = std::vector<int>(samples);
+		std::ranges::sample(std::views::iota(0, database.rows()),
+		                    chosen.begin(),
+		                    static_cast<std::ptrdiff_t>(samples),
+		                    engine);
+		std::ranges::shuffle(chosen, engine);
+
+		auto sample = euclidean_vector_batch(static_cast<int>(samples), dimensions());
+		for (auto row = std::size_t{0}; row < samples; ++row) {
+			copy_row(database[chosen[row]], sample[static_cast<int>(row)]);
+		}
+		if (metric_ == metric::cosine) {
+			sample.normalize_rows();
+		}
+
+		centroids_ = euclidean_vector_batch(static_cast<int>(lists), dimensions());
+		for (auto list = 0; list < centroids_.rows(); ++list) {
+			copy_row(sample[list], centroids_[list]);
+		}
+
+		auto const& kernels = kernels::active();
+		auto const dimension = static_cast<std::size_t>(dimensions());
+		auto pick = std::uniform_int_distribution<int>(0, sample.rows() - 1);
+		auto assignment = std::vector<int>();
+		auto counts = std::vector<int>(lists);
+		for (auto iteration = 0; iteration < parameters_.iterations; ++iteration) {
+			auto next = assign(sample);
+			if (next == assignment) {
+				break;
+			}
+			assignment = std::move(next);
+
+			std::fill(counts.begin(), counts.end(), 0);
+			std::fill(centroids_[0].data(), centroids_[0].data() + lists * centroids_.stride(), 0.0);
+			for (auto row = 0; row < sample.rows(); ++row) {
+				auto const list = assignment[static_cast<std::size_t>(row)];
+				kernels.add(centroids_[list].data(), sample[row].data(), dimension);
+				++counts[static_cast<std::size_t>(list)];
+			}
+			for (auto list = 0; list < centroids_.rows(); ++list) {
+				auto* const c = centroids_[list].data();
+				auto const count = counts[static_cast<std::size_t>(list)];
+				if (count == 0) {
+					copy_row(sample[pick(engine)], centroids_[list]);
+					continue;
+				}
+				if (metric_ == metric::cosine) {
+					auto const e_norm = std::sqrt(kernels.sum_of_squares(c, dimension));
+					if (e_norm > 0) {
+						kernels.divide(c, e_norm, dimension);
+					}
+				}
+				else {
+					kernels.divide(c, static_cast<double>(count), dimension);
+				}
+			}
+		}
+	}
+} // namespace comp6771
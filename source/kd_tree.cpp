@@ -0,0 +1,383 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/kd_tree.hpp>
+
+#include "parallel.hpp"
+#include "top_k.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		// Points examined when choosing a split
+		constexpr auto split_sample = 64;
+	} // namespace
+
+	// Builds the node array over a permutation of the caller's points, which are kept in their
+	// original order until the tree is finished and then gathered into tree order once.
+	class kd_tree::builder {
+	public:
+		builder(std::span<euclidean_vector const> points, std::size_t dimension, int leaf_size)
+		: dimension_{dimension}
+		, leaf_size_{leaf_size}
+		, order_(points.size()) {
+			source_.reserve(points.size() * dimension_);
+			for (auto const& p : points) {
+				euclidean_vector::throw_if_dimension_not_equal(
+				   dimension_,
+				   static_cast<std::size_t>(p.dimensions()));
+				source_.insert(source_.end(), p.data(), p.data() + p.dimensions());
+			}
+			std::iota(order_.begin(), order_.end(), 0);
+		}
+
+		// Appends the subtree over order_[first, last) to `out` in pre-order. `spare_threads` more
+		// threads may be started for its subtrees.
+		auto build(int first, int last, std::vector<node>& out, unsigned spare_threads) -> void {
+			auto const index = out.size();
+			out.push_back(node{0.0, -1, first, last, -1});
+			if (last - first <= leaf_size_) {
+				return;
+			}
+
+			auto const [axis, split, middle] = partition(first, last);
+			if (axis < 0) {
+				return; // every point is the same, so there is nothing to split on
+			}
+			out[index].axis = axis;
+			out[index].split = split;
+
+			auto const elements = static_cast<std::size_t>(last - first) * dimension_;
+			if (spare_threads == 0 or elements < detail::elements_per_thread) {
+				build(first, middle, out, 0);
+				out[index].upper = static_cast<int>(out.size());
+				build(middle, last, out, 0);
+				return;
+			}
+
+			// One side runs on a new thread; the rest of the budget is shared between the sides.
+			auto halves = std::array<std::vector<node>, 2>();
+			auto const child_threads = (spare_threads - 1) / 2;
+			detail::parallel_for(2, 1, [&](std::size_t begin, std::size_t end) {
+				for (auto side = begin; side < end; ++side) {
+					if (side == 0) {
+						build(first, middle, halves[0], child_threads);
+					}
+					else {
+						build(middle, last, halves[1], child_threads);
+					}
+				}
+			});
+			append(out, halves[0]);
+			out[index].upper = static_cast<int>(out.size());
+			append(out, halves[1]);
+		}
+
+		// The points in tree order
+		auto gather() const -> std::vector<double> {
+			auto points = std::vector<double>(source_.size());
+			for (auto position = std::size_t{0}; position < order_.size(); ++position) {
+				std::copy_n(row(order_[position]), dimension_, points.data() + position * dimension_);
+			}
+			return points;
+		}
+
+		auto order() && -> std::vector<int> {
+			return std::move(order_);
+		}
+
+	private:
+		struct split_choice {
+			int axis; // -1 when the points cannot be split
+			double split;
+			int middle;
+		};
+
+		auto row(int id) const noexcept -> double const* {
+			return source_.data() + static_cast<std::size_t>(id) * dimension_;
+		}
+
+		auto value(int id, int axis) const noexcept -> double {
+			return row(id)[axis];
+		}
+
+		// The axis with the largest spread over order_[first, last), stepping by `step`
+		auto widest_axis(int first, int last, int step) const -> std::pair<int, double> {
+			auto best = std::pair<int, double>(-1, 0.0);
+			for (auto axis = 0; axis < static_cast<int>(dimension_); ++axis) {
+				auto low = value(order_[static_cast<std::size_t>(first)], axis);
+				auto high = low;
+				for (auto i = first; i < last; i += step) {
+					auto const x = value(order_[static_cast<std::size_t>(i)], axis);
+					low = std::min(low, x);
+					high = std::max(high, x);
+				}
+				if (high - low > best.second) {
+					best = {axis, high - low};
+				}
+			}
+			return best;
+		}
+
+		auto partition(int first, int last) -> split_choice {
+			auto const step = std::max(1, (last - first) / split_sample);
+			auto axis = widest_axis(first, last, step).first;
+			if (axis < 0 and step > 1) {
+				// the sample was flat, which doesn't mean every point is
+				axis = widest_axis(first, last, 1).first;
+			}
+			if (axis < 0) {
+				return {-1, 0.0, first};
+			}
+
+			auto sample = std::vector<double>();
+			for (auto i = first; i < last; i += step) {
+				sample.push_back(value(order_[static_cast<std::size_t>(i)], axis));
+			}
+			auto const median = sample.begin() + static_cast<std::ptrdiff_t>(sample.size() / 2);
+			std::nth_element(sample.begin(), median, sample.end());
+			auto const pivot = *median;
+
+			auto const begin = order_.begin() + first;
+			auto const end = order_.begin() + last;
+			auto const middle =
+			   std::partition(begin, end, [&](int id) { return value(id, axis) < pivot; });
+			if (middle != begin and middle != end) {
+				return {axis, pivot, static_cast<int>(middle - order_.begin())};
+			}
+
+			// The sample median is the smallest value, so split at the exact median instead.
+			auto const exact = begin + (last - first) / 2;
+			std::nth_element(begin, exact, end, [&](int a, int b) {
+				return value(a, axis) < value(b, axis);
+			});
+			return {axis, value(*exact, axis), static_cast<int>(exact - order_.begin())};
+		}
+
+		// Appends a subtree built into its own array, moving its upper links along with it
+		static auto append(std::vector<node>& out, std::vector<node> const& subtree) -> void {
+			auto const offset = static_cast<int>(out.size());
+			for (auto n : subtree) {
+				if (n.axis >= 0) {
+					n.upper += offset;
+				}
+				out.push_back(n);
+			}
+		}
+
+		std::size_t dimension_;
+		int leaf_size_;
+		std::vector<double> source_;
+		std::vector<int> order_;
+	};
+
+	/*
+	 * Constructors
+	 */
+	kd_tree::kd_tree(std::span<euclidean_vector const> points, int leaf_size)
+	: dimension_{0}
+	, leaf_size_{leaf_size} {
+		throw_if_leaf_size_is_invalid(leaf_size);
+		rebuild(points);
+	}
+
+	/*
+	 * Member Functions
+	 */
+	auto kd_tree::size() const noexcept -> int {
+		return static_cast<int>(ids_.size());
+	}
+
+	auto kd_tree::dimensions() const noexcept -> int {
+		return static_cast<int>(dimension_);
+	}
+
+	auto kd_tree::leaf_size() const noexcept -> int {
+		return leaf_size_;
+	}
+
+	auto kd_tree::rebuild(std::span<euclidean_vector const> points) -> void {
+		auto const dimension =
+		   points.empty() ? std::size_t{0} : static_cast<std::size_t>(points.front().dimensions());
+		auto build = builder(points, dimension, leaf_size_);
+		auto nodes = std::vector<node>();
+		if (not points.empty()) {
+			auto const spare_threads = std::max(1U, std::thread::hardware_concurrency()) - 1;
+			build.build(0, static_cast<int>(points.size()), nodes, spare_threads);
+		}
+
+		points_ = build.gather();
+		ids_ = std::move(build).order();
+		nodes_ = std::move(nodes);
+		dimension_ = dimension;
+	}
+
+	auto kd_tree::search(euclidean_vector const& query, int k) const -> std::vector<neighbour> {
+		brute_force_index::throw_if_k_is_negative(k);
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(query.dimensions()));
+		if (nodes_.empty()) {
+			return {};
+		}
+
+		auto best = detail::top_k(std::min(static_cast<std::size_t>(k), ids_.size()));
+		auto const* const q = query.data();
+		// Each entry carries a lower bound on the squared distance to anything in its subtree.
+		auto pending = std::vector<std::pair<int, double>>{{0, 0.0}};
+		while (not pending.empty()) {
+			auto const [index, nearest_possible] = pending.back();
+			pending.pop_back();
+			if (nearest_possible > best.bound()) {
+				continue;
+			}
+
+			auto const& n = nodes_[static_cast<std::size_t>(index)];
+			if (n.axis < 0) {
+				for (auto position = n.first; position < n.last; ++position) {
+					best.push(squared_distance(q, position), ids_[static_cast<std::size_t>(position)]);
+				}
+				continue;
+			}
+
+			auto const offset = q[n.axis] - n.split;
+			auto const near_side = offset <= 0 ? index + 1 : n.upper;
+			auto const far_side = offset <= 0 ? n.upper : index + 1;
+			pending.emplace_back(far_side, std::max(nearest_possible, offset * offset));
+			pending.emplace_back(near_side, nearest_possible);
+		}
+
+		auto result = std::move(best).sorted();
+		for (auto& found : result) {
+			found.score = std::sqrt(found.score);
+		}
+		return result;
+	}
+
+	auto kd_tree::radius_search(euclidean_vector const& query, double radius) const
+	   -> std::vector<neighbour> {
+		throw_if_radius_is_negative(radius);
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(query.dimensions()));
+		auto result = std::vector<neighbour>();
+		if (nodes_.empty()) {
+			return result;
+		}
+
+		auto const* const q = query.data();
+		auto const limit = radius * radius;
+		auto pending = std::vector<int>{0};
+		while (not pending.empty()) {
+			auto const index = pending.back();
+			pending.pop_back();
+			auto const& n = nodes_[static_cast<std::size_t>(index)];
+			if (n.axis < 0) {
+				for (auto position = n.first; position < n.last; ++position) {
+					if (auto const d = squared_distance(q, position); d <= limit) {
+						result.push_back({ids_[static_cast<std::size_t>(position)], d});
+					}
+				}
+				continue;
+			}
+
+			auto const offset = q[n.axis] - n.split;
+			if (offset <= 0 or offset * offset <= limit) {
+				pending.push_back(index + 1);
+			}
+			if (offset >= 0 or offset * offset <= limit) {
+				pending.push_back(n.upper);
+			}
+		}
+
+		std::sort(result.begin(), result.end(), [](neighbour const& a, neighbour const& b) {
+			return a.score < b.score or (a.score == b.score and a.id < b.id);
+		});
+		for (auto& found : result) {
+			found.score = std::sqrt(found.score);
+		}
+		return result;
+	}
+
+	auto kd_tree::box_search(euclidean_vector const& lower, euclidean_vector const& upper) const
+	   -> std::vector<int> {
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(lower.dimensions()));
+		euclidean_vector::throw_if_dimension_not_equal(dimension_,
+		                                               static_cast<std::size_t>(upper.dimensions()));
+		auto result = std::vector<int>();
+		if (nodes_.empty()) {
+			return result;
+		}
+
+		auto const* const low = lower.data();
+		auto const* const high = upper.data();
+		auto pending = std::vector<int>{0};
+		while (not pending.empty()) {
+			auto const index = pending.back();
+			pending.pop_back();
+			auto const& n = nodes_[static_cast<std::size_t>(index)];
+			if (n.axis < 0) {
+				for (auto position = n.first; position < n.last; ++position) {
+					auto const* const p = point(position);
+					auto inside = true;
+					for (auto i = std::size_t{0}; inside and i < dimension_; ++i) {
+						inside = low[i] <= p[i] and p[i] <= high[i];
+					}
+					if (inside) {
+						result.push_back(ids_[static_cast<std::size_t>(position)]);
+					}
+				}
+				continue;
+			}
+
+			if (low[n.axis] <= n.split) {
+				pending.push_back(index + 1);
+			}
+			if (high[n.axis] >= n.split) {
+				pending.push_back(n.upper);
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	/*
+	 * Helper Functions
+	 */
+	auto kd_tree::throw_if_leaf_size_is_invalid(int leaf_size) -> void {
+		if (leaf_size < 1) {
+			throw euclidean_vector_error("kd_tree needs a leaf size of at least 1, not "
+			                             + std::to_string(leaf_size));
+		}
+	}
+
+	auto kd_tree::throw_if_radius_is_negative(double radius) -> void {
+		if (not(radius >= 0)) {
+			throw euclidean_vector_error("Cannot search within a radius of " + std::to_string(radius));
+		}
+	}
+
+	auto kd_tree::point(int position) const noexcept -> double const* {
+		return points_.data() + static_cast<std::size_t>(position) * dimension_;
+	}
+
+	// A plain loop rather than the SIMD kernels: for a handful of dimensions the call through the
+	// kernel table costs more than the arithmetic.
+	auto kd_tree::squared_distance(double const* query, int position) const noexcept -> double {
+		auto const* const p = point(position);
+		auto sum = 0.0;
+		for (auto i = std::size_t{0}; i < dimension_; ++i) {
+			auto const difference = query[i] - p[i];
+			sum += difference * difference;
+		}
+		return sum;
+	}
+} // namespace comp6771
@@ -0,0 +1,157 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/kernels.hpp>
+
+#include "kernels_impl.hpp"
+
+#include <initializer_list>
+
+namespace comp6771::kernels {
+	namespace {
+		/*
+		 * Scalar fallback. The reductions keep the sequential order of std::inner_product so that
+		 * they define the reference result the vectorised kernels are measured against.
+		 */
+		template<typename T>
+		auto scalar_dot(T const* a, T const* b, std::size_t n) noexcept -> double {
+			auto sum = 0.0;
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				sum += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+			}
+			return sum;
+		}
+
+		template<typename T>
+		auto scalar_sum_of_squares(T const* a, std::size_t n) noexcept -> double {
+			return scalar_dot(a, a, n);
+		}
+
+		template<typename T>
+		auto scalar_squared_distance(T const* a, T const* b, std::size_t n) noexcept -> double {
+			auto sum = 0.0;
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				auto const difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		template<typename T>
+		auto scalar_dot_and_squares(T const* a, T const* b, std::size_t n) noexcept -> fused_sums {
+			auto sums = fused_sums{};
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				auto const x = static_cast<double>(a[i]);
+				auto const y = static_cast<double>(b[i]);
+				sums.dot += x * y;
+				sums.a_squares += x * x;
+				sums.b_squares += y * y;
+			}
+			return sums;
+		}
+
+		template<typename T>
+		auto scalar_add(T* a, T const* b, std::size_t n) noexcept -> void {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				a[i] += b[i];
+			}
+		}
+
+		template<typename T>
+		auto scalar_subtract(T* a, T const* b, std::size_t n) noexcept -> void {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				a[i] -= b[i];
+			}
+		}
+
+		template<typename T>
+		auto scalar_scale(T* a, T factor, std::size_t n) noexcept -> void {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				a[i] *= factor;
+			}
+		}
+
+		template<typename T>
+		auto scalar_divide(T* a, T factor, std::size_t n) noexcept -> void {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				a[i] /= factor;
+			}
+		}
+
+		template<typename T>
+		constexpr auto scalar_kernels = basic_kernel_table<T>{isa::scalar,
+		                                                      scalar_dot<T>,
+		                                                      scalar_sum_of_squares<T>,
+		                                                      scalar_squared_distance<T>,
+		                                                      scalar_dot_and_squares<T>,
+		                                                      scalar_add<T>,
+		                                                      scalar_subtract<T>,
+		                                                      scalar_scale<T>,
+		                                                      scalar_divide<T>};
+
+		auto cpu_supports(isa instruction_set) noexcept -> bool {
+#if COMP6771_KERNELS_X86
+			switch (instruction_set) {
+			case isa::scalar: return true;
+			case isa::sse2: return __builtin_cpu_supports("sse2");
+			case isa::avx2: return __builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma");
+			case isa::avx512: return __builtin_cpu_supports("avx512f");
+			}
+			return false;
+#else
+			return instruction_set == isa::scalar;
+#endif
+		}
+
+		template<typename T>
+		auto select() noexcept -> basic_kernel_table<T> const& {
+			for (auto const instruction_set : {isa::avx512, isa::avx2, isa::sse2}) {
+				if (auto const* kernels = table<T>(instruction_set)) {
+					return *kernels;
+				}
+			}
+			return scalar_kernels<T>;
+		}
+	} // namespace
+
+	template<typename T>
+	auto table(isa instruction_set) noexcept -> basic_kernel_table<T> const* {
+		if (not cpu_supports(instruction_set)) {
+			return nullptr;
+		}
+
+		switch (instruction_set) {
+		case isa::scalar: return &scalar_kernels<T>;
+#if COMP6771_KERNELS_X86
+		case isa::sse2: return &detail::sse2_kernels<T>();
+		case isa::avx2: return &detail::avx2_kernels<T>();
+		case isa::avx512: return &detail::avx512_kernels<T>();
+#else
+		default: return nullptr;
+#endif
+		}
+		return nullptr;
+	}
+
+	template<typename T>
+	auto active() noexcept -> basic_kernel_table<T> const& {
+		static auto const& kernels = select<T>();
+		return kernels;
+	}
+
+	template auto table<float>(isa) noexcept -> basic_kernel_table<float> const*;
+	template auto table<double>(isa) noexcept -> basic_kernel_table<double> const*;
+	template auto active<float>() noexcept -> basic_kernel_table<float> const&;
+	template auto active<double>() noexcept -> basic_kernel_table<double> const&;
+
+	auto name(isa instruction_set) noexcept -> char const* {
+		switch (instruction_set) {
+		case isa::scalar: return "scalar";
+		case isa::sse2: return "sse2";
+		case isa::avx2: return "avx2";
+		case isa::avx512: return "avx512";
+		}
+		return "unknown";
+	}
+} // namespace comp6771::kernels
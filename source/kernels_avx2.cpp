@@ -0,0 +1,342 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include "kernels_impl.hpp"
+
+#include <immintrin.h>
+
+namespace comp6771::kernels::detail {
+	namespace {
+		constexpr auto lanes = std::size_t{4};
+		constexpr auto unroll = std::size_t{4};
+
+		auto horizontal_sum(__m256d v) noexcept -> double {
+			auto const pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+		}
+
+		auto dot(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+				acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+				acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+				acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+			}
+
+			auto sum =
+			   horizontal_sum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				sum += a[i] * b[i];
+			}
+			return sum;
+		}
+
+		auto sum_of_squares(double const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		// acc + (a - b)^2
+		auto add_squared_difference(__m256d a, __m256d b, __m256d acc) noexcept -> __m256d {
+			auto const difference = _mm256_sub_pd(a, b);
+			return _mm256_fmadd_pd(difference, difference, acc);
+		}
+
+		auto add_squared_difference(double const* a, double const* b, __m256d acc) noexcept
+		   -> __m256d {
+			return add_squared_difference(_mm256_loadu_pd(a), _mm256_loadu_pd(b), acc);
+		}
+
+		// One register's share of each of the sums in fused_sums
+		struct fused_accumulator {
+			__m256d dot = _mm256_setzero_pd();
+			__m256d a_squares = _mm256_setzero_pd();
+			__m256d b_squares = _mm256_setzero_pd();
+
+			auto add(__m256d a, __m256d b) noexcept -> void {
+				dot = _mm256_fmadd_pd(a, b, dot);
+				a_squares = _mm256_fmadd_pd(a, a, a_squares);
+				b_squares = _mm256_fmadd_pd(b, b, b_squares);
+			}
+		};
+
+		auto combine(fused_accumulator const& w,
+		             fused_accumulator const& x,
+		             fused_accumulator const& y,
+		             fused_accumulator const& z) noexcept -> fused_sums {
+			auto const sum = [](auto w, auto x, auto y, auto z) {
+				return horizontal_sum(_mm256_add_pd(_mm256_add_pd(w, x), _mm256_add_pd(y, z)));
+			};
+			return fused_sums{sum(w.dot, x.dot, y.dot, z.dot),
+			                  sum(w.a_squares, x.a_squares, y.a_squares, z.a_squares),
+			                  sum(w.b_squares, x.b_squares, y.b_squares, z.b_squares)};
+		}
+
+		auto squared_distance(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = add_squared_difference(a + i, b + i, acc0);
+				acc1 = add_squared_difference(a + i + 4, b + i + 4, acc1);
+				acc2 = add_squared_difference(a + i + 8, b + i + 8, acc2);
+				acc3 = add_squared_difference(a + i + 12, b + i + 12, acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = add_squared_difference(a + i, b + i, acc0);
+			}
+
+			auto sum =
+			   horizontal_sum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				auto const difference = a[i] - b[i];
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		auto dot_and_squares(double const* a, double const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0.add(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+				acc1.add(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+				acc2.add(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8));
+				acc3.add(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0.add(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+			}
+
+			auto sums = combine(acc0, acc1, acc2, acc3);
+			for (; i < n; ++i) {
+				sums.dot += a[i] * b[i];
+				sums.a_squares += a[i] * a[i];
+				sums.b_squares += b[i] * b[i];
+			}
+			return sums;
+		}
+
+		auto add(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] += b[i];
+			}
+		}
+
+		auto subtract(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm256_storeu_pd(a + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] -= b[i];
+			}
+		}
+
+		auto scale(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm256_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] *= factor;
+			}
+		}
+
+		auto divide(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm256_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm256_storeu_pd(a + i, _mm256_div_pd(_mm256_loadu_pd(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] /= factor;
+			}
+		}
+
+		/*
+		 * float: eight lanes per register for the element-wise kernels. The reductions widen four
+		 * floats at a time to double before accumulating.
+		 */
+		constexpr auto float_lanes = std::size_t{8};
+
+		auto widen(float const* p) noexcept -> __m256d {
+			return _mm256_cvtps_pd(_mm_loadu_ps(p));
+		}
+
+		auto dot(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm256_fmadd_pd(widen(a + i), widen(b + i), acc0);
+				acc1 = _mm256_fmadd_pd(widen(a + i + 4), widen(b + i + 4), acc1);
+				acc2 = _mm256_fmadd_pd(widen(a + i + 8), widen(b + i + 8), acc2);
+				acc3 = _mm256_fmadd_pd(widen(a + i + 12), widen(b + i + 12), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm256_fmadd_pd(widen(a + i), widen(b + i), acc0);
+			}
+
+			auto sum =
+			   horizontal_sum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				sum += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+			}
+			return sum;
+		}
+
+		auto sum_of_squares(float const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		auto squared_distance(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm256_setzero_pd();
+			auto acc1 = _mm256_setzero_pd();
+			auto acc2 = _mm256_setzero_pd();
+			auto acc3 = _mm256_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = add_squared_difference(widen(a + i), widen(b + i), acc0);
+				acc1 = add_squared_difference(widen(a + i + 4), widen(b + i + 4), acc1);
+				acc2 = add_squared_difference(widen(a + i + 8), widen(b + i + 8), acc2);
+				acc3 = add_squared_difference(widen(a + i + 12), widen(b + i + 12), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = add_squared_difference(widen(a + i), widen(b + i), acc0);
+			}
+
+			auto sum =
+			   horizontal_sum(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				auto const difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		auto dot_and_squares(float const* a, float const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0.add(widen(a + i), widen(b + i));
+				acc1.add(widen(a + i + 4), widen(b + i + 4));
+				acc2.add(widen(a + i + 8), widen(b + i + 8));
+				acc3.add(widen(a + i + 12), widen(b + i + 12));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0.add(widen(a + i), widen(b + i));
+			}
+
+			auto sums = combine(acc0, acc1, acc2, acc3);
+			for (; i < n; ++i) {
+				auto const x = static_cast<double>(a[i]);
+				auto const y = static_cast<double>(b[i]);
+				sums.dot += x * y;
+				sums.a_squares += x * x;
+				sums.b_squares += y * y;
+			}
+			return sums;
+		}
+
+		auto add(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm256_storeu_ps(a + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] += b[i];
+			}
+		}
+
+		auto subtract(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm256_storeu_ps(a + i, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] -= b[i];
+			}
+		}
+
+		auto scale(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm256_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm256_storeu_ps(a + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] *= factor;
+			}
+		}
+
+		auto divide(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm256_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm256_storeu_ps(a + i, _mm256_div_ps(_mm256_loadu_ps(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] /= factor;
+			}
+		}
+
+		constexpr auto double_kernels = basic_kernel_table<double>{isa::avx2,
+		                                                           dot,
+		                                                           sum_of_squares,
+		                                                           squared_distance,
+		                                                           dot_and_squares,
+		                                                           add,
+		                                                           subtract,
+		                                                           scale,
+		                                                           divide};
+		constexpr auto float_kernels = basic_kernel_table<float>{isa::avx2,
+		                                                         dot,
+		                                                         sum_of_squares,
+		                                                         squared_distance,
+		                                                         dot_and_squares,
+		                                                         add,
+		                                                         subtract,
+		                                                         scale,
+		                                                         divide};
+	} // namespace
+
+	template<>
+	auto avx2_kernels<float>() noexcept -> basic_kernel_table<float> const& {
+		return float_kernels;
+	}
+
+	template<>
+	auto avx2_kernels<double>() noexcept -> basic_kernel_table<double> const& {
+		return double_kernels;
+	}
+} // namespace comp6771::kernels::detail
@@ -0,0 +1,364 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include "kernels_impl.hpp"
+
+#include <immintrin.h>
+
+namespace comp6771::kernels::detail {
+	namespace {
+		constexpr auto lanes = std::size_t{8};
+		constexpr auto unroll = std::size_t{4};
+
+		// Selects the first `remaining` lanes of a vector, for the partial block at the end of a loop.
+		auto tail_mask(std::size_t remaining) noexcept -> __mmask8 {
+			return static_cast<__mmask8>((1U << remaining) - 1U);
+		}
+
+		auto dot(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			auto acc2 = _mm512_setzero_pd();
+			auto acc3 = _mm512_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+				acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+				acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+				acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i),
+				                       _mm512_maskz_loadu_pd(mask, b + i),
+				                       acc1);
+			}
+
+			return _mm512_reduce_add_pd(
+			   _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+		}
+
+		auto sum_of_squares(double const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		// acc + (a - b)^2
+		auto add_squared_difference(__m512d a, __m512d b, __m512d acc) noexcept -> __m512d {
+			auto const difference = _mm512_sub_pd(a, b);
+			return _mm512_fmadd_pd(difference, difference, acc);
+		}
+
+		auto add_squared_difference(double const* a, double const* b, __m512d acc) noexcept
+		   -> __m512d {
+			return add_squared_difference(_mm512_loadu_pd(a), _mm512_loadu_pd(b), acc);
+		}
+
+		// One register's share of each of the sums in fused_sums
+		struct fused_accumulator {
+			__m512d dot = _mm512_setzero_pd();
+			__m512d a_squares = _mm512_setzero_pd();
+			__m512d b_squares = _mm512_setzero_pd();
+
+			auto add(__m512d a, __m512d b) noexcept -> void {
+				dot = _mm512_fmadd_pd(a, b, dot);
+				a_squares = _mm512_fmadd_pd(a, a, a_squares);
+				b_squares = _mm512_fmadd_pd(b, b, b_squares);
+			}
+		};
+
+		auto combine(fused_accumulator const& w,
+		             fused_accumulator const& x,
+		             fused_accumulator const& y,
+		             fused_accumulator const& z) noexcept -> fused_sums {
+			auto const sum = [](auto w, auto x, auto y, auto z) {
+				return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(w, x), _mm512_add_pd(y, z)));
+			};
+			return fused_sums{sum(w.dot, x.dot, y.dot, z.dot),
+			                  sum(w.a_squares, x.a_squares, y.a_squares, z.a_squares),
+			                  sum(w.b_squares, x.b_squares, y.b_squares, z.b_squares)};
+		}
+
+		auto squared_distance(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			auto acc2 = _mm512_setzero_pd();
+			auto acc3 = _mm512_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = add_squared_difference(a + i, b + i, acc0);
+				acc1 = add_squared_difference(a + i + 8, b + i + 8, acc1);
+				acc2 = add_squared_difference(a + i + 16, b + i + 16, acc2);
+				acc3 = add_squared_difference(a + i + 24, b + i + 24, acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = add_squared_difference(a + i, b + i, acc0);
+			}
+			if (i < n) {
+				// masked-off lanes load as zero from both inputs, so they add nothing
+				auto const mask = tail_mask(n - i);
+				acc1 = add_squared_difference(_mm512_maskz_loadu_pd(mask, a + i),
+				                              _mm512_maskz_loadu_pd(mask, b + i),
+				                              acc1);
+			}
+
+			return _mm512_reduce_add_pd(
+			   _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+		}
+
+		auto dot_and_squares(double const* a, double const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0.add(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+				acc1.add(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8));
+				acc2.add(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16));
+				acc3.add(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0.add(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				acc1.add(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+			}
+			return combine(acc0, acc1, acc2, acc3);
+		}
+
+		auto add(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm512_storeu_pd(a + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				auto const sum =
+				   _mm512_add_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+				_mm512_mask_storeu_pd(a + i, mask, sum);
+			}
+		}
+
+		auto subtract(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm512_storeu_pd(a + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				auto const difference =
+				   _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+				_mm512_mask_storeu_pd(a + i, mask, difference);
+			}
+		}
+
+		auto scale(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm512_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), f));
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				_mm512_mask_storeu_pd(a + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, a + i), f));
+			}
+		}
+
+		auto divide(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm512_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm512_storeu_pd(a + i, _mm512_div_pd(_mm512_loadu_pd(a + i), f));
+			}
+			if (i < n) {
+				auto const mask = tail_mask(n - i);
+				_mm512_mask_storeu_pd(a + i, mask, _mm512_div_pd(_mm512_maskz_loadu_pd(mask, a + i), f));
+			}
+		}
+
+		/*
+		 * float: sixteen lanes per register for the element-wise kernels. The reductions widen
+		 * eight floats at a time to double before accumulating.
+		 */
+		constexpr auto float_lanes = std::size_t{16};
+
+		auto float_tail_mask(std::size_t remaining) noexcept -> __mmask16 {
+			return static_cast<__mmask16>((1U << remaining) - 1U);
+		}
+
+		auto widen(float const* p) noexcept -> __m512d {
+			return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+		}
+
+		auto dot(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			auto acc2 = _mm512_setzero_pd();
+			auto acc3 = _mm512_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm512_fmadd_pd(widen(a + i), widen(b + i), acc0);
+				acc1 = _mm512_fmadd_pd(widen(a + i + 8), widen(b + i + 8), acc1);
+				acc2 = _mm512_fmadd_pd(widen(a + i + 16), widen(b + i + 16), acc2);
+				acc3 = _mm512_fmadd_pd(widen(a + i + 24), widen(b + i + 24), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm512_fmadd_pd(widen(a + i), widen(b + i), acc0);
+			}
+			if (i < n) {
+				// fewer than eight floats remain, so the low half of a masked load holds all of them
+				auto const mask = float_tail_mask(n - i);
+				auto const a_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, a + i));
+				auto const b_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, b + i));
+				acc1 = _mm512_fmadd_pd(_mm512_cvtps_pd(a_tail), _mm512_cvtps_pd(b_tail), acc1);
+			}
+
+			return _mm512_reduce_add_pd(
+			   _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+		}
+
+		auto sum_of_squares(float const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		auto squared_distance(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm512_setzero_pd();
+			auto acc1 = _mm512_setzero_pd();
+			auto acc2 = _mm512_setzero_pd();
+			auto acc3 = _mm512_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = add_squared_difference(widen(a + i), widen(b + i), acc0);
+				acc1 = add_squared_difference(widen(a + i + 8), widen(b + i + 8), acc1);
+				acc2 = add_squared_difference(widen(a + i + 16), widen(b + i + 16), acc2);
+				acc3 = add_squared_difference(widen(a + i + 24), widen(b + i + 24), acc3);
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = add_squared_difference(widen(a + i), widen(b + i), acc0);
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				auto const a_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, a + i));
+				auto const b_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, b + i));
+				acc1 = add_squared_difference(_mm512_cvtps_pd(a_tail), _mm512_cvtps_pd(b_tail), acc1);
+			}
+
+			return _mm512_reduce_add_pd(
+			   _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+		}
+
+		auto dot_and_squares(float const* a, float const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0.add(widen(a + i), widen(b + i));
+				acc1.add(widen(a + i + 8), widen(b + i + 8));
+				acc2.add(widen(a + i + 16), widen(b + i + 16));
+				acc3.add(widen(a + i + 24), widen(b + i + 24));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0.add(widen(a + i), widen(b + i));
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				auto const a_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, a + i));
+				auto const b_tail = _mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, b + i));
+				acc1.add(_mm512_cvtps_pd(a_tail), _mm512_cvtps_pd(b_tail));
+			}
+			return combine(acc0, acc1, acc2, acc3);
+		}
+
+		auto add(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm512_storeu_ps(a + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				auto const sum =
+				   _mm512_add_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+				_mm512_mask_storeu_ps(a + i, mask, sum);
+			}
+		}
+
+		auto subtract(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm512_storeu_ps(a + i, _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				auto const difference =
+				   _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+				_mm512_mask_storeu_ps(a + i, mask, difference);
+			}
+		}
+
+		auto scale(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm512_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm512_storeu_ps(a + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), f));
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				_mm512_mask_storeu_ps(a + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, a + i), f));
+			}
+		}
+
+		auto divide(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm512_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm512_storeu_ps(a + i, _mm512_div_ps(_mm512_loadu_ps(a + i), f));
+			}
+			if (i < n) {
+				auto const mask = float_tail_mask(n - i);
+				_mm512_mask_storeu_ps(a + i, mask, _mm512_div_ps(_mm512_maskz_loadu_ps(mask, a + i), f));
+			}
+		}
+
+		constexpr auto double_kernels = basic_kernel_table<double>{isa::avx512,
+		                                                           dot,
+		                                                           sum_of_squares,
+		                                                           squared_distance,
+		                                                           dot_and_squares,
+		                                                           add,
+		                                                           subtract,
+		                                                           scale,
+		                                                           divide};
+		constexpr auto float_kernels = basic_kernel_table<float>{isa::avx512,
+		                                                         dot,
+		                                                         sum_of_squares,
+		                                                         squared_distance,
+		                                                         dot_and_squares,
+		                                                         add,
+		                                                         subtract,
+		                                                         scale,
+		                                                         divide};
+	} // namespace
+
+	template<>
+	auto avx512_kernels<float>() noexcept -> basic_kernel_table<float> const& {
+		return float_kernels;
+	}
+
+	template<>
+	auto avx512_kernels<double>() noexcept -> basic_kernel_table<double> const& {
+		return double_kernels;
+	}
+} // namespace comp6771::kernels::detail
@@ -0,0 +1,40 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#ifndef COMP6771_KERNELS_IMPL_HPP
+#define COMP6771_KERNELS_IMPL_HPP
+
+#include <comp6771/kernels.hpp>
+
+// Set by the build when the x86 kernel translation units are compiled in.
+#ifndef COMP6771_KERNELS_X86
+#	define COMP6771_KERNELS_X86 0
+#endif
+
+namespace comp6771::kernels::detail {
+#if COMP6771_KERNELS_X86
+	// Each of these lives in a translation unit compiled for its own instruction set, and must only
+	// be called once the CPU is known to support it.
+	template<typename T>
+	auto sse2_kernels() noexcept -> basic_kernel_table<T> const&;
+	template<typename T>
+	auto avx2_kernels() noexcept -> basic_kernel_table<T> const&;
+	template<typename T>
+	auto avx512_kernels() noexcept -> basic_kernel_table<T> const&;
+
+	template<>
+	auto sse2_kernels<float>() noexcept -> basic_kernel_table<float> const&;
+	template<>
+	auto sse2_kernels<double>() noexcept -> basic_kernel_table<double> const&;
+	template<>
+	auto avx2_kernels<float>() noexcept -> basic_kernel_table<float> const&;
+	template<>
+	auto avx2_kernels<double>() noexcept -> basic_kernel_table<double> const&;
+	template<>
+	auto avx512_kernels<float>() noexcept -> basic_kernel_table<float> const&;
+	template<>
+	auto avx512_kernels<double>() noexcept -> basic_kernel_table<double> const&;
+#endif
+} // namespace comp6771::kernels::detail
+
+#endif // COMP6771_KERNELS_IMPL_HPP
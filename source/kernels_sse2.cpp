@@ -0,0 +1,359 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include "kernels_impl.hpp"
+
+#include <immintrin.h>
+
+namespace comp6771::kernels::detail {
+	namespace {
+		constexpr auto lanes = std::size_t{2};
+		constexpr auto unroll = std::size_t{4};
+
+		auto horizontal_sum(__m128d v) noexcept -> double {
+			return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+		}
+
+		auto dot(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			auto acc2 = _mm_setzero_pd();
+			auto acc3 = _mm_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+				acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+				acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+				acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			}
+
+			auto sum = horizontal_sum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				sum += a[i] * b[i];
+			}
+			return sum;
+		}
+
+		auto sum_of_squares(double const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		auto squared_difference(__m128d a, __m128d b) noexcept -> __m128d {
+			auto const difference = _mm_sub_pd(a, b);
+			return _mm_mul_pd(difference, difference);
+		}
+
+		// One register's share of each of the sums in fused_sums
+		struct fused_accumulator {
+			__m128d dot = _mm_setzero_pd();
+			__m128d a_squares = _mm_setzero_pd();
+			__m128d b_squares = _mm_setzero_pd();
+
+			auto add(__m128d a, __m128d b) noexcept -> void {
+				dot = _mm_add_pd(dot, _mm_mul_pd(a, b));
+				a_squares = _mm_add_pd(a_squares, _mm_mul_pd(a, a));
+				b_squares = _mm_add_pd(b_squares, _mm_mul_pd(b, b));
+			}
+		};
+
+		auto combine(fused_accumulator const& w,
+		             fused_accumulator const& x,
+		             fused_accumulator const& y,
+		             fused_accumulator const& z) noexcept -> fused_sums {
+			auto const sum = [](auto w, auto x, auto y, auto z) {
+				return horizontal_sum(_mm_add_pd(_mm_add_pd(w, x), _mm_add_pd(y, z)));
+			};
+			return fused_sums{sum(w.dot, x.dot, y.dot, z.dot),
+			                  sum(w.a_squares, x.a_squares, y.a_squares, z.a_squares),
+			                  sum(w.b_squares, x.b_squares, y.b_squares, z.b_squares)};
+		}
+
+		auto squared_distance(double const* a, double const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			auto acc2 = _mm_setzero_pd();
+			auto acc3 = _mm_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0 = _mm_add_pd(acc0, squared_difference(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+				acc1 = _mm_add_pd(acc1,
+				                  squared_difference(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+				acc2 = _mm_add_pd(acc2,
+				                  squared_difference(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+				acc3 = _mm_add_pd(acc3,
+				                  squared_difference(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0 = _mm_add_pd(acc0, squared_difference(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			}
+
+			auto sum = horizontal_sum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				auto const difference = a[i] - b[i];
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		auto dot_and_squares(double const* a, double const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + lanes * unroll <= n; i += lanes * unroll) {
+				acc0.add(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+				acc1.add(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2));
+				acc2.add(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4));
+				acc3.add(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6));
+			}
+			for (; i + lanes <= n; i += lanes) {
+				acc0.add(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+			}
+
+			auto sums = combine(acc0, acc1, acc2, acc3);
+			for (; i < n; ++i) {
+				sums.dot += a[i] * b[i];
+				sums.a_squares += a[i] * a[i];
+				sums.b_squares += b[i] * b[i];
+			}
+			return sums;
+		}
+
+		auto add(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm_storeu_pd(a + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] += b[i];
+			}
+		}
+
+		auto subtract(double* a, double const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm_storeu_pd(a + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] -= b[i];
+			}
+		}
+
+		auto scale(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm_storeu_pd(a + i, _mm_mul_pd(_mm_loadu_pd(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] *= factor;
+			}
+		}
+
+		auto divide(double* a, double factor, std::size_t n) noexcept -> void {
+			auto const f = _mm_set1_pd(factor);
+			auto i = std::size_t{0};
+			for (; i + lanes <= n; i += lanes) {
+				_mm_storeu_pd(a + i, _mm_div_pd(_mm_loadu_pd(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] /= factor;
+			}
+		}
+
+		/*
+		 * float: four lanes per register for the element-wise kernels. The reductions widen each
+		 * half of a register to double before accumulating.
+		 */
+		constexpr auto float_lanes = std::size_t{4};
+
+		auto widen_low(__m128 v) noexcept -> __m128d {
+			return _mm_cvtps_pd(v);
+		}
+
+		auto widen_high(__m128 v) noexcept -> __m128d {
+			return _mm_cvtps_pd(_mm_movehl_ps(v, v));
+		}
+
+		auto dot(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			auto acc2 = _mm_setzero_pd();
+			auto acc3 = _mm_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + float_lanes * 2 <= n; i += float_lanes * 2) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				auto const a1 = _mm_loadu_ps(a + i + 4);
+				auto const b1 = _mm_loadu_ps(b + i + 4);
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(widen_low(a0), widen_low(b0)));
+				acc1 = _mm_add_pd(acc1, _mm_mul_pd(widen_high(a0), widen_high(b0)));
+				acc2 = _mm_add_pd(acc2, _mm_mul_pd(widen_low(a1), widen_low(b1)));
+				acc3 = _mm_add_pd(acc3, _mm_mul_pd(widen_high(a1), widen_high(b1)));
+			}
+			for (; i + float_lanes <= n; i += float_lanes) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				acc0 = _mm_add_pd(acc0, _mm_mul_pd(widen_low(a0), widen_low(b0)));
+				acc1 = _mm_add_pd(acc1, _mm_mul_pd(widen_high(a0), widen_high(b0)));
+			}
+
+			auto sum = horizontal_sum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				sum += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+			}
+			return sum;
+		}
+
+		auto sum_of_squares(float const* a, std::size_t n) noexcept -> double {
+			return dot(a, a, n);
+		}
+
+		auto squared_distance(float const* a, float const* b, std::size_t n) noexcept -> double {
+			auto acc0 = _mm_setzero_pd();
+			auto acc1 = _mm_setzero_pd();
+			auto acc2 = _mm_setzero_pd();
+			auto acc3 = _mm_setzero_pd();
+
+			auto i = std::size_t{0};
+			for (; i + float_lanes * 2 <= n; i += float_lanes * 2) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				auto const a1 = _mm_loadu_ps(a + i + 4);
+				auto const b1 = _mm_loadu_ps(b + i + 4);
+				acc0 = _mm_add_pd(acc0, squared_difference(widen_low(a0), widen_low(b0)));
+				acc1 = _mm_add_pd(acc1, squared_difference(widen_high(a0), widen_high(b0)));
+				acc2 = _mm_add_pd(acc2, squared_difference(widen_low(a1), widen_low(b1)));
+				acc3 = _mm_add_pd(acc3, squared_difference(widen_high(a1), widen_high(b1)));
+			}
+			for (; i + float_lanes <= n; i += float_lanes) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				acc0 = _mm_add_pd(acc0, squared_difference(widen_low(a0), widen_low(b0)));
+				acc1 = _mm_add_pd(acc1, squared_difference(widen_high(a0), widen_high(b0)));
+			}
+
+			auto sum = horizontal_sum(_mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+			for (; i < n; ++i) {
+				auto const difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+				sum += difference * difference;
+			}
+			return sum;
+		}
+
+		auto dot_and_squares(float const* a, float const* b, std::size_t n) noexcept -> fused_sums {
+			auto acc0 = fused_accumulator{};
+			auto acc1 = fused_accumulator{};
+			auto acc2 = fused_accumulator{};
+			auto acc3 = fused_accumulator{};
+
+			auto i = std::size_t{0};
+			for (; i + float_lanes * 2 <= n; i += float_lanes * 2) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				auto const a1 = _mm_loadu_ps(a + i + 4);
+				auto const b1 = _mm_loadu_ps(b + i + 4);
+				acc0.add(widen_low(a0), widen_low(b0));
+				acc1.add(widen_high(a0), widen_high(b0));
+				acc2.add(widen_low(a1), widen_low(b1));
+				acc3.add(widen_high(a1), widen_high(b1));
+			}
+			for (; i + float_lanes <= n; i += float_lanes) {
+				auto const a0 = _mm_loadu_ps(a + i);
+				auto const b0 = _mm_loadu_ps(b + i);
+				acc0.add(widen_low(a0), widen_low(b0));
+				acc1.add(widen_high(a0), widen_high(b0));
+			}
+
+			auto sums = combine(acc0, acc1, acc2, acc3);
+			for (; i < n; ++i) {
+				auto const x = static_cast<double>(a[i]);
+				auto const y = static_cast<double>(b[i]);
+				sums.dot += x * y;
+				sums.a_squares += x * x;
+				sums.b_squares += y * y;
+			}
+			return sums;
+		}
+
+		auto add(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm_storeu_ps(a + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] += b[i];
+			}
+		}
+
+		auto subtract(float* a, float const* b, std::size_t n) noexcept -> void {
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm_storeu_ps(a + i, _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			}
+			for (; i < n; ++i) {
+				a[i] -= b[i];
+			}
+		}
+
+		auto scale(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm_storeu_ps(a + i, _mm_mul_ps(_mm_loadu_ps(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] *= factor;
+			}
+		}
+
+		auto divide(float* a, float factor, std::size_t n) noexcept -> void {
+			auto const f = _mm_set1_ps(factor);
+			auto i = std::size_t{0};
+			for (; i + float_lanes <= n; i += float_lanes) {
+				_mm_storeu_ps(a + i, _mm_div_ps(_mm_loadu_ps(a + i), f));
+			}
+			for (; i < n; ++i) {
+				a[i] /= factor;
+			}
+		}
+
+		constexpr auto double_kernels = basic_kernel_table<double>{isa::sse2,
+		                                                           dot,
+		                                                           sum_of_squares,
+		                                                           squared_distance,
+		                                                           dot_and_squares,
+		                                                           add,
+		                                                           subtract,
+		                                                           scale,
+		                                                           divide};
+		constexpr auto float_kernels = basic_kernel_table<float>{isa::sse2,
+		                                                         dot,
+		                                                         sum_of_squares,
+		                                                         squared_distance,
+		                                                         dot_and_squares,
+		                                                         add,
+		                                                         subtract,
+		                                                         scale,
+		                                                         divide};
+	} // namespace
+
+	template<>
+	auto sse2_kernels<float>() noexcept -> basic_kernel_table<float> const& {
+		return float_kernels;
+	}
+
+	template<>
+	auto sse2_kernels<double>() noexcept -> basic_kernel_table<double> const& {
+		return double_kernels;
+	}
+} // namespace comp6771::kernels::detail
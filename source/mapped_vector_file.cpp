@@ -0,0 +1,305 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/mapped_vector_file.hpp>
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto flush_size = std::size_t{1} << 16;
+
+		auto throw_system_error(std::string const& what, std::filesystem::path const& path) -> void {
+			auto const error = std::error_code(errno, std::generic_category());
+			throw euclidean_vector_error("Could not " + what + " " + path.string() + ": "
+			                             + error.message());
+		}
+
+		auto advice(access_pattern access) noexcept -> int {
+			switch (access) {
+			case access_pattern::sequential: return MADV_SEQUENTIAL;
+			case access_pattern::random: return MADV_RANDOM;
+			case access_pattern::normal: break;
+			}
+			return MADV_NORMAL;
+		}
+
+		// Closes the descriptor once the mapping is made, or when mapping fails
+		class file_descriptor {
+		public:
+			explicit file_descriptor(int fd) noexcept
+			: fd_{fd} {}
+			file_descriptor(file_descriptor const&) = delete;
+			~file_descriptor() {
+				::close(fd_);
+			}
+			auto operator=(file_descriptor const&) -> file_descriptor& = delete;
+
+			[[nodiscard]] auto get() const noexcept -> int {
+				return fd_;
+			}
+
+		private:
+			int fd_;
+		};
+
+		auto throw_if_big_endian() -> void {
+			if constexpr (std::endian::native != std::endian::little) {
+				throw euclidean_vector_error("vecs files are little-endian and are used in place, "
+				                             "which this machine can't do");
+			}
+		}
+
+		auto read_dimension(std::byte const* row) noexcept -> std::int32_t {
+			auto dimension = std::int32_t{0};
+			std::memcpy(&dimension, row, sizeof(dimension));
+			return dimension;
+		}
+	} // namespace
+
+	/*
+	 * mapped_file
+	 */
+	mapped_file::mapped_file(std::filesystem::path const& path, map_options options)
+	: bytes_{nullptr}
+	, size_{0} {
+		auto const fd = file_descriptor(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+		if (fd.get() < 0) {
+			throw_system_error("open", path);
+		}
+		struct stat status {};
+		if (::fstat(fd.get(), &status) != 0) {
+			throw_system_error("read the size of", path);
+		}
+		if (status.st_size == 0) {
+			// mmap() refuses an empty mapping, and there is nothing to read anyway
+			return;
+		}
+
+		auto flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		if (options.populate) {
+			flags |= MAP_POPULATE;
+		}
+#endif
+		auto const size = static_cast<std::size_t>(status.st_size);
+		auto* const mapping = ::mmap(nullptr, size, PROT_READ, flags, fd.get(), 0);
+		if (mapping == MAP_FAILED) {
+			throw_system_error("map", path);
+		}
+		bytes_ = static_cast<std::byte const*>(mapping);
+		size_ = size;
+		advise(options.access);
+	}
+
+	mapped_file::mapped_file(mapped_file&& org) noexcept
+	: bytes_{std::exchange(org.bytes_, nullptr)}
+	, size_{std::exchange(org.size_, 0)} {}
+
+	mapped_file::~mapped_file() {
+		unmap();
+	}
+
+	auto mapped_file::operator=(mapped_file&& org) noexcept -> mapped_file& {
+		if (this == &org) {
+			return *this;
+		}
+
+		unmap();
+		bytes_ = std::exchange(org.bytes_, nullptr);
+		size_ = std::exchange(org.size_, 0);
+		return *this;
+	}
+
+	auto mapped_file::bytes() const noexcept -> std::span<std::byte const> {
+		return std::span(bytes_, size_);
+	}
+
+	auto mapped_file::size() const noexcept -> std::size_t {
+		return size_;
+	}
+
+	auto mapped_file::advise(access_pattern access) const -> void {
+		if (size_ == 0) {
+			return;
+		}
+		// the hint only changes read-ahead, so a kernel that ignores it is not an error
+		::madvise(const_cast<std::byte*>(bytes_), size_, advice(access));
+	}
+
+	auto mapped_file::unmap() noexcept -> void {
+		if (bytes_ != nullptr) {
+			::munmap(const_cast<std::byte*>(bytes_), size_);
+		}
+	}
+
+	/*
+	 * vecs_file
+	 */
+	template<typename S>
+	vecs_file<S>::vecs_file(std::filesystem::path const& path, map_options options)
+	: file_{path, options}
+	, dimension_{0}
+	, stride_{sizeof(std::int32_t)} {
+		throw_if_big_endian();
+		auto const bytes = file_.bytes();
+		if (bytes.empty()) {
+			return;
+		}
+		if (bytes.size() < sizeof(std::int32_t)) {
+			throw euclidean_vector_error("vecs file " + path.string() + " is truncated");
+		}
+
+		// Only the first row's dimension is read here, so opening never touches the rest of the file.
+		auto const dimension = read_dimension(bytes.data());
+		if (dimension < 0) {
+			throw euclidean_vector_error("vecs file " + path.string() + " starts with dimension "
+			                             + std::to_string(dimension));
+		}
+		dimension_ = static_cast<std::size_t>(dimension);
+		stride_ = sizeof(std::int32_t) + dimension_ * sizeof(S);
+		if (bytes.size() % stride_ != 0) {
+			throw euclidean_vector_error("vecs file " + path.string() + " of "
+			                             + std::to_string(bytes.size())
+			                             + " bytes is not a whole number of rows of dimension "
+			                             + std::to_string(dimension_));
+		}
+		if (bytes.size() / stride_ > INT_MAX) {
+			throw euclidean_vector_error("vecs file " + path.string() + " holds "
+			                             + std::to_string(bytes.size() / stride_)
+			                             + " rows, more than an int can index");
+		}
+	}
+
+	template<typename S>
+	auto vecs_file<S>::at(int row) const -> vecs_view<S> {
+		if (row < 0 or row >= size()) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " is not valid for this vecs_file object");
+		}
+		auto const dimension =
+		   read_dimension(file_.bytes().data() + static_cast<std::size_t>(row) * stride_);
+		if (static_cast<std::size_t>(dimension) != dimension_) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " of the vecs file has dimension "
+			                             + std::to_string(dimension) + ", not "
+			                             + std::to_string(dimension_));
+		}
+		return (*this)[row];
+	}
+
+	template<typename S>
+	auto vecs_file<S>::size() const noexcept -> int {
+		return static_cast<int>(file_.size() / stride_);
+	}
+
+	template<typename S>
+	auto vecs_file<S>::dimensions() const noexcept -> int {
+		return static_cast<int>(dimension_);
+	}
+
+	template<typename S>
+	auto vecs_file<S>::advise(access_pattern access) const -> void {
+		file_.advise(access);
+	}
+
+	/*
+	 * vecs_writer
+	 */
+	template<typename S>
+	vecs_writer<S>::vecs_writer(std::ostream& os)
+	: os_{&os}
+	, committed_{0}
+	, dimension_{0}
+	, rows_{0} {
+		throw_if_big_endian();
+		buffer_.reserve(flush_size);
+	}
+
+	template<typename S>
+	vecs_writer<S>::~vecs_writer() {
+		// a destructor can't report a failed write; call flush() first to find out
+		os_->write(reinterpret_cast<char const*>(buffer_.data()),
+		           static_cast<std::streamsize>(committed_));
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::write(float_euclidean_vector const& v) -> void {
+		auto* const out = begin_row(v.dimensions());
+		for (auto i = 0; i < v.dimensions(); ++i) {
+			out[i] = element(static_cast<double>(v[i]));
+		}
+		end_row();
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::flush() -> void {
+		os_->write(reinterpret_cast<char const*>(buffer_.data()),
+		           static_cast<std::streamsize>(committed_));
+		buffer_.clear();
+		committed_ = 0;
+		if (not *os_) {
+			throw euclidean_vector_error("Could not write the vecs file");
+		}
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::rows() const noexcept -> int {
+		return rows_;
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::begin_row(int dimension) -> S* {
+		if (rows_ > 0) {
+			euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimension_),
+			                                               static_cast<std::size_t>(dimension));
+		}
+		dimension_ = dimension;
+
+		// anything past committed_ is a row that threw part way through
+		auto const header = static_cast<std::int32_t>(dimension);
+		buffer_.resize(committed_ + sizeof(header) + static_cast<std::size_t>(dimension) * sizeof(S));
+		std::memcpy(buffer_.data() + committed_, &header, sizeof(header));
+		return reinterpret_cast<S*>(buffer_.data() + committed_ + sizeof(header));
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::end_row() -> void {
+		committed_ = buffer_.size();
+		++rows_;
+		if (committed_ >= flush_size) {
+			flush();
+		}
+	}
+
+	template<typename S>
+	auto vecs_writer<S>::throw_element_out_of_range(double magnitude) -> void {
+		auto text = std::array<char, 32>();
+		auto const last = std::to_chars(text.data(), text.data() + text.size(), magnitude).ptr;
+		throw euclidean_vector_error("Magnitude " + std::string(text.data(), last)
+		                             + " cannot be stored as a "
+		                             + std::to_string(sizeof(S) * CHAR_BIT) + "-bit integer element");
+	}
+
+	template class vecs_file<float>;
+	template class vecs_file<std::uint8_t>;
+	template class vecs_file<std::int32_t>;
+	template class vecs_writer<float>;
+	template class vecs_writer<std::uint8_t>;
+	template class vecs_writer<std::int32_t>;
+} // namespace comp6771
@@ -0,0 +1,60 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#ifndef COMP6771_PARALLEL_HPP
+#define COMP6771_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace comp6771::detail {
+	// Roughly the number of elements a thread has to process to outweigh the cost of starting it
+	constexpr auto elements_per_thread = std::size_t{1} << 15;
+
+	// Calls body(first, last) on contiguous chunks that cover [0, count), one chunk per hardware
+	// thread, and returns once every chunk is done. Each chunk gets at least `grain` items, so small
+	// jobs run on the calling thread alone instead of paying for thread start-up. If a chunk throws,
+	// the first exception is rethrown after every chunk has finished.
+	template<typename F>
+	auto parallel_for(std::size_t count, std::size_t grain, F const& body) -> void {
+		auto const hardware = std::size_t{std::max(1U, std::thread::hardware_concurrency())};
+		auto const chunks =
+		   std::clamp(count / std::max(grain, std::size_t{1}), std::size_t{1}, hardware);
+		if (chunks <= 1) {
+			body(std::size_t{0}, count);
+			return;
+		}
+
+		auto failure = std::exception_ptr();
+		auto failure_mutex = std::mutex();
+		auto const run = [&](std::size_t first, std::size_t last) noexcept {
+			try {
+				body(first, last);
+			} catch (...) {
+				auto const lock = std::scoped_lock(failure_mutex);
+				if (failure == nullptr) {
+					failure = std::current_exception();
+				}
+			}
+		};
+
+		auto const chunk_size = (count + chunks - 1) / chunks;
+		{
+			auto workers = std::vector<std::jthread>();
+			workers.reserve(chunks - 1);
+			for (auto first = chunk_size; first < count; first += chunk_size) {
+				workers.emplace_back(run, first, std::min(count, first + chunk_size));
+			}
+			run(std::size_t{0}, chunk_size);
+		}
+		if (failure != nullptr) {
+			std::rethrow_exception(failure);
+		}
+	}
+} // namespace comp6771::detail
+
+#endif // COMP6771_PARALLEL_HPP
@@ -0,0 +1,69 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#ifndef COMP6771_TOP_K_HPP
+#define COMP6771_TOP_K_HPP
+
+#include <comp6771/brute_force_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace comp6771::detail {
+	// The k candidates with the smallest keys seen so far, kept as a max-heap so the worst one is
+	// on top and can be replaced in O(log k). A neighbour's score holds the key until sorted().
+	class top_k {
+	public:
+		explicit top_k(std::size_t k)
+		: k_{k} {
+			heap_.reserve(k);
+		}
+
+		auto push(double key, int id) -> void {
+			auto const candidate = neighbour{id, key};
+			if (heap_.size() < k_) {
+				heap_.push_back(candidate);
+				std::push_heap(heap_.begin(), heap_.end(), before);
+			}
+			else if (k_ > 0 and before(candidate, heap_.front())) {
+				std::pop_heap(heap_.begin(), heap_.end(), before);
+				heap_.back() = candidate;
+				std::push_heap(heap_.begin(), heap_.end(), before);
+			}
+		}
+
+		// The key a candidate has to beat to be kept; infinite until k candidates are held. Ties
+		// with the bound can still be kept by a lower id, so prune only on keys strictly above it.
+		[[nodiscard]] auto bound() const noexcept -> double {
+			if (k_ == 0) {
+				return -std::numeric_limits<double>::infinity();
+			}
+			return heap_.size() < k_ ? std::numeric_limits<double>::infinity() : heap_.front().score;
+		}
+
+		auto merge(top_k const& other) -> void {
+			for (auto const& candidate : other.heap_) {
+				push(candidate.score, candidate.id);
+			}
+		}
+
+		// Best first
+		auto sorted() && -> std::vector<neighbour> {
+			std::sort_heap(heap_.begin(), heap_.end(), before);
+			return std::move(heap_);
+		}
+
+	private:
+		static auto before(neighbour const& a, neighbour const& b) noexcept -> bool {
+			return a.score < b.score or (a.score == b.score and a.id < b.id);
+		}
+
+		std::vector<neighbour> heap_;
+		std::size_t k_;
+	};
+} // namespace comp6771::detail
+
+#endif // COMP6771_TOP_K_HPP
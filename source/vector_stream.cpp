@@ -0,0 +1,290 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+
+#include <comp6771/vector_stream.hpp>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+namespace comp6771 {
+	namespace {
+		// Fills chunks on one thread for the whole stream, handing each to the caller in order and
+		// taking it back once it has been processed. Destroying it stops the thread, which first
+		// finishes any read it is in the middle of.
+		class background_reader {
+		public:
+			background_reader(vector_reader& reader,
+			                  std::span<euclidean_vector_batch> chunks,
+			                  int rows_per_chunk)
+			: reader_{&reader}
+			, rows_per_chunk_{rows_per_chunk}
+			, free_(chunks.size())
+			, finished_{false} {
+				std::transform(chunks.begin(), chunks.end(), free_.begin(), [](auto& chunk) {
+					return &chunk;
+				});
+				thread_ = std::jthread([this](std::stop_token stop) { run(stop); });
+			}
+
+			// The next chunk read, or nullptr once the file is exhausted. Rethrows what reading threw
+			// once the chunks read before it have been handed out.
+			auto next() -> euclidean_vector_batch* {
+				auto lock = std::unique_lock(mutex_);
+				changed_.wait(lock, [this] { return not filled_.empty() or finished_; });
+				if (not filled_.empty()) {
+					auto* const chunk = filled_.front();
+					filled_.pop_front();
+					return chunk;
+				}
+				if (error_) {
+					std::rethrow_exception(error_);
+				}
+				return nullptr;
+			}
+
+			auto recycle(euclidean_vector_batch* chunk) -> void {
+				{
+					auto const lock = std::scoped_lock(mutex_);
+					free_.push_back(chunk);
+				}
+				changed_.notify_all();
+			}
+
+		private:
+			vector_reader* reader_;
+			int rows_per_chunk_;
+			std::mutex mutex_;
+			std::condition_variable_any changed_;
+			std::deque<euclidean_vector_batch*> free_;
+			std::deque<euclidean_vector_batch*> filled_;
+			std::exception_ptr error_;
+			bool finished_;
+			std::jthread thread_; // last, so it is stopped and joined before the rest goes
+
+			auto run(std::stop_token const& stop) -> void {
+				try {
+					while (auto* const chunk = take_free(stop)) {
+						if (reader_->read(*chunk, rows_per_chunk_) == 0) {
+							break;
+						}
+						{
+							auto const lock = std::scoped_lock(mutex_);
+							filled_.push_back(chunk);
+						}
+						changed_.notify_all();
+					}
+				} catch (...) {
+					auto const lock = std::scoped_lock(mutex_);
+					error_ = std::current_exception();
+				}
+				{
+					auto const lock = std::scoped_lock(mutex_);
+					finished_ = true;
+				}
+				changed_.notify_all();
+			}
+
+			// A chunk to read into, or nullptr once the stream is being torn down
+			auto take_free(std::stop_token const& stop) -> euclidean_vector_batch* {
+				auto lock = std::unique_lock(mutex_);
+				if (not changed_.wait(lock, stop, [this] { return not free_.empty(); })) {
+					return nullptr;
+				}
+				auto* const chunk = free_.front();
+				free_.pop_front();
+				return chunk;
+			}
+		};
+	} // namespace
+
+	/*
+	 * vector_reader
+	 */
+	vector_reader::vector_reader(std::istream& is, vector_file_format format)
+	: is_{&is}
+	, binary_{}
+	, pending_(0)
+	, has_pending_{false}
+	, dimension_{0}
+	, text_rows_{0} {
+		if (format == vector_file_format::binary) {
+			binary_.emplace(is);
+			dimension_ = binary_->dimensions();
+			return;
+		}
+		has_pending_ = read_text();
+	}
+
+	auto vector_reader::dimensions() const noexcept -> int {
+		return dimension_;
+	}
+
+	auto vector_reader::read(euclidean_vector_batch& chunk, int max_rows) -> int {
+		euclidean_vector::throw_if_dimension_not_equal(static_cast<std::size_t>(dimension_),
+		                                               static_cast<std::size_t>(chunk.dimensions()));
+		if (binary_) {
+			auto const rows = std::min(max_rows, binary_->remaining());
+			chunk.resize(rows);
+			for (auto row = 0; row < rows; ++row) {
+				binary_->read(chunk[row]);
+			}
+			return rows;
+		}
+
+		// The number of vectors left is unknown, so the chunk grows as they arrive, up to max_rows.
+		auto rows = 0;
+		chunk.resize(0);
+		while (rows < max_rows and has_pending_) {
+			if (rows == chunk.rows()) {
+				chunk.resize(std::min(max_rows, std::max(64, rows * 2)));
+			}
+			chunk[rows++] = pending_;
+			has_pending_ = read_text();
+		}
+		chunk.resize(rows);
+		return rows;
+	}
+
+	auto vector_reader::read_text() -> bool {
+		*is_ >> std::ws;
+		if (is_->peek() == std::istream::traits_type::eof()) {
+			return false;
+		}
+		if (not(*is_ >> pending_)) {
+			throw euclidean_vector_error("Malformed euclidean_vector text after "
+			                             + std::to_string(text_rows_) + " vectors");
+		}
+
+		if (text_rows_ == 0) {
+			dimension_ = pending_.dimensions();
+		}
+		euclidean_vector::throw_if_dimension_not_equal(
+		   static_cast<std::size_t>(dimension_),
+		   static_cast<std::size_t>(pending_.dimensions()));
+		++text_rows_;
+		return true;
+	}
+
+	/*
+	 * vector_writer
+	 */
+	vector_writer::vector_writer(std::ostream& os, vector_file_format format)
+	: os_{&os}
+	, format_{format}
+	, binary_{}
+	, rows_{0} {}
+
+	auto vector_writer::write(euclidean_vector_batch const& chunk) -> void {
+		if (format_ == vector_file_format::text) {
+			if (not write_vectors(*os_, chunk)) {
+				throw euclidean_vector_error("Could not write the vector file");
+			}
+		}
+		else {
+			if (not binary_) {
+				binary_.emplace(*os_, chunk.dimensions());
+			}
+			for (auto row = 0; row < chunk.rows(); ++row) {
+				binary_->write(chunk[row]);
+			}
+		}
+		rows_ += chunk.rows();
+	}
+
+	auto vector_writer::finish() -> void {
+		if (format_ == vector_file_format::binary) {
+			if (not binary_) {
+				binary_.emplace(*os_, 0);
+			}
+			binary_->finish();
+		}
+		if (not os_->flush()) {
+			throw euclidean_vector_error("Could not write the vector file");
+		}
+	}
+
+	auto vector_writer::rows() const noexcept -> int {
+		return rows_;
+	}
+
+	/*
+	 * Transforms
+	 */
+	auto normalize_chunk::operator()(euclidean_vector_batch& chunk) const -> void {
+		chunk.normalize_rows();
+	}
+
+	auto scale_chunk::operator()(euclidean_vector_batch& chunk) const -> void {
+		chunk.scale_rows(factor);
+	}
+
+	auto filter_by_norm::operator()(euclidean_vector_batch& chunk) const -> void {
+		auto kept = 0;
+		for (auto row = 0; row < chunk.rows(); ++row) {
+			auto const norm = euclidean_norm(chunk[row]);
+			if (norm < min_norm or norm > max_norm) {
+				continue;
+			}
+			if (kept != row) {
+				chunk[kept] = chunk[row];
+			}
+			++kept;
+		}
+		chunk.resize(kept);
+	}
+
+	/*
+	 * Streaming
+	 */
+	namespace detail {
+		auto stream_chunks(vector_reader& reader,
+		                   vector_writer* writer,
+		                   stream_options const& options,
+		                   chunk_function process,
+		                   void const* transforms) -> stream_summary {
+			auto const dimension = reader.dimensions();
+			auto chunks = std::array{euclidean_vector_batch(0, dimension),
+			                         euclidean_vector_batch(0, dimension)};
+			// Two chunks are in flight at once, one being read and one being processed.
+			auto const row_bytes = std::max(chunks[0].stride(), std::size_t{1}) * sizeof(double);
+			auto const fitting_rows = options.memory_budget / (2 * row_bytes);
+			auto const rows_per_chunk =
+			   static_cast<int>(std::clamp(fitting_rows, std::size_t{1}, std::size_t{INT_MAX}));
+			// Sized once, so a chunk never holds two buffers while it grows; pages a small file
+			// never reaches are never touched.
+			for (auto& chunk : chunks) {
+				chunk.reserve(static_cast<std::size_t>(rows_per_chunk));
+			}
+
+			auto summary = stream_summary{rows_per_chunk, 0, 0, 0};
+			auto filler = background_reader(reader, chunks, rows_per_chunk);
+			while (auto* const chunk = filler.next()) {
+				++summary.chunks;
+				summary.rows_read += chunk->rows();
+				process(transforms, *chunk);
+				if (writer != nullptr) {
+					writer->write(*chunk);
+				}
+				summary.rows_kept += chunk->rows();
+				filler.recycle(chunk);
+			}
+
+			if (writer != nullptr) {
+				writer->finish();
+			}
+			return summary;
+		}
+	} // namespace detail
+} // namespace comp6771
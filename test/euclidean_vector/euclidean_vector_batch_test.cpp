@@ -0,0 +1,226 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the EuclideanVectorBatch class.
+//      The test cases are:
+//          1. test the constructors and row layout
+//          2. test row views with the utility functions and operators
+//          3. test push_back, resize and reserve
+//          4. test the bulk operations
+//          5. test the exception handling
+
+#include <comp6771/euclidean_vector_batch.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <sstream>
+#include <vector>
+
+TEST_CASE("Batch constructors", "[batch]") {
+	SECTION("Rows and dimensions") {
+		auto const batch = comp6771::euclidean_vector_batch(3, 5);
+
+		CHECK(batch.rows() == 3);
+		CHECK(batch.dimensions() == 5);
+		CHECK(batch.stride() == 8);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(comp6771::euclidean_vector(batch[row]) == comp6771::euclidean_vector(5));
+			auto const address = reinterpret_cast<std::uintptr_t>(batch[row].data());
+			CHECK(address % comp6771::euclidean_vector_batch::alignment == 0);
+		}
+	}
+
+	SECTION("From vectors") {
+		auto const vectors =
+		   std::vector<comp6771::euclidean_vector>{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+		auto const batch = comp6771::euclidean_vector_batch(vectors);
+
+		CHECK(batch.rows() == 2);
+		CHECK(batch.dimensions() == 3);
+		CHECK(comp6771::euclidean_vector(batch[0]) == vectors[0]);
+		CHECK(comp6771::euclidean_vector(batch[1]) == vectors[1]);
+	}
+
+	SECTION("Copy and move") {
+		auto batch = comp6771::euclidean_vector_batch(2, 3);
+		batch[1] = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+
+		auto copy = batch;
+		CHECK(comp6771::euclidean_vector(copy[1]) == comp6771::euclidean_vector{1.0, 2.0, 3.0});
+
+		auto moved = std::move(batch);
+		CHECK(moved.rows() == 2);
+		CHECK(batch.rows() == 0);
+
+		batch = copy;
+		CHECK(comp6771::euclidean_vector(batch[1]) == comp6771::euclidean_vector{1.0, 2.0, 3.0});
+	}
+}
+
+TEST_CASE("Batch row views", "[batch]") {
+	auto batch = comp6771::euclidean_vector_batch(3, 2);
+	batch[0] = comp6771::euclidean_vector{3.0, 4.0};
+	batch[1] = comp6771::euclidean_vector{1.0, 0.0};
+
+	SECTION("Utility functions") {
+		CHECK(comp6771::euclidean_norm(batch[0]) == Approx(5.0));
+		CHECK(comp6771::dot(batch[0], batch[1]) == Approx(3.0));
+		CHECK(comp6771::dot(batch[0], comp6771::euclidean_vector{1.0, 1.0}) == Approx(7.0));
+		CHECK(comp6771::unit(batch[0]) == comp6771::euclidean_vector{0.6, 0.8});
+	}
+
+	SECTION("Arithmetic operators") {
+		auto const sum = comp6771::euclidean_vector(batch[0] + batch[1]);
+		CHECK(sum == comp6771::euclidean_vector{4.0, 4.0});
+
+		batch[2] = batch[0] * 2.0 - batch[1];
+		CHECK(comp6771::euclidean_vector(batch[2]) == comp6771::euclidean_vector{5.0, 8.0});
+
+		batch[2] += batch[1];
+		batch[2] -= comp6771::euclidean_vector{1.0, 1.0};
+		batch[2] *= 2.0;
+		batch[2] /= 4.0;
+		CHECK(comp6771::euclidean_vector(batch[2]) == comp6771::euclidean_vector{2.5, 3.5});
+	}
+
+	SECTION("Row assignment writes through") {
+		batch[2] = batch[0];
+		batch[0][0] = 10.0;
+		CHECK(batch[2][0] == 3.0);
+		CHECK(batch[0][0] == 10.0);
+	}
+}
+
+TEST_CASE("Batch push_back", "[batch]") {
+	auto batch = comp6771::euclidean_vector_batch(0, 3);
+	for (auto i = 0; i < 100; ++i) {
+		batch.push_back(comp6771::euclidean_vector(3, static_cast<double>(i)));
+	}
+
+	CHECK(batch.rows() == 100);
+	CHECK(comp6771::euclidean_vector(batch[0]) == comp6771::euclidean_vector(3, 0.0));
+	CHECK(comp6771::euclidean_vector(batch[99]) == comp6771::euclidean_vector(3, 99.0));
+}
+
+TEST_CASE("Batch resize", "[batch]") {
+	auto batch = comp6771::euclidean_vector_batch(4, 3);
+	batch[1] = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const* const storage = batch[0].data();
+
+	// shrinking keeps the storage, and rows that come back are zero
+	batch.resize(1);
+	CHECK(batch.rows() == 1);
+	batch.resize(4);
+	CHECK(batch[0].data() == storage);
+	CHECK(comp6771::euclidean_vector(batch[1]) == comp6771::euclidean_vector(3));
+
+	batch[3] = comp6771::euclidean_vector{4.0, 5.0, 6.0};
+	batch.resize(10);
+	CHECK(batch.rows() == 10);
+	CHECK(comp6771::euclidean_vector(batch[3]) == comp6771::euclidean_vector{4.0, 5.0, 6.0});
+	CHECK(comp6771::euclidean_vector(batch[9]) == comp6771::euclidean_vector(3));
+	CHECK(batch.norms()[9] == 0.0);
+
+	batch.resize(0);
+	CHECK(batch.rows() == 0);
+
+	// after reserve, growing up to the reserved rows keeps the storage and the rows in it
+	batch.resize(2);
+	batch.reserve(50);
+	CHECK(batch.rows() == 2);
+	CHECK(comp6771::euclidean_vector(batch[1]) == comp6771::euclidean_vector(3));
+	auto const* const reserved = batch[0].data();
+	batch.resize(50);
+	CHECK(batch[0].data() == reserved);
+	batch.reserve(5);
+	CHECK(batch[0].data() == reserved);
+}
+
+TEST_CASE("Batch bulk operations", "[batch]") {
+	auto batch = comp6771::euclidean_vector_batch(4, 11);
+	for (auto row = 0; row < batch.rows(); ++row) {
+		batch[row] = comp6771::euclidean_vector(11, static_cast<double>(row));
+	}
+
+	SECTION("Add and subtract a row") {
+		batch.add_to_rows(comp6771::euclidean_vector(11, 1.0));
+		CHECK(comp6771::euclidean_vector(batch[3]) == comp6771::euclidean_vector(11, 4.0));
+
+		batch.subtract_from_rows(comp6771::euclidean_vector(11, 2.0));
+		CHECK(comp6771::euclidean_vector(batch[0]) == comp6771::euclidean_vector(11, -1.0));
+	}
+
+	SECTION("Scale") {
+		batch.scale_rows(3.0);
+		CHECK(comp6771::euclidean_vector(batch[2]) == comp6771::euclidean_vector(11, 6.0));
+	}
+
+	SECTION("Norms") {
+		auto const norms = batch.norms();
+		REQUIRE(norms.size() == 4);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(norms[static_cast<std::size_t>(row)] == Approx(comp6771::euclidean_norm(batch[row])));
+		}
+	}
+
+	SECTION("Normalize") {
+		batch[0] = comp6771::euclidean_vector(11, -2.0);
+		batch.normalize_rows();
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(comp6771::euclidean_norm(batch[row]) == Approx(1.0));
+		}
+		CHECK(batch[0][0] == Approx(-1.0 / std::sqrt(11.0)));
+		CHECK(batch[3][10] == Approx(1.0 / std::sqrt(11.0)));
+	}
+
+	SECTION("Write") {
+		batch[1][4] = 0.25;
+		auto expected = std::ostringstream();
+		for (auto row = 0; row < batch.rows(); ++row) {
+			expected << comp6771::euclidean_vector(batch[row]) << '\n';
+		}
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, batch);
+		CHECK(oss.str() == expected.str());
+		CHECK(oss.str().starts_with("[0 0 0 0 0 0 0 0 0 0 0]\n[1 1 1 1 0.25 1"));
+	}
+}
+
+TEST_CASE("Batch exception handling", "[batch]") {
+	auto batch = comp6771::euclidean_vector_batch(2, 3);
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1.0, 2.0}, {1.0, 2.0, 3.0}};
+	auto too_small = std::vector<double>(1);
+
+	CHECK_THROWS_WITH(batch.at(2), "Row 2 is not valid for this euclidean_vector_batch object");
+	CHECK_THROWS_WITH(batch.push_back(comp6771::euclidean_vector(2)),
+	                  "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(batch.add_to_rows(comp6771::euclidean_vector(4)),
+	                  "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(batch[0] = comp6771::euclidean_vector(4),
+	                  "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(batch[0] /= 0.0, "Invalid vector division by 0");
+
+	// sizes whose byte count wraps around are refused rather than under-allocated
+	CHECK_THROWS_AS(comp6771::euclidean_vector_batch(INT_MAX, INT_MAX), std::bad_array_new_length);
+	CHECK_THROWS_AS(comp6771::euclidean_vector_batch(-1, 3), std::bad_array_new_length);
+	auto wide = comp6771::euclidean_vector_batch(0, INT_MAX);
+	CHECK_THROWS_AS(wide.resize(1 << 30), std::bad_array_new_length);
+	CHECK(wide.rows() == 0);
+	CHECK_THROWS_WITH(batch.norms(too_small), "Output of size 1 cannot hold the norms of 2 rows");
+	CHECK_THROWS_WITH(comp6771::euclidean_vector_batch(vectors),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+
+	// the zero row is left alone and the others are still normalised
+	batch[1] = comp6771::euclidean_vector{0.0, 3.0, 4.0};
+	CHECK_THROWS_WITH(batch.normalize_rows(),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK(comp6771::euclidean_vector(batch[0]) == comp6771::euclidean_vector(3));
+	CHECK(batch[1][2] == Approx(0.8));
+	CHECK_THROWS_WITH(comp6771::euclidean_vector_batch(2, 0).normalize_rows(),
+	                  "euclidean_vector with no dimensions does not have a unit vector");
+	CHECK_NOTHROW(comp6771::euclidean_vector_batch(0, 0).normalize_rows());
+}
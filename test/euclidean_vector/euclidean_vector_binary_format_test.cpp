@@ -0,0 +1,439 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the binary save and load functions.
+//      The test cases are:
+//          1. test the file layout of a single vector
+//          2. test saving and loading collections and batches
+//          3. test loading across scalar sizes and byte orders
+//          4. test vector_file_view in place
+//          5. test reading and writing a row at a time
+//          6. test the exception handling
+//          7. test headers that claim more than the file holds
+
+#include <comp6771/binary_format.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <span>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	auto saved(comp6771::euclidean_vector_batch const& batch) -> std::string {
+		auto oss = std::ostringstream();
+		comp6771::save(oss, batch);
+		return oss.str();
+	}
+
+	auto sample_batch() -> comp6771::euclidean_vector_batch {
+		auto batch = comp6771::euclidean_vector_batch(5, 3);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			batch[row] = comp6771::euclidean_vector{row + 0.5, -row * 2.0, 1.0 / (row + 3)};
+		}
+		return batch;
+	}
+
+	// Copies the file into double-aligned storage, as mapping it or reading it whole would
+	auto aligned_copy(std::string const& file, std::size_t offset = 0) -> std::vector<double> {
+		auto storage = std::vector<double>((file.size() + offset) / sizeof(double) + 1);
+		std::memcpy(reinterpret_cast<char*>(storage.data()) + offset, file.data(), file.size());
+		return storage;
+	}
+
+	auto as_bytes(std::vector<double> const& storage, std::size_t size, std::size_t offset = 0)
+	   -> std::span<std::byte const> {
+		return std::span(reinterpret_cast<std::byte const*>(storage.data()) + offset, size);
+	}
+
+	// The same file as the other byte order would write it
+	auto byte_swapped(std::string file, std::size_t scalar_size) -> std::string {
+		auto const swap = [&](std::size_t offset, std::size_t size) {
+			std::reverse(file.begin() + static_cast<std::ptrdiff_t>(offset),
+			             file.begin() + static_cast<std::ptrdiff_t>(offset + size));
+		};
+		for (auto const offset : {8, 12, 16, 20}) {
+			swap(static_cast<std::size_t>(offset), 4);
+		}
+		swap(24, 8);
+		swap(32, 8);
+		for (auto offset = std::size_t{64}; offset < file.size(); offset += scalar_size) {
+			swap(offset, scalar_size);
+		}
+		return file;
+	}
+
+	// The same file with the dimension and count fields rewritten
+	auto with_shape(std::string file, std::uint64_t dimension, std::uint64_t count) -> std::string {
+		std::memcpy(file.data() + 24, &dimension, sizeof(dimension));
+		std::memcpy(file.data() + 32, &count, sizeof(count));
+		return file;
+	}
+
+	// An input stream that can't seek, like a pipe
+	class pipe_stream : public std::istream {
+	public:
+		explicit pipe_stream(std::string text)
+		: std::istream(nullptr)
+		, buffer_(std::move(text)) {
+			rdbuf(&buffer_);
+		}
+
+	private:
+		class buffer : public std::streambuf {
+		public:
+			explicit buffer(std::string text)
+			: text_(std::move(text)) {
+				setg(text_.data(), text_.data(), text_.data() + text_.size());
+			}
+
+		private:
+			std::string text_;
+		};
+
+		buffer buffer_;
+	};
+} // namespace
+
+TEST_CASE("Binary single vector", "[binary_format]") {
+	auto const v = comp6771::euclidean_vector{1.5, -2.0, 0.1};
+	auto ss = std::stringstream();
+	comp6771::save(ss, v);
+
+	auto const file = ss.str();
+	REQUIRE(file.size() == comp6771::binary_header_size + 3 * sizeof(double));
+	CHECK(file.substr(0, 8) == "C6771VEC");
+	auto magnitudes = std::vector<double>(3);
+	std::memcpy(magnitudes.data(), file.data() + 64, 3 * sizeof(double));
+	CHECK(magnitudes == std::vector<double>{1.5, -2.0, 0.1});
+
+	CHECK(comp6771::load_vector(ss) == v);
+
+	SECTION("Float and empty vectors") {
+		auto const f = comp6771::float_euclidean_vector{0.1F, 3.0F};
+		auto fs = std::stringstream();
+		comp6771::save(fs, f);
+		CHECK(fs.str().size() == 64 + 2 * sizeof(float));
+		CHECK(comp6771::load_vector<float>(fs) == f);
+
+		// a file can hold no vectors, but not vectors with no dimensions
+		auto es = std::stringstream();
+		comp6771::save(es, std::vector<comp6771::euclidean_vector>());
+		CHECK(comp6771::load_vectors(es).empty());
+		CHECK_THROWS_WITH(comp6771::save(es, comp6771::euclidean_vector(0)),
+		                  "euclidean_vector binary files cannot hold vectors with no dimensions");
+		CHECK_THROWS_WITH(comp6771::save(es, comp6771::euclidean_vector_batch(4, 0)),
+		                  "euclidean_vector binary files cannot hold vectors with no dimensions");
+		auto writer = comp6771::binary_writer(es, 0);
+		CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector_view(nullptr, 0)),
+		                  "euclidean_vector binary files cannot hold vectors with no dimensions");
+	}
+}
+
+TEST_CASE("Binary collections", "[binary_format]") {
+	auto const batch = sample_batch();
+	auto vectors = std::vector<comp6771::euclidean_vector>();
+	for (auto row = 0; row < batch.rows(); ++row) {
+		vectors.emplace_back(batch[row]);
+	}
+
+	SECTION("A span and a batch write the same file") {
+		auto oss = std::ostringstream();
+		comp6771::save(oss, std::span<comp6771::euclidean_vector const>(vectors));
+		CHECK(oss.str() == saved(batch));
+		CHECK(oss.str().size() == 64 + 15 * sizeof(double));
+	}
+
+	SECTION("Loading as vectors and as a batch") {
+		auto ss = std::stringstream(saved(batch));
+		CHECK(comp6771::load_vectors(ss) == vectors);
+
+		ss = std::stringstream(saved(batch));
+		auto const loaded = comp6771::load_batch(ss);
+		REQUIRE(loaded.rows() == 5);
+		REQUIRE(loaded.dimensions() == 3);
+		for (auto row = 0; row < loaded.rows(); ++row) {
+			CHECK(comp6771::euclidean_vector(loaded[row]) == vectors[static_cast<std::size_t>(row)]);
+		}
+	}
+
+	SECTION("Files written back to back load one after another") {
+		auto ss = std::stringstream();
+		comp6771::save(ss, batch);
+		comp6771::save(ss, vectors[2]);
+		comp6771::save(ss, std::span<comp6771::euclidean_vector const>());
+		CHECK(comp6771::load_batch(ss).rows() == 5);
+		CHECK(comp6771::load_vector(ss) == vectors[2]);
+		CHECK(comp6771::load_vectors(ss).empty());
+		CHECK(ss.peek() == std::char_traits<char>::eof());
+	}
+}
+
+TEST_CASE("Binary conversions", "[binary_format]") {
+	auto const floats = std::vector<comp6771::float_euclidean_vector>{{0.1F, -2.5F}, {3.0F, 1e-3F}};
+	auto ss = std::stringstream();
+	comp6771::save(ss, std::span<comp6771::float_euclidean_vector const>(floats));
+	auto const float_file = ss.str();
+
+	SECTION("Scalar sizes") {
+		auto const doubles = comp6771::load_vectors(ss);
+		REQUIRE(doubles.size() == 2);
+		CHECK(doubles[0] == comp6771::euclidean_vector{double{0.1F}, -2.5});
+		CHECK(doubles[1][1] == double{1e-3F});
+
+		auto ds = std::stringstream(saved(sample_batch()));
+		auto const narrowed = comp6771::load_vectors<float>(ds);
+		CHECK(narrowed[0] == comp6771::float_euclidean_vector{0.5F, -0.0F, 1.0F / 3.0F});
+	}
+
+	SECTION("Byte orders") {
+		auto fs = std::stringstream(byte_swapped(float_file, sizeof(float)));
+		CHECK(comp6771::load_vectors<float>(fs) == floats);
+
+		auto const batch = sample_batch();
+		auto ds = std::stringstream(byte_swapped(saved(batch), sizeof(double)));
+		auto const loaded = comp6771::load_batch(ds);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(comp6771::euclidean_vector(loaded[row]) == comp6771::euclidean_vector(batch[row]));
+		}
+	}
+}
+
+TEST_CASE("Binary file views", "[binary_format]") {
+	auto const batch = sample_batch();
+	auto const file = saved(batch);
+	auto const storage = aligned_copy(file);
+	auto const view = comp6771::vector_file_view(as_bytes(storage, file.size()));
+
+	CHECK(view.size() == 5);
+	CHECK(view.dimensions() == 3);
+	// the rows point into the bytes rather than at a copy
+	CHECK(view.data() == storage.data() + 8);
+	CHECK(view[4].data() == storage.data() + 8 + 12);
+	for (auto row = 0; row < view.size(); ++row) {
+		CHECK(comp6771::euclidean_vector(view.at(row)) == comp6771::euclidean_vector(batch[row]));
+		CHECK(comp6771::dot(view[row], batch[row]) == comp6771::dot(batch[row], batch[row]));
+	}
+	CHECK(comp6771::euclidean_norm(view[1]) == Approx(std::sqrt(1.5 * 1.5 + 4.0 + 0.0625)));
+
+	// trailing bytes after the vectors are allowed, like a file in a larger mapping
+	auto const longer = aligned_copy(file + std::string(16, '\0'));
+	CHECK(comp6771::vector_file_view(as_bytes(longer, file.size() + 16)).size() == 5);
+}
+
+TEST_CASE("Binary streaming", "[binary_format]") {
+	auto const batch = sample_batch();
+
+	SECTION("binary_writer writes what save() writes") {
+		auto ss = std::stringstream();
+		ss << "prefix";
+		auto writer = comp6771::binary_writer(ss, 3);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			writer.write(batch[row]);
+		}
+		writer.finish();
+		CHECK(writer.rows() == 5);
+		CHECK(ss.str() == "prefix" + saved(batch));
+
+		// the stream is left at the end, ready for more
+		ss << "suffix";
+		CHECK(ss.str().ends_with("suffix"));
+	}
+
+	SECTION("binary_reader reads one row at a time") {
+		auto ss = std::stringstream(byte_swapped(saved(batch), sizeof(double)));
+		auto reader = comp6771::binary_reader(ss);
+		CHECK(reader.size() == 5);
+		CHECK(reader.dimensions() == 3);
+
+		auto row = comp6771::euclidean_vector(3);
+		auto out = comp6771::mutable_euclidean_vector_view(row.data_mut(), 3);
+		for (auto i = 0; i < batch.rows(); ++i) {
+			CHECK(reader.remaining() == 5 - i);
+			REQUIRE(reader.read(out));
+			CHECK(row == comp6771::euclidean_vector(batch[i]));
+		}
+		CHECK(not reader.read(out));
+		CHECK(reader.remaining() == 0);
+	}
+}
+
+TEST_CASE("Binary exception handling", "[binary_format]") {
+	auto const file = saved(sample_batch());
+
+	SECTION("Saving") {
+		auto const mixed = std::vector<comp6771::euclidean_vector>{{1.0, 2.0}, {3.0}};
+		auto oss = std::ostringstream();
+		CHECK_THROWS_WITH(comp6771::save(oss, std::span<comp6771::euclidean_vector const>(mixed)),
+		                  "Dimensions of LHS(2) and RHS(1) do not match");
+		CHECK(oss.str().empty());
+
+		oss.setstate(std::ios_base::badbit);
+		CHECK_THROWS_WITH(comp6771::save(oss, mixed[0]),
+		                  "Could not write the euclidean_vector binary file");
+	}
+
+	SECTION("Loading") {
+		auto const load = [](std::string const& text) {
+			auto ss = std::stringstream(text);
+			return comp6771::load_vectors(ss);
+		};
+		auto corrupt = file;
+		corrupt[3] = 'X';
+		CHECK_THROWS_WITH(load(corrupt), "Not a euclidean_vector binary file");
+		corrupt = file;
+		corrupt[8] = 7;
+		CHECK_THROWS_WITH(load(corrupt), "Unsupported euclidean_vector binary file version 7");
+		corrupt = file;
+		corrupt[16] = 2;
+		CHECK_THROWS_WITH(load(corrupt), "Unsupported euclidean_vector binary file scalar size 2");
+		corrupt = file;
+		corrupt[39] = 1;
+		CHECK_THROWS_WITH(load(corrupt),
+		                  "euclidean_vector binary file holds 72057594037927941 vectors of "
+		                  "dimension 3, more than an int can index");
+		CHECK_THROWS_WITH(load(file.substr(0, 40)), "euclidean_vector binary file is truncated");
+		CHECK_THROWS_WITH(load(file.substr(0, file.size() - 1)),
+		                  "euclidean_vector binary file is truncated");
+
+		auto ss = std::stringstream(file);
+		CHECK_THROWS_WITH(comp6771::load_vector(ss),
+		                  "euclidean_vector binary file holds 5 vectors, not 1");
+	}
+
+	SECTION("Streaming") {
+		auto truncated = file.substr(0, 64 + 8 * 3 + 4);
+		auto ss = std::stringstream(truncated);
+		CHECK_THROWS_WITH(comp6771::binary_reader(ss), "euclidean_vector binary file is truncated");
+
+		auto pipe = pipe_stream(truncated);
+		auto reader = comp6771::binary_reader(pipe);
+		auto row = comp6771::euclidean_vector(3);
+		CHECK(reader.read(comp6771::mutable_euclidean_vector_view(row.data_mut(), 3)));
+		CHECK_THROWS_WITH(reader.read(comp6771::mutable_euclidean_vector_view(row.data_mut(), 3)),
+		                  "euclidean_vector binary file is truncated");
+		CHECK_THROWS_WITH(reader.read(comp6771::mutable_euclidean_vector_view(row.data_mut(), 2)),
+		                  "Dimensions of LHS(3) and RHS(2) do not match");
+
+		auto oss = std::ostringstream();
+		auto writer = comp6771::binary_writer(oss, 2);
+		CHECK_THROWS_WITH(writer.write(row), "Dimensions of LHS(2) and RHS(3) do not match");
+	}
+
+	SECTION("Views") {
+		auto const storage = aligned_copy(file);
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(storage, file.size() - 8)),
+		                  "euclidean_vector binary file is truncated");
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(storage, 10)),
+		                  "euclidean_vector binary file is truncated");
+
+		auto const shifted = aligned_copy(file, 4);
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(shifted, file.size(), 4)),
+		                  "vector_file_view needs 8-byte aligned bytes");
+
+		auto const swapped_file = byte_swapped(file, sizeof(double));
+		auto const swapped = aligned_copy(swapped_file);
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(swapped, swapped_file.size())),
+		                  "vector_file_view needs a file in this machine's byte order; use "
+		                  "load_batch() to convert it");
+
+		auto oss = std::ostringstream();
+		comp6771::save(oss, comp6771::float_euclidean_vector{1.0F, 2.0F});
+		auto const float_file = oss.str();
+		auto const floats = aligned_copy(float_file);
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(floats, float_file.size())),
+		                  "vector_file_view needs a file of doubles, not 4-byte scalars");
+
+		auto const view = comp6771::vector_file_view(as_bytes(storage, file.size()));
+		CHECK_THROWS_WITH(view.at(5), "Row 5 is not valid for this vector_file_view object");
+		CHECK_THROWS_WITH(view.at(-1), "Row -1 is not valid for this vector_file_view object");
+	}
+}
+
+TEST_CASE("Binary headers that claim too much", "[binary_format]") {
+	auto const file = saved(sample_batch());
+
+	SECTION("A payload larger than memory can address") {
+		auto const huge = with_shape(file, INT_MAX, INT_MAX);
+		auto const message = std::string("euclidean_vector binary file holds 2147483647 vectors of "
+		                                 "dimension 2147483647, more bytes than memory can address");
+		auto ss = std::stringstream(huge);
+		CHECK_THROWS_WITH(comp6771::load_batch(ss), message);
+		auto pipe = pipe_stream(huge);
+		CHECK_THROWS_WITH(comp6771::load_vectors(pipe), message);
+
+		auto const storage = aligned_copy(huge);
+		CHECK_THROWS_WITH(comp6771::vector_file_view(as_bytes(storage, huge.size())), message);
+	}
+
+	SECTION("A seekable stream with less payload than the header claims") {
+		auto const truncated = std::string("euclidean_vector binary file is truncated");
+		auto ss = std::stringstream(with_shape(file.substr(0, 64), INT_MAX, 1));
+		CHECK_THROWS_WITH(comp6771::load_vector(ss), truncated);
+		ss = std::stringstream(with_shape(file, 3, INT_MAX));
+		CHECK_THROWS_WITH(comp6771::load_vectors(ss), truncated);
+		ss = std::stringstream(with_shape(file, 3, INT_MAX));
+		CHECK_THROWS_WITH(comp6771::load_batch(ss), truncated);
+		ss = std::stringstream(with_shape(file, 3, 6));
+		CHECK_THROWS_WITH(comp6771::binary_reader(ss), truncated);
+		// rows of INT_MAX doubles pad to 2^31, so a batch of 2^30 of them is 2^64 bytes
+		ss = std::stringstream(with_shape(file, INT_MAX, std::uint64_t{1} << 30));
+		CHECK_THROWS_WITH(comp6771::load_batch(ss), truncated);
+
+		// the check starts where the file starts, not at the beginning of the stream
+		ss = std::stringstream(file + file);
+		CHECK(comp6771::load_batch(ss).rows() == 5);
+		CHECK(comp6771::load_batch(ss).rows() == 5);
+	}
+
+	SECTION("A stream that can't seek with less payload than the header claims") {
+		auto const truncated = std::string("euclidean_vector binary file is truncated");
+		auto vector_pipe = pipe_stream(with_shape(file.substr(0, 64), INT_MAX, 1));
+		CHECK_THROWS_WITH(comp6771::load_vector(vector_pipe), truncated);
+		auto vectors_pipe = pipe_stream(with_shape(file, 3, INT_MAX));
+		CHECK_THROWS_WITH(comp6771::load_vectors<float>(vectors_pipe), truncated);
+		auto batch_pipe = pipe_stream(with_shape(file, INT_MAX, std::uint64_t{1} << 30));
+		CHECK_THROWS_WITH(comp6771::load_batch(batch_pipe), truncated);
+	}
+
+	SECTION("Vectors with no dimensions, which need no payload") {
+		auto const empty_rows = with_shape(file.substr(0, 64), 0, INT_MAX);
+		auto ss = std::stringstream(empty_rows);
+		CHECK_THROWS_WITH(comp6771::load_vectors(ss), "Not a euclidean_vector binary file");
+		auto pipe = pipe_stream(empty_rows);
+		CHECK_THROWS_WITH(comp6771::load_vectors<float>(pipe), "Not a euclidean_vector binary file");
+		ss = std::stringstream(with_shape(file.substr(0, 64), 0, 1));
+		CHECK_THROWS_WITH(comp6771::load_vector(ss), "Not a euclidean_vector binary file");
+	}
+
+	SECTION("A stream that can't seek loads like one that can") {
+		auto const batch = sample_batch();
+		auto pipe = pipe_stream(file + byte_swapped(file, sizeof(double)) + file);
+		auto const vectors = comp6771::load_vectors(pipe);
+		auto const swapped = comp6771::load_batch(pipe);
+		REQUIRE(vectors.size() == 5);
+		REQUIRE(swapped.rows() == 5);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(vectors[static_cast<std::size_t>(row)] == comp6771::euclidean_vector(batch[row]));
+			CHECK(comp6771::euclidean_vector(swapped[row]) == comp6771::euclidean_vector(batch[row]));
+		}
+		CHECK_THROWS_WITH(comp6771::load_vector(pipe),
+		                  "euclidean_vector binary file holds 5 vectors, not 1");
+
+		auto oss = std::ostringstream();
+		comp6771::save(oss, vectors);
+		auto const one = with_shape(oss.str().substr(0, 64 + 3 * sizeof(double)), 3, 1);
+		auto one_pipe = pipe_stream(one);
+		CHECK(comp6771::load_vector(one_pipe) == vectors[0]);
+	}
+}
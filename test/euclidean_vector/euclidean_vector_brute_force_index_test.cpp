@@ -0,0 +1,198 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the BruteForceIndex class.
+//      The test cases are:
+//          1. test construction and add()
+//          2. test single queries against a direct ranking for every metric
+//          3. test that batched queries match single queries
+//          4. test k of zero, k larger than the database and ties
+//          5. test the exception handling
+
+#include <comp6771/brute_force_index.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+	auto random_vectors(int count, int dimension, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto value = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = comp6771::euclidean_vector(dimension);
+			for (auto j = 0; j < dimension; ++j) {
+				v[j] = value(engine);
+			}
+			vectors.push_back(v);
+		}
+		return vectors;
+	}
+
+	// Ranks every vector with the public utility functions, best first.
+	auto direct_ranking(std::vector<comp6771::euclidean_vector> const& database,
+	                    comp6771::euclidean_vector const& query,
+	                    comp6771::metric m) -> std::vector<comp6771::neighbour> {
+		auto ranking = std::vector<comp6771::neighbour>();
+		for (auto id = 0; id < static_cast<int>(database.size()); ++id) {
+			auto const& x = database[static_cast<std::size_t>(id)];
+			switch (m) {
+			case comp6771::metric::l2: ranking.push_back({id, comp6771::distance(query, x)}); break;
+			case comp6771::metric::inner_product:
+				ranking.push_back({id, comp6771::dot(query, x)});
+				break;
+			case comp6771::metric::cosine:
+				ranking.push_back({id, comp6771::cosine_similarity(query, x)});
+				break;
+			}
+		}
+		auto const sign = m == comp6771::metric::l2 ? 1.0 : -1.0;
+		std::stable_sort(ranking.begin(), ranking.end(), [sign](auto const& a, auto const& b) {
+			return sign * a.score < sign * b.score;
+		});
+		return ranking;
+	}
+} // namespace
+
+TEST_CASE("Brute force index construction", "[brute_force_index]") {
+	auto const vectors = random_vectors(5, 3, 1);
+
+	SECTION("From vectors and from a batch") {
+		auto const index = comp6771::brute_force_index(vectors);
+		CHECK(index.size() == 5);
+		CHECK(index.dimensions() == 3);
+		CHECK(index.distance_metric() == comp6771::metric::l2);
+		CHECK(comp6771::euclidean_vector(index.database()[4]) == vectors[4]);
+
+		auto const batch = comp6771::euclidean_vector_batch(vectors);
+		auto const cosine = comp6771::brute_force_index(batch, comp6771::metric::cosine);
+		CHECK(cosine.size() == 5);
+		CHECK(cosine.distance_metric() == comp6771::metric::cosine);
+	}
+
+	SECTION("Add") {
+		auto index = comp6771::brute_force_index(vectors);
+		index.add(comp6771::euclidean_vector{100.0, 100.0, 100.0});
+		CHECK(index.size() == 6);
+
+		auto const found = index.search(comp6771::euclidean_vector{99.0, 100.0, 100.0}, 1);
+		REQUIRE(found.size() == 1);
+		CHECK(found[0].id == 5);
+		CHECK(found[0].score == Approx(1.0));
+	}
+}
+
+TEST_CASE("Brute force index single queries", "[brute_force_index]") {
+	// enough rows that the scan covers several blocks
+	auto const database = random_vectors(3000, 37, 2);
+	auto const queries = random_vectors(5, 37, 3);
+
+	for (auto const m :
+	     {comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine}) {
+		INFO("metric " << static_cast<int>(m));
+		auto const index = comp6771::brute_force_index(database, m);
+		for (auto const& query : queries) {
+			auto const found = index.search(query, 10);
+			auto const expected = direct_ranking(database, query, m);
+			REQUIRE(found.size() == 10);
+			for (auto i = std::size_t{0}; i < found.size(); ++i) {
+				CHECK(found[i].id == expected[i].id);
+				CHECK(found[i].score == Approx(expected[i].score).margin(1e-9));
+			}
+		}
+	}
+
+	SECTION("A row equal to the query") {
+		auto const index = comp6771::brute_force_index(database);
+		auto const found = index.search(database[1234], 1);
+		CHECK(found[0].id == 1234);
+		CHECK(found[0].score == Approx(0.0).margin(1e-6));
+	}
+}
+
+TEST_CASE("Brute force index batched queries", "[brute_force_index]") {
+	auto const database = random_vectors(2000, 20, 4);
+	auto const queries = random_vectors(17, 20, 5);
+	auto const batch = comp6771::euclidean_vector_batch(queries);
+
+	for (auto const m :
+	     {comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine}) {
+		INFO("metric " << static_cast<int>(m));
+		auto const index = comp6771::brute_force_index(database, m);
+		auto const found = index.search(batch, 7);
+		REQUIRE(found.size() == queries.size());
+		for (auto i = 0; i < batch.rows(); ++i) {
+			auto const single = index.search(batch[i], 7);
+			auto const& batched = found[static_cast<std::size_t>(i)];
+			REQUIRE(batched.size() == single.size());
+			for (auto j = std::size_t{0}; j < single.size(); ++j) {
+				CHECK(batched[j].id == single[j].id);
+				CHECK(batched[j].score == Approx(single[j].score));
+			}
+		}
+	}
+
+	auto const index = comp6771::brute_force_index(database);
+	CHECK(index.search(comp6771::euclidean_vector_batch(0, 20), 3).empty());
+}
+
+TEST_CASE("Brute force index edge cases", "[brute_force_index]") {
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1.0, 0.0},
+	                                                             {0.0, 1.0},
+	                                                             {1.0, 0.0},
+	                                                             {2.0, 0.0}};
+	auto const index = comp6771::brute_force_index(vectors);
+	auto const query = comp6771::euclidean_vector{1.0, 0.0};
+
+	SECTION("k of zero and k larger than the database") {
+		CHECK(index.search(query, 0).empty());
+		auto const found = index.search(query, 100);
+		REQUIRE(found.size() == 4);
+		CHECK(found.back().id == 1);
+	}
+
+	SECTION("Ties go to the lower id") {
+		auto const found = index.search(query, 2);
+		CHECK(found == std::vector<comp6771::neighbour>{{0, 0.0}, {2, 0.0}});
+
+		auto const cosine = comp6771::brute_force_index(vectors, comp6771::metric::cosine);
+		auto const similar = cosine.search(query, 3);
+		CHECK(similar[0].id == 0);
+		CHECK(similar[1].id == 2);
+		CHECK(similar[2].id == 3);
+		CHECK(similar[2].score == 1.0);
+	}
+
+	SECTION("An empty database") {
+		auto const empty = comp6771::brute_force_index(comp6771::euclidean_vector_batch(0, 2));
+		CHECK(empty.search(query, 3).empty());
+	}
+}
+
+TEST_CASE("Brute force index exception handling", "[brute_force_index]") {
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1.0, 0.0}, {0.0, 1.0}};
+	auto index = comp6771::brute_force_index(vectors);
+
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0, 3.0}, 1),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector_batch(2, 3), 1),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(index.add(comp6771::euclidean_vector{1.0}),
+	                  "Dimensions of LHS(2) and RHS(1) do not match");
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0}, -1),
+	                  "Cannot search for -1 neighbours");
+
+	// cosine similarity is undefined for a zero vector in the database or the query
+	auto const* const undefined =
+	   "euclidean_vector with zero euclidean normal does not have a cosine similarity";
+	auto const zero = std::vector<comp6771::euclidean_vector>{{1.0, 0.0}, {0.0, 0.0}};
+	CHECK_THROWS_WITH(comp6771::brute_force_index(zero, comp6771::metric::cosine), undefined);
+	auto cosine = comp6771::brute_force_index(vectors, comp6771::metric::cosine);
+	CHECK_THROWS_WITH(cosine.search(comp6771::euclidean_vector(2), 1), undefined);
+	CHECK_THROWS_WITH(cosine.add(comp6771::euclidean_vector(2)), undefined);
+	CHECK(cosine.size() == 2);
+}
@@ -0,0 +1,94 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test const access to a euclidean_vector shared between threads.
+//      It is meant to be run under ThreadSanitizer as well as on its own.
+//      The test cases are:
+//          1. test concurrent euclidean_norm(), unit(), dot() and reads on a shared vector
+//          2. test concurrent euclidean_norm() in the incremental norm mode
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <latch>
+#include <thread>
+#include <vector>
+
+namespace {
+	constexpr auto thread_count = 8;
+	constexpr auto rounds = 200;
+
+	// Runs `work(thread)` on thread_count threads that all start together, to give the cache
+	// stores the best chance of overlapping.
+	template<typename F>
+	auto run_together(F work) -> void {
+		auto start = std::latch(thread_count);
+		auto threads = std::vector<std::jthread>();
+		for (auto i = 0; i < thread_count; ++i) {
+			threads.emplace_back([&start, &work, i] {
+				start.arrive_and_wait();
+				work(i);
+			});
+		}
+	}
+
+	auto make_vector(int dimension) -> comp6771::euclidean_vector {
+		auto v = comp6771::euclidean_vector(dimension);
+		for (auto i = 0; i < dimension; ++i) {
+			v.set(i, static_cast<double>(i % 7) - 3.0);
+		}
+		return v;
+	}
+} // namespace
+
+TEST_CASE("Concurrent const access", "[concurrency]") {
+	auto const v1 = make_vector(4096);
+	auto const expected = std::sqrt(comp6771::dot(v1, v1));
+	auto results = std::vector<int>(thread_count);
+
+	// Each round takes a fresh copy with no cached norm, shared by every thread.
+	for (auto round = 0; round < rounds / 20; ++round) {
+		auto const shared = v1;
+		run_together([&](int thread) {
+			auto matches = 0;
+			for (auto i = 0; i < rounds; ++i) {
+				matches += comp6771::euclidean_norm(shared) == Approx(expected) ? 1 : 0;
+				matches += shared[i] == v1[i] ? 1 : 0;
+				matches += comp6771::dot(shared, v1) == Approx(expected * expected) ? 1 : 0;
+			}
+			matches += comp6771::unit(shared).dimensions() == 4096 ? 1 : 0;
+			results[static_cast<std::size_t>(thread)] = matches;
+		});
+
+		for (auto const matches : results) {
+			CHECK(matches == 3 * rounds + 1);
+		}
+	}
+}
+
+TEST_CASE("Concurrent incremental norm", "[concurrency]") {
+	auto v1 = make_vector(4096);
+	v1.set_incremental_norm(true);
+	auto norms = std::vector<double>(thread_count);
+
+	for (auto round = 0; round < rounds / 20; ++round) {
+		// writes happen between the concurrent phases, never during them
+		v1[round] = 100.0 + round;
+		auto const& shared = v1;
+		auto const expected = std::sqrt(comp6771::dot(shared, shared));
+
+		run_together([&](int thread) {
+			auto norm = 0.0;
+			for (auto i = 0; i < rounds; ++i) {
+				norm = comp6771::euclidean_norm(shared);
+			}
+			norms[static_cast<std::size_t>(thread)] = norm;
+		});
+
+		for (auto const norm : norms) {
+			CHECK(norm == Approx(expected).epsilon(1e-12));
+		}
+	}
+}
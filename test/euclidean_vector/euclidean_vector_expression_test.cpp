@@ -0,0 +1,111 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the lazy expression templates of EuclideanVector class.
+//      The test cases are:
+//          1. test constructing and assigning from an expression
+//          2. test fused compound addition and subtraction
+//          3. test euclidean_norm() and dot() on expressions
+//          4. test the exception handling while building an expression
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <type_traits>
+
+TEST_CASE("Construct from an expression", "[expression]") {
+	auto const a = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const b = comp6771::euclidean_vector{4.0, 5.0, 6.0};
+	auto const c = comp6771::euclidean_vector{0.5, 0.5, 0.5};
+
+	SECTION("Mixed operators") {
+		auto const v = comp6771::euclidean_vector(comp6771::lazy(a) + comp6771::lazy(b) * 2.0 - c);
+		CHECK(v == a + b * 2.0 - c);
+	}
+
+	SECTION("Only explicit construction evaluates an expression") {
+		using expression = decltype(-comp6771::lazy(a) / 2.0);
+		STATIC_REQUIRE(std::is_constructible_v<comp6771::euclidean_vector, expression>);
+		STATIC_REQUIRE(not std::is_convertible_v<expression, comp6771::euclidean_vector>);
+		auto const v = comp6771::euclidean_vector(-comp6771::lazy(a) / 2.0);
+		CHECK(v == comp6771::euclidean_vector{-0.5, -1.0, -1.5});
+	}
+
+	SECTION("Plain vector on the left") {
+		auto const v = comp6771::euclidean_vector(b - comp6771::lazy(a));
+		CHECK(v == comp6771::euclidean_vector{3.0, 3.0, 3.0});
+	}
+
+	SECTION("Heap-sized vectors") {
+		auto const large_a = comp6771::euclidean_vector(100, 1.5);
+		auto const large_b = comp6771::euclidean_vector(100, 2.0);
+		auto const v = comp6771::euclidean_vector(comp6771::lazy(large_a) * 2.0 + large_b);
+		CHECK(v == comp6771::euclidean_vector(100, 5.0));
+	}
+}
+
+TEST_CASE("Assign from an expression", "[expression]") {
+	auto a = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const b = comp6771::euclidean_vector{4.0, 5.0, 6.0};
+
+	SECTION("Same dimension") {
+		auto v = comp6771::euclidean_vector(3);
+		v = comp6771::lazy(a) + b;
+		CHECK(v == comp6771::euclidean_vector{5.0, 7.0, 9.0});
+	}
+
+	SECTION("Different dimension") {
+		auto v = comp6771::euclidean_vector(20);
+		v = comp6771::lazy(a) + b;
+		CHECK(v == comp6771::euclidean_vector{5.0, 7.0, 9.0});
+	}
+
+	SECTION("Target appears in the expression") {
+		a = comp6771::lazy(a) * 3.0 - b;
+		CHECK(a == comp6771::euclidean_vector{-1.0, 1.0, 3.0});
+	}
+
+	SECTION("Cached norm is invalidated") {
+		CHECK(comp6771::euclidean_norm(a) == Approx(std::sqrt(14.0)));
+		a = comp6771::lazy(a) * 2.0;
+		CHECK(comp6771::euclidean_norm(a) == Approx(2.0 * std::sqrt(14.0)));
+	}
+}
+
+TEST_CASE("Fused compound operators", "[expression]") {
+	auto position = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const velocity = comp6771::euclidean_vector{2.0, -2.0, 4.0};
+
+	position += comp6771::lazy(velocity) * 0.5;
+	CHECK(position == comp6771::euclidean_vector{2.0, 1.0, 5.0});
+
+	position -= comp6771::lazy(velocity) * 0.5 + velocity;
+	CHECK(position == comp6771::euclidean_vector{-1.0, 4.0, -1.0});
+}
+
+TEST_CASE("Reductions on expressions", "[expression]") {
+	auto const a = comp6771::euclidean_vector{3.0, 0.0, 1.0};
+	auto const b = comp6771::euclidean_vector{0.0, 4.0, 1.0};
+
+	CHECK(comp6771::euclidean_norm(comp6771::lazy(a) - b) == Approx(5.0));
+	CHECK(comp6771::dot(comp6771::lazy(a) * 2.0, b) == Approx(2.0));
+	CHECK(comp6771::dot(a, comp6771::lazy(b) + a) == Approx(11.0));
+
+	auto const empty = comp6771::euclidean_vector(0);
+	CHECK(comp6771::euclidean_norm(comp6771::lazy(empty)) == 0.0);
+}
+
+TEST_CASE("Expression exception handling", "[expression]") {
+	auto const a = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const b = comp6771::euclidean_vector(4);
+
+	CHECK_THROWS_WITH(comp6771::lazy(a) + b, "Dimensions of LHS(3) and RHS(4) do not match");
+	CHECK_THROWS_WITH(b - comp6771::lazy(a), "Dimensions of LHS(4) and RHS(3) do not match");
+	CHECK_THROWS_WITH(comp6771::lazy(a) / 0.0, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(comp6771::dot(comp6771::lazy(a), b),
+	                  "Dimensions of LHS(3) and RHS(4) do not match");
+
+	auto v = comp6771::euclidean_vector(4);
+	CHECK_THROWS_WITH(v += comp6771::lazy(a), "Dimensions of LHS(4) and RHS(3) do not match");
+}
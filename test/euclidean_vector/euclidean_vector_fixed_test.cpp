@@ -0,0 +1,112 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the compile-time fixed_euclidean_vector<N> class.
+//      The test cases are:
+//          1. test the constructors in constant expressions
+//          2. test the operators and utility functions in constant expressions
+//          3. test that mismatched dimensions do not compile
+//          4. test conversion to and from euclidean_vector
+//          5. test the exception handling
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace {
+	template<typename A, typename B>
+	concept addable = requires(A a, B b) {
+		a + b;
+	};
+} // namespace
+
+TEST_CASE("Fixed constructors", "[fixed]") {
+	constexpr auto v1 = comp6771::fixed_euclidean_vector<3>();
+	constexpr auto v2 = comp6771::fixed_euclidean_vector<3>(1.5);
+	constexpr auto v3 = comp6771::fixed_euclidean_vector{1.0, 2.0, 3.0};
+
+	STATIC_REQUIRE(v1 == comp6771::fixed_euclidean_vector{0.0, 0.0, 0.0});
+	STATIC_REQUIRE(v2 == comp6771::fixed_euclidean_vector{1.5, 1.5, 1.5});
+	STATIC_REQUIRE(v3[2] == 3.0);
+	STATIC_REQUIRE(v3.at(1) == 2.0);
+	STATIC_REQUIRE(decltype(v3)::dimensions() == 3);
+	STATIC_REQUIRE(sizeof(comp6771::fixed_euclidean_vector<4>) == 4 * sizeof(double));
+}
+
+TEST_CASE("Fixed operators", "[fixed]") {
+	constexpr auto a = comp6771::fixed_euclidean_vector{1.0, 2.0, 3.0};
+	constexpr auto b = comp6771::fixed_euclidean_vector{4.0, 5.0, 6.0};
+
+	STATIC_REQUIRE(a + b == comp6771::fixed_euclidean_vector{5.0, 7.0, 9.0});
+	STATIC_REQUIRE(b - a == comp6771::fixed_euclidean_vector{3.0, 3.0, 3.0});
+	STATIC_REQUIRE(a * 2.0 == comp6771::fixed_euclidean_vector{2.0, 4.0, 6.0});
+	STATIC_REQUIRE(b / 2.0 == comp6771::fixed_euclidean_vector{2.0, 2.5, 3.0});
+	STATIC_REQUIRE(-a == comp6771::fixed_euclidean_vector{-1.0, -2.0, -3.0});
+	STATIC_REQUIRE(+a == a);
+	STATIC_REQUIRE(a != b);
+	STATIC_REQUIRE(comp6771::dot(a, b) == 32.0);
+	STATIC_REQUIRE(comp6771::euclidean_norm(comp6771::fixed_euclidean_vector{3.0, 4.0}) == 5.0);
+	STATIC_REQUIRE(comp6771::squared_distance(a, b) == 27.0);
+	STATIC_REQUIRE(comp6771::distance(comp6771::fixed_euclidean_vector{1.0, 1.0},
+	                                  comp6771::fixed_euclidean_vector{4.0, 5.0})
+	               == 5.0);
+	STATIC_REQUIRE(comp6771::cosine_similarity(comp6771::fixed_euclidean_vector{3.0, 4.0},
+	                                           comp6771::fixed_euclidean_vector{6.0, 8.0})
+	               == 1.0);
+	STATIC_REQUIRE(comp6771::cosine_distance(comp6771::fixed_euclidean_vector{1.0, 0.0},
+	                                         comp6771::fixed_euclidean_vector{0.0, 1.0})
+	               == 1.0);
+	STATIC_REQUIRE(comp6771::unit(comp6771::fixed_euclidean_vector{0.0, 2.0})
+	               == comp6771::fixed_euclidean_vector{0.0, 1.0});
+
+	CHECK(comp6771::euclidean_norm(a) == Approx(std::sqrt(14.0)));
+	CHECK(comp6771::euclidean_norm(comp6771::fixed_euclidean_vector<100>(1.0)) == Approx(10.0));
+
+	auto c = a;
+	c += b;
+	c -= a;
+	c *= 3.0;
+	c /= 3.0;
+	CHECK(c == b);
+}
+
+TEST_CASE("Fixed dimension mismatch does not compile", "[fixed]") {
+	STATIC_REQUIRE(addable<comp6771::fixed_euclidean_vector<3>, comp6771::fixed_euclidean_vector<3>>);
+	STATIC_REQUIRE_FALSE(
+	   addable<comp6771::fixed_euclidean_vector<3>, comp6771::fixed_euclidean_vector<4>>);
+}
+
+TEST_CASE("Fixed conversions", "[fixed]") {
+	auto const fixed = comp6771::fixed_euclidean_vector{14.3, 26.5, -12.8, 2.1};
+	auto const dynamic = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
+
+	CHECK(static_cast<comp6771::euclidean_vector>(fixed) == dynamic);
+	CHECK(comp6771::fixed_euclidean_vector<4>(dynamic) == fixed);
+	CHECK(static_cast<std::vector<double>>(fixed) == static_cast<std::vector<double>>(dynamic));
+	CHECK(static_cast<std::list<double>>(fixed) == static_cast<std::list<double>>(dynamic));
+
+	auto ss = std::stringstream{};
+	ss << fixed;
+	CHECK(ss.str() == "[14.3 26.5 -12.8 2.1]");
+	ss.str(std::string{});
+	ss << comp6771::fixed_euclidean_vector<0>();
+	CHECK(ss.str() == "[]");
+}
+
+TEST_CASE("Fixed exception handling", "[fixed]") {
+	auto v = comp6771::fixed_euclidean_vector{1.0, 2.0};
+	auto const dynamic = comp6771::euclidean_vector(3);
+
+	CHECK_THROWS_WITH(v.at(2), "Index 2 is not valid for this euclidean_vector object");
+	CHECK_THROWS_WITH(v / 0.0, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(comp6771::unit(comp6771::fixed_euclidean_vector<2>()),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK_THROWS_WITH(comp6771::cosine_similarity(v, comp6771::fixed_euclidean_vector<2>()),
+	                  "euclidean_vector with zero euclidean normal does not have a cosine "
+	                  "similarity");
+	CHECK_THROWS_WITH(comp6771::fixed_euclidean_vector<2>(dynamic),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+}
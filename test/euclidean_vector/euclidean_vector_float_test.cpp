@@ -0,0 +1,84 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the float instantiation of the EuclideanVector class.
+//      The test cases are:
+//          1. test the constructors, operators and type conversions
+//          2. test that dot(), euclidean_norm() and distance() accumulate in double
+//          3. test unit()
+//          4. test the exception handling
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <list>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("Float constructors and operators", "[float]") {
+	static_assert(
+	   std::is_same_v<comp6771::euclidean_vector, comp6771::basic_euclidean_vector<double>>);
+	static_assert(std::is_same_v<comp6771::float_euclidean_vector::value_type, float>);
+
+	auto const values = std::vector<float>{1.5F, -2.0F, 3.25F};
+	auto const v1 = comp6771::float_euclidean_vector(values.begin(), values.end());
+	auto const v2 = comp6771::float_euclidean_vector{0.5F, 2.0F, 0.75F};
+
+	SECTION("Constructors") {
+		CHECK(comp6771::float_euclidean_vector().dimensions() == 1);
+		CHECK(comp6771::float_euclidean_vector(20, 2.5F).at(19) == 2.5F);
+		CHECK(v1[2] == 3.25F);
+	}
+
+	SECTION("Arithmetic") {
+		CHECK(v1 + v2 == comp6771::float_euclidean_vector{2.0F, 0.0F, 4.0F});
+		CHECK(v1 - v2 == comp6771::float_euclidean_vector{1.0F, -4.0F, 2.5F});
+		CHECK(v1 * 2.0F == comp6771::float_euclidean_vector{3.0F, -4.0F, 6.5F});
+		CHECK(v1 / 2.0F == comp6771::float_euclidean_vector{0.75F, -1.0F, 1.625F});
+		CHECK(-v1 == comp6771::float_euclidean_vector{-1.5F, 2.0F, -3.25F});
+		CHECK(comp6771::float_euclidean_vector(v1) + v2 == v1 + v2);
+	}
+
+	SECTION("Type conversions and output") {
+		CHECK(static_cast<std::vector<float>>(v1) == values);
+		CHECK(static_cast<std::list<float>>(v1) == std::list<float>(values.begin(), values.end()));
+
+		auto oss = std::ostringstream();
+		oss << v1;
+		CHECK(oss.str() == "[1.5 -2 3.25]");
+	}
+}
+
+TEST_CASE("Float reductions accumulate in double", "[float]") {
+	// 2^24 + 1 is not representable as a float, so a float accumulator would drop the 1.
+	auto const v1 = comp6771::float_euclidean_vector{16777216.0F, 1.0F};
+	auto const v2 = comp6771::float_euclidean_vector{1.0F, 1.0F};
+	CHECK(comp6771::dot(v1, v2) == 16777217.0);
+	CHECK(comp6771::squared_distance(v1, v2) == 16777215.0 * 16777215.0);
+
+	auto const large = comp6771::float_euclidean_vector(1000, 0.1F);
+	auto const term = static_cast<double>(0.1F);
+	CHECK(comp6771::euclidean_norm(large) == Approx(std::sqrt(1000 * term * term)).epsilon(1e-12));
+}
+
+TEST_CASE("Float unit vector", "[float]") {
+	auto const v = comp6771::float_euclidean_vector{3.0F, 4.0F};
+	CHECK(comp6771::unit(v) == comp6771::float_euclidean_vector{0.6F, 0.8F});
+	CHECK(comp6771::unit(comp6771::float_euclidean_vector{0.0F, 2.0F})
+	      == comp6771::float_euclidean_vector{0.0F, 1.0F});
+	CHECK(comp6771::euclidean_norm(comp6771::unit(v)) == Approx(1.0));
+}
+
+TEST_CASE("Float exception handling", "[float]") {
+	auto v = comp6771::float_euclidean_vector{1.0F, 2.0F};
+
+	CHECK_THROWS_WITH(v + comp6771::float_euclidean_vector(3),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(v /= 0.0F, "Invalid vector division by 0");
+	CHECK_THROWS_WITH(v.at(2), "Index 2 is not valid for this euclidean_vector object");
+	CHECK_THROWS_WITH(comp6771::unit(comp6771::float_euclidean_vector(2)),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+}
@@ -10,11 +10,38 @@
 //          5. test the friend function of operator*
 //          6. test the friend function of operator/
 //          7. test the friend function of operator<<
+//          8. test the overloads of operator+, operator-, operator* and operator/ for temporaries
+//          9. test the friend function of operator>>
 
 #include <comp6771/euclidean_vector.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+namespace {
+	// A stream buffer that only appends, like a pipe or a terminal: it cannot seek.
+	class append_only_buffer : public std::streambuf {
+	public:
+		std::string text;
+
+	protected:
+		auto overflow(int_type c) -> int_type override {
+			if (not traits_type::eq_int_type(c, traits_type::eof())) {
+				text.push_back(traits_type::to_char_type(c));
+			}
+			return traits_type::not_eof(c);
+		}
+
+		auto xsputn(char const* s, std::streamsize n) -> std::streamsize override {
+			text.append(s, static_cast<std::size_t>(n));
+			return n;
+		}
+	};
+} // namespace
+
 TEST_CASE("Equal", "[friend_operation]") {
 	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto const v2 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
@@ -138,6 +165,54 @@ TEST_CASE("Division", "[friend_operation]") {
 	}
 }
 
+TEST_CASE("Operators on temporaries", "[friend_operation]") {
+	auto const v1 = comp6771::euclidean_vector(32, 3.0);
+	auto const v2 = comp6771::euclidean_vector(32, 1.0);
+
+	SECTION("Temporary on the left reuses its storage") {
+		auto tmp = comp6771::euclidean_vector(v1);
+		auto const* const storage = tmp.data();
+		auto const sum = std::move(tmp) + v2;
+		CHECK(sum.data() == storage);
+		CHECK(sum == comp6771::euclidean_vector(32, 4.0));
+	}
+
+	SECTION("Temporary on the right reuses its storage") {
+		auto tmp = comp6771::euclidean_vector(v2);
+		auto const* const storage = tmp.data();
+		auto const difference = v1 - std::move(tmp);
+		CHECK(difference.data() == storage);
+		CHECK(difference == comp6771::euclidean_vector(32, 2.0));
+	}
+
+	SECTION("Chains allocate once") {
+		auto tmp = comp6771::euclidean_vector(v1);
+		auto const* const storage = tmp.data();
+		auto const result = (std::move(tmp) + v2) * 3.0 / 2.0 - v2;
+		CHECK(result.data() == storage);
+		CHECK(result == comp6771::euclidean_vector(32, 5.0));
+	}
+
+	SECTION("Results match the const overloads") {
+		CHECK(comp6771::euclidean_vector(v1) + comp6771::euclidean_vector(v2) == v1 + v2);
+		CHECK(v2 + comp6771::euclidean_vector(v1) == v2 + v1);
+		CHECK(comp6771::euclidean_vector(v1) - comp6771::euclidean_vector(v2) == v1 - v2);
+		CHECK(v2 - comp6771::euclidean_vector(v1) == v2 - v1);
+		CHECK(comp6771::euclidean_vector(v1) * -2.0 == v1 * -2.0);
+		CHECK(comp6771::euclidean_vector(v1) / 4.0 == v1 / 4.0);
+	}
+
+	SECTION("Exceptions report the original operand order") {
+		CHECK_THROWS_WITH(comp6771::euclidean_vector(3) + v1,
+		                  "Dimensions of LHS(3) and RHS(32) do not match");
+		CHECK_THROWS_WITH(v1 + comp6771::euclidean_vector(3),
+		                  "Dimensions of LHS(32) and RHS(3) do not match");
+		CHECK_THROWS_WITH(v1 - comp6771::euclidean_vector(3),
+		                  "Dimensions of LHS(32) and RHS(3) do not match");
+		CHECK_THROWS_WITH(comp6771::euclidean_vector(v1) / 0.0, "Invalid vector division by 0");
+	}
+}
+
 TEST_CASE("Output Stream", "[friend_operation]") {
 	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto const v2 = comp6771::euclidean_vector(4);
@@ -156,4 +231,72 @@ TEST_CASE("Output Stream", "[friend_operation]") {
 	ss << v3;
 	CHECK(ss.str() == "[]");
 	ss.str(std::string{});
-}
\ No newline at end of file
+
+	SECTION("Elements print in their shortest round-trip form") {
+		auto const v4 = comp6771::euclidean_vector{0.1, 1.0 / 3.0, 1e-300, -2.5e10, 123456789.0};
+		ss << v4;
+		CHECK(ss.str() == "[0.1 0.3333333333333333 1e-300 -2.5e+10 123456789]");
+
+		auto back = comp6771::euclidean_vector(5);
+		auto in = std::istringstream(ss.str().substr(1));
+		for (auto i = 0; i < back.dimensions(); ++i) {
+			auto value = 0.0;
+			in >> value;
+			back[i] = value;
+		}
+		CHECK(back == v4);
+	}
+
+	SECTION("Elements of up to six significant digits print as %g prints them") {
+		auto const v5 = comp6771::euclidean_vector{100000, 200000, 0.0001, 1e-5, -123.456, 1e6, 0};
+		ss << v5;
+		CHECK(ss.str() == "[100000 200000 0.0001 1e-05 -123.456 1e+06 0]");
+		ss.str(std::string{});
+
+		ss << comp6771::float_euclidean_vector{100000.0F, 0.0001F, 0.1F};
+		CHECK(ss.str() == "[100000 0.0001 0.1]");
+	}
+
+	SECTION("Streams that cannot seek") {
+		auto buffer = append_only_buffer();
+		auto os = std::ostream(&buffer);
+		os << v1 << '\n' << v3 << ' ' << v2;
+		CHECK(os.good());
+		CHECK(buffer.text == "[14.3 26.5 -12.8 2.1]\n[] [0 0 0 0]");
+	}
+}
+
+TEST_CASE("Input Stream", "[friend_operation]") {
+	auto v = comp6771::euclidean_vector{9.0};
+
+	SECTION("Vectors read back as they were written") {
+		auto ss = std::stringstream{};
+		auto const v1 = comp6771::euclidean_vector{14.3, 1.0 / 3.0, -1e-300, 2.5e10};
+		ss << v1 << "\n  " << comp6771::euclidean_vector(0) << "\t[ 1   2 ]";
+		CHECK(ss >> v);
+		CHECK(v == v1);
+		CHECK(ss >> v);
+		CHECK(v.dimensions() == 0);
+		CHECK(ss >> v);
+		CHECK(v == comp6771::euclidean_vector{1.0, 2.0});
+		CHECK_FALSE(ss >> v);
+		CHECK(ss.eof());
+		CHECK(v == comp6771::euclidean_vector{1.0, 2.0});
+	}
+
+	SECTION("Float vectors") {
+		auto ss = std::stringstream{"[1.5 -2 0.1]"};
+		auto f = comp6771::float_euclidean_vector();
+		CHECK(ss >> f);
+		CHECK(f == comp6771::float_euclidean_vector{1.5F, -2.0F, 0.1F});
+	}
+
+	SECTION("Malformed text fails and leaves the vector alone") {
+		for (auto const* const text : {"(1 2)", "[1 2", "[1, 2]", "[1 2x]", "[1e999]", ""}) {
+			INFO(text);
+			auto ss = std::stringstream{text};
+			CHECK_FALSE(ss >> v);
+			CHECK(v == comp6771::euclidean_vector{9.0});
+		}
+	}
+}
@@ -0,0 +1,181 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the HnswIndex class.
+//      The test cases are:
+//          1. test construction and the shape of the graph
+//          2. test recall against brute_force_index for every metric
+//          3. test add() on an index built one row at a time
+//          4. test that batched queries match single queries
+//          5. test the exception handling
+
+#include <comp6771/hnsw_index.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+	auto random_vectors(int count, int dimension, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto value = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = comp6771::euclidean_vector(dimension);
+			for (auto j = 0; j < dimension; ++j) {
+				v[j] = value(engine);
+			}
+			vectors.push_back(v);
+		}
+		return vectors;
+	}
+
+	// The fraction of the exact k nearest that the approximate search also returned
+	auto recall(std::vector<comp6771::neighbour> const& found,
+	            std::vector<comp6771::neighbour> const& exact) -> double {
+		auto hits = 0;
+		for (auto const& expected : exact) {
+			hits += std::any_of(found.begin(), found.end(), [&](auto const& n) {
+				return n.id == expected.id;
+			});
+		}
+		return static_cast<double>(hits) / static_cast<double>(exact.size());
+	}
+} // namespace
+
+TEST_CASE("HNSW index construction", "[hnsw_index]") {
+	auto const vectors = random_vectors(500, 8, 1);
+	auto const index = comp6771::hnsw_index(vectors, comp6771::metric::l2, {.m = 6});
+
+	CHECK(index.size() == 500);
+	CHECK(index.dimensions() == 8);
+	CHECK(index.distance_metric() == comp6771::metric::l2);
+	CHECK(index.tuning().m == 6);
+	CHECK(index.tuning().ef_search == 64);
+	CHECK(comp6771::euclidean_vector(index.database()[42]) == vectors[42]);
+	// with m = 6 about one node in six reaches layer 1
+	CHECK(index.max_level() >= 1);
+
+	for (auto id = 0; id < index.size(); ++id) {
+		auto const layer0 = index.neighbours(id, 0);
+		CHECK(not layer0.empty());
+		CHECK(layer0.size() <= 12);
+		CHECK(std::find(layer0.begin(), layer0.end(), id) == layer0.end());
+		CHECK(index.neighbours(id, 1).size() <= 6);
+		for (auto const n : layer0) {
+			CHECK((n >= 0 and n < index.size()));
+		}
+	}
+	CHECK(index.neighbours(0, index.max_level() + 1).empty());
+
+	SECTION("An empty index") {
+		auto const empty = comp6771::hnsw_index(8);
+		CHECK(empty.size() == 0);
+		CHECK(empty.search(vectors[0], 5).empty());
+	}
+}
+
+TEST_CASE("HNSW index recall", "[hnsw_index]") {
+	auto const database = random_vectors(1500, 24, 2);
+	auto const queries = random_vectors(20, 24, 3);
+
+	for (auto const m :
+	     {comp6771::metric::l2, comp6771::metric::inner_product, comp6771::metric::cosine}) {
+		INFO("metric " << static_cast<int>(m));
+		auto const exact = comp6771::brute_force_index(database, m);
+		auto index = comp6771::hnsw_index(database, m, {.ef_construction = 64, .ef_search = 32});
+
+		auto total = 0.0;
+		for (auto const& query : queries) {
+			auto const found = index.search(query, 10);
+			REQUIRE(found.size() == 10);
+			CHECK(std::is_sorted(found.begin(), found.end(), [m](auto const& a, auto const& b) {
+				return m == comp6771::metric::l2 ? a.score < b.score : a.score > b.score;
+			}));
+			auto const expected = exact.search(query, 10);
+			total += recall(found, expected);
+
+			// the scores are the same distances brute force reports
+			for (auto const& n : found) {
+				auto const same = std::find_if(expected.begin(), expected.end(), [&](auto const& e) {
+					return e.id == n.id;
+				});
+				if (same != expected.end()) {
+					CHECK(n.score == Approx(same->score).margin(1e-9));
+				}
+			}
+		}
+		CHECK(total / static_cast<double>(queries.size()) >= 0.9);
+
+		// a wider search does at least as well on average
+		index.set_ef_search(200);
+		auto wide = 0.0;
+		for (auto const& query : queries) {
+			wide += recall(index.search(query, 10), exact.search(query, 10));
+		}
+		CHECK(wide >= total);
+	}
+}
+
+TEST_CASE("HNSW index add", "[hnsw_index]") {
+	auto const vectors = random_vectors(300, 12, 4);
+	auto index = comp6771::hnsw_index(12, comp6771::metric::l2, {.m = 8, .ef_construction = 64});
+	for (auto const& v : vectors) {
+		index.add(v);
+	}
+	CHECK(index.size() == 300);
+
+	// every row finds itself
+	for (auto id = 0; id < index.size(); ++id) {
+		auto const found = index.search(vectors[static_cast<std::size_t>(id)], 1);
+		REQUIRE(found.size() == 1);
+		CHECK(found[0].id == id);
+		CHECK(found[0].score == 0.0);
+	}
+
+	// k larger than the index returns every row
+	CHECK(index.search(vectors[0], 1000).size() == 300);
+	CHECK(index.search(vectors[0], 0).empty());
+}
+
+TEST_CASE("HNSW index batched queries", "[hnsw_index]") {
+	auto const database = random_vectors(1000, 10, 5);
+	auto const queries = comp6771::euclidean_vector_batch(random_vectors(40, 10, 6));
+	auto const index = comp6771::hnsw_index(database, comp6771::metric::cosine);
+
+	auto const found = index.search(queries, 5);
+	REQUIRE(found.size() == 40);
+	for (auto row = 0; row < queries.rows(); ++row) {
+		CHECK(found[static_cast<std::size_t>(row)] == index.search(queries[row], 5));
+	}
+}
+
+TEST_CASE("HNSW index exception handling", "[hnsw_index]") {
+	CHECK_THROWS_WITH(comp6771::hnsw_index(4, comp6771::metric::l2, {.m = 1}),
+	                  "hnsw_index needs m of at least 2, not 1");
+	CHECK_THROWS_WITH(comp6771::hnsw_index(4, comp6771::metric::l2, {.ef_construction = 0}),
+	                  "hnsw_index needs ef_construction of at least 1, not 0");
+	CHECK_THROWS_WITH(comp6771::hnsw_index(4, comp6771::metric::l2, {.ef_search = -3}),
+	                  "hnsw_index needs ef_search of at least 1, not -3");
+
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1.0, 0.0}, {0.0, 1.0}};
+	auto index = comp6771::hnsw_index(vectors, comp6771::metric::cosine);
+	CHECK_THROWS_WITH(index.set_ef_search(0), "hnsw_index needs ef_search of at least 1, not 0");
+	CHECK(index.tuning().ef_search == 64);
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0, 3.0}, 1),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(index.add(comp6771::euclidean_vector{1.0}),
+	                  "Dimensions of LHS(2) and RHS(1) do not match");
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0}, -1),
+	                  "Cannot search for -1 neighbours");
+	CHECK_THROWS_WITH(index.neighbours(2, 0), "Node 2 is not valid for this hnsw_index object");
+
+	auto const* const undefined =
+	   "euclidean_vector with zero euclidean normal does not have a cosine similarity";
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector(2), 1), undefined);
+	CHECK_THROWS_WITH(index.add(comp6771::euclidean_vector(2)), undefined);
+	CHECK(index.size() == 2);
+}
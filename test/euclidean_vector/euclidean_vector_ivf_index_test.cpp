@@ -0,0 +1,221 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the IvfIndex class.
+//      The test cases are:
+//          1. test construction and the partition into lists
+//          2. test recall against brute_force_index for every metric
+//          3. test that probing every list is exact
+//          4. test add() and batched queries
+//          5. test the exception handling
+
+#include <comp6771/ivf_index.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+	// Points scattered around `clusters` random centres, the shape IVF is built for
+	auto clustered_vectors(int count, int dimension, int clusters, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto centre = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto noise = std::normal_distribution<double>(0.0, 0.2);
+		auto centres = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < clusters; ++i) {
+			auto c = comp6771::euclidean_vector(dimension);
+			for (auto j = 0; j < dimension; ++j) {
+				c[j] = centre(engine);
+			}
+			centres.push_back(c);
+		}
+
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto v = centres[static_cast<std::size_t>(i % clusters)];
+			for (auto j = 0; j < dimension; ++j) {
+				v[j] += noise(engine);
+			}
+			vectors.push_back(v);
+		}
+		return vectors;
+	}
+
+	// The fraction of the exact k nearest that the approximate search also returned
+	auto recall(std::vector<comp6771::neighbour> const& found,
+	            std::vector<comp6771::neighbour> const& exact) -> double {
+		auto hits = 0;
+		for (auto const& expected : exact) {
+			hits += std::any_of(found.begin(), found.end(), [&](auto const& n) {
+				return n.id == expected.id;
+			});
+		}
+		return static_cast<double>(hits) / static_cast<double>(exact.size());
+	}
+
+	auto const all_metrics = {comp6771::metric::l2,
+	                          comp6771::metric::inner_product,
+	                          comp6771::metric::cosine};
+} // namespace
+
+TEST_CASE("IVF index construction", "[ivf_index]") {
+	auto const vectors = clustered_vectors(1000, 8, 10, 1);
+	auto const index = comp6771::ivf_index(vectors, comp6771::metric::l2, {.lists = 16});
+
+	CHECK(index.size() == 1000);
+	CHECK(index.dimensions() == 8);
+	CHECK(index.distance_metric() == comp6771::metric::l2);
+	CHECK(index.tuning().lists == 16);
+	CHECK(index.tuning().nprobe == 8);
+	CHECK(index.centroids().rows() == 16);
+	CHECK(index.centroids().dimensions() == 8);
+
+	// every row is in exactly one list, the one whose centroid is nearest
+	auto seen = std::vector<int>();
+	for (auto list = 0; list < 16; ++list) {
+		for (auto const id : index.list(list)) {
+			seen.push_back(id);
+			auto const& v = vectors[static_cast<std::size_t>(id)];
+			auto const centroid = [&](int i) {
+				return comp6771::euclidean_vector(index.centroids()[i]);
+			};
+			for (auto other = 0; other < 16; ++other) {
+				CHECK(comp6771::distance(v, centroid(list))
+				      <= comp6771::distance(v, centroid(other)) + 1e-12);
+			}
+		}
+	}
+	std::sort(seen.begin(), seen.end());
+	auto expected = std::vector<int>(1000);
+	std::iota(expected.begin(), expected.end(), 0);
+	CHECK(seen == expected);
+
+	SECTION("A single list") {
+		auto const one = comp6771::ivf_index(vectors, comp6771::metric::l2, {.lists = 1});
+		CHECK(one.list(0).size() == 1000);
+		CHECK(one.search(vectors[3], 1).front().id == 3);
+	}
+
+	SECTION("Cosine centroids have unit length") {
+		auto const cosine = comp6771::ivf_index(vectors, comp6771::metric::cosine, {.lists = 16});
+		for (auto list = 0; list < 16; ++list) {
+			CHECK(comp6771::euclidean_norm(comp6771::euclidean_vector(cosine.centroids()[list]))
+			      == Approx(1.0));
+		}
+	}
+}
+
+TEST_CASE("IVF index recall", "[ivf_index]") {
+	auto const database = clustered_vectors(3000, 16, 40, 2);
+	auto const queries = clustered_vectors(40, 16, 40, 3);
+
+	for (auto const m : all_metrics) {
+		INFO("metric " << static_cast<int>(m));
+		auto const exact = comp6771::brute_force_index(database, m);
+		auto index = comp6771::ivf_index(database, m, {.lists = 32, .nprobe = 1});
+
+		auto narrow = 0.0;
+		for (auto const& query : queries) {
+			narrow += recall(index.search(query, 10), exact.search(query, 10));
+		}
+
+		index.set_nprobe(8);
+		auto total = 0.0;
+		for (auto const& query : queries) {
+			auto const found = index.search(query, 10);
+			REQUIRE(found.size() == 10);
+			CHECK(std::is_sorted(found.begin(), found.end(), [m](auto const& a, auto const& b) {
+				return m == comp6771::metric::l2 ? a.score < b.score : a.score > b.score;
+			}));
+			total += recall(found, exact.search(query, 10));
+		}
+		CHECK(total / static_cast<double>(queries.size()) >= 0.9);
+		// more probes do at least as well on average
+		CHECK(total >= narrow);
+	}
+}
+
+TEST_CASE("IVF index probing every list is exact", "[ivf_index]") {
+	auto const database = clustered_vectors(800, 12, 8, 4);
+	auto const queries = clustered_vectors(20, 12, 8, 5);
+
+	for (auto const m : all_metrics) {
+		INFO("metric " << static_cast<int>(m));
+		auto const exact = comp6771::brute_force_index(database, m);
+		auto const index = comp6771::ivf_index(database, m, {.lists = 16, .nprobe = 16});
+		for (auto const& query : queries) {
+			auto const found = index.search(query, 7);
+			auto const expected = exact.search(query, 7);
+			REQUIRE(found.size() == expected.size());
+			for (auto i = std::size_t{0}; i < found.size(); ++i) {
+				CHECK(found[i].id == expected[i].id);
+				CHECK(found[i].score == Approx(expected[i].score).margin(1e-9));
+			}
+		}
+		// k larger than the index returns every row
+		CHECK(index.search(queries[0], 1000).size() == 800);
+		CHECK(index.search(queries[0], 0).empty());
+	}
+}
+
+TEST_CASE("IVF index add and batched queries", "[ivf_index]") {
+	auto const database = clustered_vectors(500, 10, 5, 6);
+	auto const extra = clustered_vectors(100, 10, 5, 7);
+	auto index = comp6771::ivf_index(database, comp6771::metric::l2, {.lists = 8, .nprobe = 1});
+
+	for (auto const& v : extra) {
+		index.add(v);
+	}
+	CHECK(index.size() == 600);
+
+	// an added row lands in its nearest list, which is the first one its own search probes
+	for (auto i = 0; i < 100; ++i) {
+		auto const found = index.search(extra[static_cast<std::size_t>(i)], 1);
+		REQUIRE(found.size() == 1);
+		CHECK(found[0].id == 500 + i);
+		CHECK(found[0].score == 0.0);
+	}
+
+	auto const queries = comp6771::euclidean_vector_batch(clustered_vectors(30, 10, 5, 8));
+	index.set_nprobe(3);
+	auto const found = index.search(queries, 5);
+	REQUIRE(found.size() == 30);
+	for (auto row = 0; row < queries.rows(); ++row) {
+		CHECK(found[static_cast<std::size_t>(row)] == index.search(queries[row], 5));
+	}
+}
+
+TEST_CASE("IVF index exception handling", "[ivf_index]") {
+	auto const vectors = clustered_vectors(20, 2, 2, 9);
+	CHECK_THROWS_WITH(comp6771::ivf_index(vectors, comp6771::metric::l2, {.lists = 0}),
+	                  "ivf_index needs lists of at least 1, not 0");
+	CHECK_THROWS_WITH(comp6771::ivf_index(vectors, comp6771::metric::l2, {.nprobe = -1}),
+	                  "ivf_index needs nprobe of at least 1, not -1");
+	CHECK_THROWS_WITH(comp6771::ivf_index(vectors, comp6771::metric::l2, {.samples_per_list = 0}),
+	                  "ivf_index needs samples_per_list of at least 1, not 0");
+	CHECK_THROWS_WITH(comp6771::ivf_index(vectors, comp6771::metric::l2, {.iterations = -1}),
+	                  "ivf_index needs iterations of at least 0, not -1");
+	CHECK_THROWS_WITH(comp6771::ivf_index(vectors, comp6771::metric::l2, {.lists = 21}),
+	                  "ivf_index needs at least 21 rows to train 21 lists, not 20");
+
+	auto index = comp6771::ivf_index(vectors, comp6771::metric::cosine, {.lists = 4});
+	CHECK_THROWS_WITH(index.set_nprobe(0), "ivf_index needs nprobe of at least 1, not 0");
+	CHECK(index.tuning().nprobe == 8);
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0, 3.0}, 1),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(index.add(comp6771::euclidean_vector{1.0}),
+	                  "Dimensions of LHS(2) and RHS(1) do not match");
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector{1.0, 2.0}, -1),
+	                  "Cannot search for -1 neighbours");
+	CHECK_THROWS_WITH(index.list(4), "List 4 is not valid for this ivf_index object");
+
+	auto const* const undefined =
+	   "euclidean_vector with zero euclidean normal does not have a cosine similarity";
+	CHECK_THROWS_WITH(index.search(comp6771::euclidean_vector(2), 1), undefined);
+	CHECK_THROWS_WITH(index.add(comp6771::euclidean_vector(2)), undefined);
+	CHECK(index.size() == 20);
+}
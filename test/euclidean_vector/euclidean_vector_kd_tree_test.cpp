@@ -0,0 +1,186 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the KdTree class.
+//      The test cases are:
+//          1. test construction and rebuild()
+//          2. test nearest-neighbour search against brute_force_index
+//          3. test radius and box queries against a linear scan
+//          4. test duplicate points and ties
+//          5. test the exception handling
+
+#include <comp6771/kd_tree.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+	auto random_points(int count, int dimension, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto value = std::uniform_real_distribution<double>(-10.0, 10.0);
+		auto points = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			auto p = comp6771::euclidean_vector(dimension);
+			for (auto j = 0; j < dimension; ++j) {
+				p[j] = value(engine);
+			}
+			points.push_back(p);
+		}
+		return points;
+	}
+} // namespace
+
+TEST_CASE("KD-tree construction", "[kd_tree]") {
+	auto const points = random_points(100, 3, 1);
+
+	SECTION("From points") {
+		auto const tree = comp6771::kd_tree(points);
+		CHECK(tree.size() == 100);
+		CHECK(tree.dimensions() == 3);
+		CHECK(tree.leaf_size() == comp6771::kd_tree::default_leaf_size);
+	}
+
+	SECTION("Rebuild") {
+		auto tree = comp6771::kd_tree(points, 4);
+		auto const moved = random_points(50, 2, 2);
+		tree.rebuild(moved);
+		CHECK(tree.size() == 50);
+		CHECK(tree.dimensions() == 2);
+		CHECK(tree.leaf_size() == 4);
+		CHECK(tree.search(moved[17], 1).front().id == 17);
+
+		tree.rebuild({});
+		CHECK(tree.size() == 0);
+		CHECK(tree.search(comp6771::euclidean_vector(0), 3).empty());
+	}
+}
+
+TEST_CASE("KD-tree nearest neighbours", "[kd_tree]") {
+	for (auto const dimension : {1, 2, 3, 7, 16}) {
+		INFO("dimension " << dimension);
+		auto const points = random_points(3000, dimension, 3);
+		auto const queries = random_points(30, dimension, 4);
+		auto const exact = comp6771::brute_force_index(points);
+
+		for (auto const leaf_size : {1, 16}) {
+			auto const tree = comp6771::kd_tree(points, leaf_size);
+			for (auto const& query : queries) {
+				for (auto const k : {1, 5, 20}) {
+					auto const found = tree.search(query, k);
+					auto const expected = exact.search(query, k);
+					REQUIRE(found.size() == expected.size());
+					for (auto i = std::size_t{0}; i < found.size(); ++i) {
+						CHECK(found[i].id == expected[i].id);
+						CHECK(found[i].score == Approx(expected[i].score));
+						auto const& nearest = points[static_cast<std::size_t>(found[i].id)];
+						CHECK(found[i].score == Approx(comp6771::distance(query, nearest)));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("KD-tree radius and box queries", "[kd_tree]") {
+	auto const points = random_points(4000, 3, 5);
+	auto const tree = comp6771::kd_tree(points);
+	auto const centres = random_points(20, 3, 6);
+
+	SECTION("Radius") {
+		for (auto const& centre : centres) {
+			for (auto const radius : {0.0, 1.0, 4.5}) {
+				auto const found = tree.radius_search(centre, radius);
+				auto expected = std::vector<int>();
+				for (auto id = 0; id < static_cast<int>(points.size()); ++id) {
+					if (comp6771::distance(centre, points[static_cast<std::size_t>(id)]) <= radius) {
+						expected.push_back(id);
+					}
+				}
+				REQUIRE(found.size() == expected.size());
+				CHECK(std::is_sorted(found.begin(), found.end(), [](auto const& a, auto const& b) {
+					return a.score < b.score;
+				}));
+				auto ids = std::vector<int>();
+				for (auto const& n : found) {
+					ids.push_back(n.id);
+					CHECK(n.score <= radius);
+				}
+				std::sort(ids.begin(), ids.end());
+				CHECK(ids == expected);
+			}
+		}
+		// the boundary is inclusive
+		CHECK(tree.radius_search(points[9], 0.0).front().id == 9);
+	}
+
+	SECTION("Box") {
+		for (auto const& centre : centres) {
+			auto lower = centre;
+			auto upper = centre;
+			lower -= comp6771::euclidean_vector{2.0, 3.0, 1.0};
+			upper += comp6771::euclidean_vector{1.0, 2.0, 4.0};
+
+			auto expected = std::vector<int>();
+			for (auto id = 0; id < static_cast<int>(points.size()); ++id) {
+				auto const& p = points[static_cast<std::size_t>(id)];
+				auto inside = true;
+				for (auto i = 0; i < 3; ++i) {
+					inside = inside and lower[i] <= p[i] and p[i] <= upper[i];
+				}
+				if (inside) {
+					expected.push_back(id);
+				}
+			}
+			CHECK(tree.box_search(lower, upper) == expected);
+		}
+
+		// a box around one point, and an inverted box
+		CHECK(tree.box_search(points[3], points[3]) == std::vector<int>{3});
+		CHECK(tree.box_search(comp6771::euclidean_vector{1.0, 1.0, 1.0},
+		                      comp6771::euclidean_vector{-1.0, 1.0, 1.0})
+		         .empty());
+	}
+}
+
+TEST_CASE("KD-tree duplicates and ties", "[kd_tree]") {
+	auto points = std::vector<comp6771::euclidean_vector>(100, comp6771::euclidean_vector{1.0, 2.0});
+	points.push_back(comp6771::euclidean_vector{5.0, 5.0});
+	auto const tree = comp6771::kd_tree(points, 4);
+
+	auto const found = tree.search(comp6771::euclidean_vector{1.0, 2.0}, 3);
+	CHECK(found == std::vector<comp6771::neighbour>{{0, 0.0}, {1, 0.0}, {2, 0.0}});
+	CHECK(tree.search(comp6771::euclidean_vector{6.0, 5.0}, 1).front().id == 100);
+	CHECK(tree.radius_search(comp6771::euclidean_vector{1.0, 2.0}, 0.5).size() == 100);
+	CHECK(tree.box_search(comp6771::euclidean_vector{0.0, 0.0}, comp6771::euclidean_vector{2.0, 2.0})
+	         .size()
+	      == 100);
+	CHECK(tree.search(comp6771::euclidean_vector{0.0, 0.0}, 0).empty());
+	CHECK(tree.search(comp6771::euclidean_vector{0.0, 0.0}, 500).size() == 101);
+}
+
+TEST_CASE("KD-tree exception handling", "[kd_tree]") {
+	auto const points = std::vector<comp6771::euclidean_vector>{{1.0, 2.0}, {3.0, 4.0}};
+	auto tree = comp6771::kd_tree(points);
+	auto const query = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+
+	CHECK_THROWS_WITH(comp6771::kd_tree(points, 0),
+	                  "kd_tree needs a leaf size of at least 1, not 0");
+	CHECK_THROWS_WITH(tree.search(query, 1), "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(tree.radius_search(query, 1.0),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(tree.box_search(points[0], query),
+	                  "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(tree.search(points[0], -2), "Cannot search for -2 neighbours");
+	CHECK_THROWS_WITH(tree.radius_search(points[0], -1.0),
+	                  "Cannot search within a radius of -1.000000");
+
+	// a failed rebuild leaves the tree as it was
+	auto const mixed = std::vector<comp6771::euclidean_vector>{{1.0, 2.0}, {1.0}};
+	CHECK_THROWS_WITH(tree.rebuild(mixed), "Dimensions of LHS(2) and RHS(1) do not match");
+	CHECK(tree.size() == 2);
+	CHECK(tree.search(points[1], 1).front().id == 1);
+}
@@ -0,0 +1,198 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the SIMD kernels behind EuclideanVector class.
+//      The test cases are:
+//          1. test every supported instruction set against the scalar kernels
+//          2. test the float kernels, which accumulate in double, against the scalar kernels
+//          3. test that the public functions route through the active kernels
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+	auto random_values(std::size_t n, unsigned seed) -> std::vector<double> {
+		auto engine = std::mt19937_64(seed);
+		auto distribution = std::uniform_real_distribution<double>(-100.0, 100.0);
+		auto values = std::vector<double>(n);
+		for (auto& value : values) {
+			value = distribution(engine);
+		}
+		return values;
+	}
+
+	auto random_floats(std::size_t n, unsigned seed) -> std::vector<float> {
+		auto const values = random_values(n, seed);
+		return std::vector<float>(values.begin(), values.end());
+	}
+
+	// The documented bound between two summation orders: 2 * (n - 1) * eps * sum(|a[i] * b[i]|).
+	template<typename T>
+	auto reduction_bound(std::vector<T> const& a, std::vector<T> const& b) -> double {
+		auto magnitude = 0.0;
+		for (auto i = std::size_t{0}; i < a.size(); ++i) {
+			magnitude += std::abs(static_cast<double>(a[i]) * static_cast<double>(b[i]));
+		}
+		auto const n = static_cast<double>(a.size());
+		return 2 * std::max(n - 1, 1.0) * std::numeric_limits<double>::epsilon() * magnitude;
+	}
+
+	// a[i] - b[i] in double, the terms squared_distance sums the squares of
+	template<typename T>
+	auto differences(std::vector<T> const& a, std::vector<T> const& b) -> std::vector<double> {
+		auto result = std::vector<double>(a.size());
+		for (auto i = std::size_t{0}; i < a.size(); ++i) {
+			result[i] = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Kernels agree with the scalar reference", "[kernels]") {
+	auto const& scalar = *comp6771::kernels::table(comp6771::kernels::isa::scalar);
+
+	for (auto const instruction_set : {comp6771::kernels::isa::sse2,
+	                                   comp6771::kernels::isa::avx2,
+	                                   comp6771::kernels::isa::avx512}) {
+		auto const* kernels = comp6771::kernels::table(instruction_set);
+		if (kernels == nullptr) {
+			continue;
+		}
+		INFO(comp6771::kernels::name(instruction_set));
+		CHECK(kernels->instruction_set == instruction_set);
+
+		for (auto const n : {0, 1, 2, 3, 7, 8, 15, 16, 31, 33, 64, 100, 768, 4099}) {
+			INFO("n = " << n);
+			auto const size = static_cast<std::size_t>(n);
+			auto const a = random_values(size, 1);
+			auto const b = random_values(size, 2);
+
+			// reductions stay within the documented bound
+			CHECK(std::abs(kernels->dot(a.data(), b.data(), size)
+			               - scalar.dot(a.data(), b.data(), size))
+			      <= reduction_bound(a, b));
+			CHECK(std::abs(kernels->sum_of_squares(a.data(), size)
+			               - scalar.sum_of_squares(a.data(), size))
+			      <= reduction_bound(a, a));
+			auto const d = differences(a, b);
+			CHECK(std::abs(kernels->squared_distance(a.data(), b.data(), size)
+			               - scalar.squared_distance(a.data(), b.data(), size))
+			      <= reduction_bound(d, d));
+			auto const fused = kernels->dot_and_squares(a.data(), b.data(), size);
+			auto const reference = scalar.dot_and_squares(a.data(), b.data(), size);
+			CHECK(std::abs(fused.dot - reference.dot) <= reduction_bound(a, b));
+			CHECK(std::abs(fused.a_squares - reference.a_squares) <= reduction_bound(a, a));
+			CHECK(std::abs(fused.b_squares - reference.b_squares) <= reduction_bound(b, b));
+
+			// element-wise kernels are exact
+			auto expected = a;
+			auto actual = a;
+
+			scalar.add(expected.data(), b.data(), size);
+			kernels->add(actual.data(), b.data(), size);
+			CHECK(actual == expected);
+
+			scalar.subtract(expected.data(), b.data(), size);
+			kernels->subtract(actual.data(), b.data(), size);
+			CHECK(actual == expected);
+
+			scalar.scale(expected.data(), -3.25, size);
+			kernels->scale(actual.data(), -3.25, size);
+			CHECK(actual == expected);
+
+			scalar.divide(expected.data(), 7.5, size);
+			kernels->divide(actual.data(), 7.5, size);
+			CHECK(actual == expected);
+		}
+	}
+}
+
+TEST_CASE("Float kernels agree with the scalar reference", "[kernels]") {
+	using comp6771::kernels::isa;
+	auto const& scalar = *comp6771::kernels::table<float>(isa::scalar);
+
+	for (auto const instruction_set : {isa::sse2, isa::avx2, isa::avx512}) {
+		auto const* kernels = comp6771::kernels::table<float>(instruction_set);
+		if (kernels == nullptr) {
+			continue;
+		}
+		INFO(comp6771::kernels::name(instruction_set));
+		CHECK(kernels->instruction_set == instruction_set);
+
+		for (auto const n : {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 64, 100, 768, 4099}) {
+			INFO("n = " << n);
+			auto const size = static_cast<std::size_t>(n);
+			auto const a = random_floats(size, 5);
+			auto const b = random_floats(size, 6);
+
+			CHECK(std::abs(kernels->dot(a.data(), b.data(), size)
+			               - scalar.dot(a.data(), b.data(), size))
+			      <= reduction_bound(a, b));
+			CHECK(std::abs(kernels->sum_of_squares(a.data(), size)
+			               - scalar.sum_of_squares(a.data(), size))
+			      <= reduction_bound(a, a));
+			auto const d = differences(a, b);
+			CHECK(std::abs(kernels->squared_distance(a.data(), b.data(), size)
+			               - scalar.squared_distance(a.data(), b.data(), size))
+			      <= reduction_bound(d, d));
+			auto const fused = kernels->dot_and_squares(a.data(), b.data(), size);
+			auto const reference = scalar.dot_and_squares(a.data(), b.data(), size);
+			CHECK(std::abs(fused.dot - reference.dot) <= reduction_bound(a, b));
+			CHECK(std::abs(fused.a_squares - reference.a_squares) <= reduction_bound(a, a));
+			CHECK(std::abs(fused.b_squares - reference.b_squares) <= reduction_bound(b, b));
+
+			auto expected = a;
+			auto actual = a;
+
+			scalar.add(expected.data(), b.data(), size);
+			kernels->add(actual.data(), b.data(), size);
+			CHECK(actual == expected);
+
+			scalar.subtract(expected.data(), b.data(), size);
+			kernels->subtract(actual.data(), b.data(), size);
+			CHECK(actual == expected);
+
+			scalar.scale(expected.data(), -3.25F, size);
+			kernels->scale(actual.data(), -3.25F, size);
+			CHECK(actual == expected);
+
+			scalar.divide(expected.data(), 7.5F, size);
+			kernels->divide(actual.data(), 7.5F, size);
+			CHECK(actual == expected);
+		}
+	}
+}
+
+TEST_CASE("Active kernels are always available", "[kernels]") {
+	auto const& active = comp6771::kernels::active();
+
+	CHECK(comp6771::kernels::table(active.instruction_set) == &active);
+	CHECK(comp6771::kernels::table(comp6771::kernels::isa::scalar) != nullptr);
+}
+
+TEST_CASE("Public functions use the kernels", "[kernels]") {
+	auto const a = random_values(1000, 3);
+	auto const b = random_values(1000, 4);
+	auto const v1 = comp6771::euclidean_vector(a.begin(), a.end());
+	auto const v2 = comp6771::euclidean_vector(b.begin(), b.end());
+	auto const& scalar = *comp6771::kernels::table(comp6771::kernels::isa::scalar);
+
+	CHECK(std::abs(comp6771::dot(v1, v2) - scalar.dot(a.data(), b.data(), a.size()))
+	      <= reduction_bound(a, b));
+	CHECK(comp6771::euclidean_norm(v1)
+	      == Approx(std::sqrt(scalar.sum_of_squares(a.data(), a.size()))));
+
+	auto sum = v1;
+	sum += v2;
+	auto expected = a;
+	scalar.add(expected.data(), b.data(), b.size());
+	CHECK(static_cast<std::vector<double>>(sum) == expected);
+}
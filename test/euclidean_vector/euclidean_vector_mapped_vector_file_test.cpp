@@ -0,0 +1,303 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the mapped vector files.
+//      The test cases are:
+//          1. test writing and mapping .fvecs files
+//          2. test .bvecs and .ivecs files
+//          3. test the mapping options and mapped binary_format files
+//          4. test the exception handling
+
+#include <comp6771/binary_format.hpp>
+#include <comp6771/mapped_vector_file.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+	// A file in the temporary directory, removed at the end of the test
+	class temporary_file {
+	public:
+		explicit temporary_file(std::string const& name)
+		: path_{std::filesystem::temp_directory_path()
+		        / ("comp6771_" + std::to_string(::getpid()) + "_" + name)} {}
+		temporary_file(temporary_file const&) = delete;
+		~temporary_file() {
+			std::filesystem::remove(path_);
+		}
+		auto operator=(temporary_file const&) -> temporary_file& = delete;
+
+		[[nodiscard]] auto path() const -> std::filesystem::path const& {
+			return path_;
+		}
+
+		[[nodiscard]] auto contents() const -> std::string {
+			auto file = std::ifstream(path_, std::ios::binary);
+			return std::string(std::istreambuf_iterator<char>(file), {});
+		}
+
+		auto write(std::string const& contents) const -> void {
+			auto file = std::ofstream(path_, std::ios::binary);
+			file << contents;
+		}
+
+	private:
+		std::filesystem::path path_;
+	};
+
+	auto sample_vectors() -> std::vector<comp6771::euclidean_vector> {
+		return {{1.5, -2.0, 0.25}, {3.0, 4.0, 0.0}, {-1.0, 0.5, 8.0}, {0.0, 0.0, 1.0}};
+	}
+} // namespace
+
+using fvecs_rows = decltype(std::declval<comp6771::fvecs_file>().rows());
+static_assert(std::ranges::random_access_range<fvecs_rows>);
+static_assert(comp6771::contiguous_float_expression<comp6771::vecs_view<float>>);
+static_assert(not comp6771::contiguous_float_expression<comp6771::vecs_view<std::uint8_t>>);
+
+TEST_CASE("fvecs files", "[mapped_vector_file]") {
+	auto const file = temporary_file("rows.fvecs");
+	auto const vectors = sample_vectors();
+	{
+		auto os = std::ofstream(file.path(), std::ios::binary);
+		auto writer = comp6771::fvecs_writer(os);
+		for (auto const& v : vectors) {
+			writer.write(v);
+		}
+		CHECK(writer.rows() == 4);
+	}
+
+	// each row is its dimension then its elements
+	auto const contents = file.contents();
+	REQUIRE(contents.size() == 4 * (4 + 3 * sizeof(float)));
+	auto header = std::int32_t{0};
+	auto element = 0.0F;
+	std::memcpy(&header, contents.data() + 16, sizeof(header));
+	std::memcpy(&element, contents.data() + 20, sizeof(element));
+	CHECK(header == 3);
+	CHECK(element == 3.0F);
+
+	auto const mapped = comp6771::fvecs_file(file.path());
+	REQUIRE(mapped.size() == 4);
+	REQUIRE(mapped.dimensions() == 3);
+
+	SECTION("Rows are views") {
+		for (auto row = 0; row < mapped.size(); ++row) {
+			auto const& v = vectors[static_cast<std::size_t>(row)];
+			CHECK(comp6771::euclidean_vector(mapped.at(row)) == v);
+			CHECK(comp6771::dot(mapped[row], v) == comp6771::dot(v, v));
+			CHECK(comp6771::euclidean_norm(mapped[row]) == comp6771::euclidean_norm(v));
+		}
+		CHECK(comp6771::distance(mapped[0], mapped[1]) == comp6771::distance(vectors[0], vectors[1]));
+		CHECK(comp6771::euclidean_vector(comp6771::lazy(vectors[2]) - mapped[2])
+		      == comp6771::euclidean_vector{0.0, 0.0, 0.0});
+		CHECK(comp6771::float_euclidean_vector(mapped[3])
+		      == comp6771::float_euclidean_vector{0, 0, 1});
+	}
+
+	SECTION("fvecs rows go to the float kernels") {
+		// long enough that the kernels' order of summation differs from a plain loop
+		auto wide =
+		   std::vector<comp6771::float_euclidean_vector>(2, comp6771::float_euclidean_vector(97));
+		for (auto i = 0; i < 97; ++i) {
+			wide[0][i] = 1.0F / static_cast<float>(i + 1);
+			wide[1][i] = std::sqrt(static_cast<float>(i)) - 3.0F;
+		}
+		auto const wide_file = temporary_file("wide.fvecs");
+		{
+			auto os = std::ofstream(wide_file.path(), std::ios::binary);
+			auto writer = comp6771::fvecs_writer(os);
+			writer.write(wide[0]);
+			writer.write(wide[1]);
+		}
+		auto const rows = comp6771::fvecs_file(wide_file.path());
+		CHECK(comp6771::dot(rows[0], rows[1]) == comp6771::dot(wide[0], wide[1]));
+		CHECK(comp6771::squared_distance(rows[0], rows[1])
+		      == comp6771::squared_distance(wide[0], wide[1]));
+		CHECK(comp6771::euclidean_norm(rows[1]) == comp6771::euclidean_norm(wide[1]));
+		CHECK(comp6771::cosine_similarity(rows[0], rows[1])
+		      == comp6771::cosine_similarity(wide[0], wide[1]));
+	}
+
+	SECTION("Rows as a range") {
+		auto const rows = mapped.rows();
+		CHECK(std::ranges::size(rows) == 4);
+		CHECK(rows[2].data() == mapped[2].data());
+		auto norms = std::vector<double>();
+		for (auto const row : rows) {
+			norms.push_back(comp6771::euclidean_norm(row));
+		}
+		CHECK(norms[1] == 5.0);
+	}
+
+	SECTION("Writing mapped rows copies the file") {
+		auto const copy = temporary_file("copy.fvecs");
+		{
+			auto os = std::ofstream(copy.path(), std::ios::binary);
+			auto writer = comp6771::fvecs_writer(os);
+			for (auto const row : mapped.rows()) {
+				writer.write(row);
+			}
+			writer.flush();
+		}
+		CHECK(copy.contents() == contents);
+	}
+}
+
+TEST_CASE("bvecs and ivecs files", "[mapped_vector_file]") {
+	SECTION("bvecs") {
+		auto const file = temporary_file("rows.bvecs");
+		{
+			auto os = std::ofstream(file.path(), std::ios::binary);
+			auto writer = comp6771::bvecs_writer(os);
+			writer.write(comp6771::euclidean_vector{0, 128, 255, 7});
+			writer.write(comp6771::float_euclidean_vector{1, 2, 3, 4});
+		}
+		auto const mapped = comp6771::bvecs_file(file.path());
+		REQUIRE(mapped.size() == 2);
+		CHECK(file.contents().size() == 2 * (4 + 4));
+		CHECK(comp6771::euclidean_vector(mapped[0]) == comp6771::euclidean_vector{0, 128, 255, 7});
+		CHECK(comp6771::dot(mapped[0], mapped[1]) == 0 + 256 + 765 + 28);
+	}
+
+	SECTION("ivecs") {
+		auto const file = temporary_file("rows.ivecs");
+		{
+			auto os = std::ofstream(file.path(), std::ios::binary);
+			auto writer = comp6771::ivecs_writer(os);
+			writer.write(comp6771::euclidean_vector{-5, 2147483647});
+		}
+		auto const mapped = comp6771::ivecs_file(file.path());
+		REQUIRE(mapped.size() == 1);
+		CHECK(mapped[0][0] == -5.0);
+		CHECK(mapped[0][1] == 2147483647.0);
+	}
+
+	SECTION("Elements the format cannot hold") {
+		auto oss = std::ostringstream();
+		{
+			auto writer = comp6771::bvecs_writer(oss);
+			writer.write(comp6771::euclidean_vector{1, 2});
+			CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{1, 300}),
+			                  "Magnitude 300 cannot be stored as a 8-bit integer element");
+			CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{2.5, 1}),
+			                  "Magnitude 2.5 cannot be stored as a 8-bit integer element");
+			CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{-1, 1}),
+			                  "Magnitude -1 cannot be stored as a 8-bit integer element");
+			CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{std::nan(""), 1}),
+			                  "Magnitude nan cannot be stored as a 8-bit integer element");
+			writer.write(comp6771::euclidean_vector{3, 4});
+			CHECK(writer.rows() == 2);
+		}
+		// the rows that threw left nothing behind
+		CHECK(oss.str() == std::string("\2\0\0\0\1\2\2\0\0\0\3\4", 12));
+
+		auto ios = std::ostringstream();
+		auto writer = comp6771::ivecs_writer(ios);
+		CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{2147483648.0}),
+		                  "Magnitude 2147483648 cannot be stored as a 32-bit integer element");
+	}
+}
+
+TEST_CASE("Mapping options", "[mapped_vector_file]") {
+	SECTION("Hints") {
+		auto const file = temporary_file("hints.fvecs");
+		{
+			auto os = std::ofstream(file.path(), std::ios::binary);
+			auto writer = comp6771::fvecs_writer(os);
+			// enough rows to span several flushes and pages
+			for (auto row = 0; row < 5000; ++row) {
+				writer.write(comp6771::euclidean_vector{row * 1.0, 1.0, 2.0, 3.0});
+			}
+		}
+		auto const options = comp6771::map_options{comp6771::access_pattern::sequential, true};
+		auto const mapped = comp6771::fvecs_file(file.path(), options);
+		REQUIRE(mapped.size() == 5000);
+		CHECK(mapped[4999][0] == 4999.0);
+		mapped.advise(comp6771::access_pattern::random);
+		CHECK(mapped.at(1234)[0] == 1234.0);
+	}
+
+	SECTION("Mapped binary_format files are used in place") {
+		auto const file = temporary_file("rows.c6771");
+		auto const vectors = sample_vectors();
+		{
+			auto os = std::ofstream(file.path(), std::ios::binary);
+			comp6771::save(os, std::span<comp6771::euclidean_vector const>(vectors));
+		}
+		auto mapped = comp6771::mapped_file(file.path());
+		auto const view = comp6771::vector_file_view(mapped.bytes());
+		REQUIRE(view.size() == 4);
+		CHECK(view.data() == reinterpret_cast<double const*>(mapped.bytes().data() + 64));
+		CHECK(comp6771::euclidean_vector(view[1]) == vectors[1]);
+
+		auto moved = comp6771::mapped_file(std::move(mapped));
+		CHECK(mapped.size() == 0); // NOLINT(bugprone-use-after-move)
+		CHECK(moved.bytes().data() == reinterpret_cast<std::byte const*>(view.data()) - 64);
+	}
+
+	SECTION("Empty files") {
+		auto const file = temporary_file("empty.fvecs");
+		file.write("");
+		auto const mapped = comp6771::fvecs_file(file.path());
+		CHECK(mapped.size() == 0);
+		CHECK(mapped.dimensions() == 0);
+		CHECK(std::ranges::empty(mapped.rows()));
+	}
+}
+
+TEST_CASE("Mapped file exception handling", "[mapped_vector_file]") {
+	auto const file = temporary_file("bad.fvecs");
+	auto const path = file.path().string();
+
+	SECTION("Opening") {
+		CHECK_THROWS_WITH(comp6771::fvecs_file(file.path()),
+		                  "Could not open " + path + ": No such file or directory");
+
+		file.write(std::string("\2\0\0\0\0\0\0\0\0\0\0\0\0\0", 14));
+		CHECK_THROWS_WITH(comp6771::fvecs_file(file.path()),
+		                  "vecs file " + path
+		                     + " of 14 bytes is not a whole number of rows of dimension 2");
+		file.write(std::string("\xff\xff\xff\xff", 4));
+		CHECK_THROWS_WITH(comp6771::fvecs_file(file.path()),
+		                  "vecs file " + path + " starts with dimension -1");
+		file.write(std::string("\1\0", 2));
+		CHECK_THROWS_WITH(comp6771::fvecs_file(file.path()), "vecs file " + path + " is truncated");
+	}
+
+	SECTION("Rows") {
+		// the second row claims a different dimension but has the same size
+		file.write(std::string("\1\0\0\0\0\0\0\0\2\0\0\0\0\0\0\0", 16));
+		auto const mapped = comp6771::fvecs_file(file.path());
+		REQUIRE(mapped.size() == 2);
+		CHECK_NOTHROW(mapped.at(0));
+		CHECK_THROWS_WITH(mapped.at(1), "Row 1 of the vecs file has dimension 2, not 1");
+		CHECK_THROWS_WITH(mapped.at(2), "Row 2 is not valid for this vecs_file object");
+		CHECK_THROWS_WITH(mapped.at(-1), "Row -1 is not valid for this vecs_file object");
+	}
+
+	SECTION("Writing") {
+		auto oss = std::ostringstream();
+		auto writer = comp6771::fvecs_writer(oss);
+		writer.write(comp6771::euclidean_vector{1.0, 2.0});
+		CHECK_THROWS_WITH(writer.write(comp6771::euclidean_vector{1.0, 2.0, 3.0}),
+		                  "Dimensions of LHS(2) and RHS(3) do not match");
+		CHECK(writer.rows() == 1);
+
+		oss.setstate(std::ios_base::badbit);
+		CHECK_THROWS_WITH(writer.flush(), "Could not write the vecs file");
+	}
+}
@@ -9,11 +9,18 @@
 //          4. test the dimensions() function for const object
 //          5. test the exception handling for at() function for const object
 //          6. test the exception handling for at() function for non-const object
+//          7. test set(), data() and data_mut()
+//          8. test that reads through non-const access keep the cached norm
+//          9. test normalize() and its exception handling
 
 #include <comp6771/euclidean_vector.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 TEST_CASE("Member functions for const object", "[member_functions]") {
 	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto const v2 = comp6771::euclidean_vector(0);
@@ -52,4 +59,100 @@ TEST_CASE("Member functions for non-const object", "[member_functions]") {
 		CHECK(v1.at(2) == -3.0);
 		CHECK(v1.at(3) == -4.0);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("Raw access and set", "[member_functions]") {
+	auto v1 = comp6771::euclidean_vector{3.0, 4.0};
+
+	SECTION("Set and proxy writes") {
+		v1.set(0, 6.0);
+		CHECK(v1 == comp6771::euclidean_vector{6.0, 4.0});
+		CHECK(comp6771::euclidean_norm(v1) == Approx(std::sqrt(52.0)));
+
+		v1[1] += 4.0;
+		v1[0] /= 2.0;
+		CHECK(v1 == comp6771::euclidean_vector{3.0, 8.0});
+
+		// assigning one element to another copies the value, like double&
+		v1[0] = v1[1];
+		v1[1] = 1.0;
+		CHECK(v1 == comp6771::euclidean_vector{8.0, 1.0});
+	}
+
+	SECTION("Data") {
+		auto const& cv = v1;
+		CHECK(cv.data()[1] == 4.0);
+		CHECK(v1.data() == v1.data_mut());
+
+		v1.data_mut()[1] = 0.0;
+		CHECK(comp6771::euclidean_norm(v1) == 3.0);
+	}
+}
+
+TEST_CASE("Reads keep the cached norm", "[member_functions]") {
+	auto v1 = comp6771::euclidean_vector{3.0, 4.0};
+	// Writing through a stale data_mut() pointer bypasses the cache, which shows whether a later
+	// access dropped it.
+	auto* const magnitudes = v1.data_mut();
+	CHECK(comp6771::euclidean_norm(v1) == 5.0);
+	magnitudes[0] = 0.0;
+
+	auto sum = 0.0;
+	for (auto i = 0; i < v1.dimensions(); ++i) {
+		sum += v1[i];
+	}
+	sum += v1.at(1);
+	CHECK(sum == 8.0);
+	CHECK(comp6771::euclidean_norm(v1) == 5.0);
+
+	v1[0] = 0.0;
+	CHECK(comp6771::euclidean_norm(v1) == 4.0);
+}
+
+TEST_CASE("Normalize", "[member_functions]") {
+	SECTION("Scales to unit length in place") {
+		auto v1 = comp6771::euclidean_vector{3.0, 0.0, -4.0};
+		auto const* const magnitudes = v1.data();
+		auto& result = v1.normalize();
+		CHECK(&result == &v1);
+		CHECK(v1.data() == magnitudes);
+		CHECK(v1[0] == Approx(0.6));
+		CHECK(v1[2] == Approx(-0.8));
+
+		auto v2 = comp6771::euclidean_vector(1000, 7.0);
+		auto const magnitudes2 = static_cast<std::vector<double>>(v2.normalize());
+		CHECK(std::all_of(magnitudes2.begin(), magnitudes2.end(), [](double const magnitude) {
+			return magnitude == Approx(1.0 / std::sqrt(1000.0));
+		}));
+	}
+
+	SECTION("Caches a norm of 1") {
+		auto v1 = comp6771::euclidean_vector{3.0, 4.0};
+		// Writing through a stale data_mut() pointer bypasses the cache.
+		auto* const magnitudes = v1.data_mut();
+		v1.normalize();
+		magnitudes[0] = 0.0;
+		CHECK(comp6771::euclidean_norm(v1) == 1.0);
+	}
+
+	SECTION("Float and the smallest norms") {
+		auto v1 = comp6771::float_euclidean_vector{3.0F, 4.0F};
+		v1.normalize();
+		CHECK(v1[1] == Approx(0.8F));
+
+		// 1 / norm overflows a float here, so normalize() divides instead
+		auto v2 = comp6771::float_euclidean_vector{1.2e-39F, 1.6e-39F};
+		v2.normalize();
+		CHECK(v2[0] == Approx(0.6F));
+		CHECK(v2[1] == Approx(0.8F));
+	}
+
+	SECTION("Exception handling") {
+		auto v1 = comp6771::euclidean_vector(0);
+		auto v2 = comp6771::euclidean_vector(3);
+		CHECK_THROWS_WITH(v1.normalize(),
+		                  "euclidean_vector with no dimensions does not have a unit vector");
+		CHECK_THROWS_WITH(v2.normalize(),
+		                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	}
+}
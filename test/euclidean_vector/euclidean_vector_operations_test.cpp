@@ -3,9 +3,9 @@
 // description:
 //      This test file is to test the operator functions of EuclideanVector class.
 //      The test cases are:
-//          1. test the copy assignment operator
+//          1. test the copy assignment operator (and its reuse of existing storage)
 //          2. test the move assignment operator
-//          3. test the subscript operator
+//          3. test the subscript operator and the reference it returns
 //          4. test the unary plus operator
 //          5. test the unary minus operator
 //          6. test the compound addition operator
@@ -19,6 +19,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
 TEST_CASE("Copy Assignment", "[operation]") {
 	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto v2 = comp6771::euclidean_vector(0);
@@ -36,6 +40,33 @@ TEST_CASE("Copy Assignment", "[operation]") {
 	}
 }
 
+TEST_CASE("Copy Assignment reuses storage", "[operation]") {
+	auto const v1 = comp6771::euclidean_vector(64, 1.5);
+	auto v2 = comp6771::euclidean_vector(64);
+	auto v3 = comp6771::euclidean_vector(3);
+	auto const* const storage = v2.data();
+
+	SECTION("Same dimension keeps the buffer") {
+		v2 = v1;
+		CHECK(v2.data() == storage);
+		CHECK(v2 == v1);
+	}
+
+	SECTION("Different dimension") {
+		v3 = v1;
+		CHECK(v3 == v1);
+
+		v2 = comp6771::euclidean_vector{1.0, 2.0};
+		CHECK(v2 == comp6771::euclidean_vector{1.0, 2.0});
+	}
+
+	SECTION("Cached norm is copied") {
+		CHECK(comp6771::euclidean_norm(v1) == Approx(12.0));
+		v2 = v1;
+		CHECK(comp6771::euclidean_norm(v2) == Approx(12.0));
+	}
+}
+
 TEST_CASE("Move Assignment", "[operation]") {
 	auto v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto v2 = comp6771::euclidean_vector(0);
@@ -83,6 +114,30 @@ TEST_CASE("Subscript operator - non-const object", "[operation]") {
 	CHECK(v1[3] == 99);
 }
 
+TEST_CASE("Subscript operator - the returned reference", "[operation]") {
+	auto v1 = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+
+	SECTION("auto keeps a reference, a double keeps a copy") {
+		auto alias = v1[0];
+		double const copy = v1[0];
+		v1[0] = 10.0;
+		CHECK(alias == 10.0);
+		CHECK(copy == 1.0);
+		alias = 20.0;
+		CHECK(v1[0] == 20.0);
+		STATIC_REQUIRE(not std::is_convertible_v<decltype(v1[0]), double&>);
+	}
+
+	SECTION("Swapping elements swaps their values") {
+		using std::swap;
+		swap(v1[0], v1[2]);
+		CHECK(v1 == comp6771::euclidean_vector{3.0, 2.0, 1.0});
+		std::ranges::swap(v1[0], v1[1]);
+		CHECK(v1 == comp6771::euclidean_vector{2.0, 3.0, 1.0});
+		CHECK(comp6771::euclidean_norm(v1) == std::sqrt(14.0));
+	}
+}
+
 TEST_CASE("Unary plus operator", "[operation]") {
 	auto v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto v2 = comp6771::euclidean_vector(0);
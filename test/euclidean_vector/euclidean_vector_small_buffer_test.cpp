@@ -0,0 +1,128 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the inline (small-buffer) storage of EuclideanVector class.
+//      The test cases are:
+//          1. test that low-dimension vectors never touch the heap
+//          2. test that high-dimension vectors still allocate
+//          3. test copy and move between inline and heap vectors
+
+#include <comp6771/euclidean_vector.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+	auto allocations = std::size_t{0};
+} // namespace
+
+// Counts every heap allocation made by the test binary so we can observe the ones made by
+// euclidean_vector.
+auto operator new(std::size_t size) -> void* {
+	++allocations;
+	if (auto* p = std::malloc(size)) { // NOLINT(cppcoreguidelines-no-malloc)
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void* {
+	return ::operator new(size);
+}
+
+auto operator delete(void* p) noexcept -> void {
+	std::free(p); // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+auto operator delete[](void* p) noexcept -> void {
+	::operator delete(p);
+}
+
+auto operator delete(void* p, std::size_t) noexcept -> void {
+	::operator delete(p);
+}
+
+auto operator delete[](void* p, std::size_t) noexcept -> void {
+	::operator delete(p);
+}
+
+TEST_CASE("Inline storage does not allocate", "[small_buffer]") {
+	auto const dimension = static_cast<int>(comp6771::euclidean_vector::inline_dimensions);
+	auto const before = allocations;
+
+	auto const v1 = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const v2 = comp6771::euclidean_vector(3, 2.0);
+	auto v3 = comp6771::euclidean_vector(dimension, 1.0);
+	auto v4 = comp6771::euclidean_vector(v3);
+	auto v5 = comp6771::euclidean_vector(std::move(v4));
+	v4 = v5;
+	v5 = std::move(v3);
+
+	auto const sum = v1 + v2;
+	auto const difference = v1 - v2;
+	auto const product = v1 * 2.0;
+	auto const quotient = v1 / 2.0;
+	auto const negated = -v1;
+	auto const u = comp6771::unit(v1);
+
+	auto const after = allocations;
+	CHECK(after == before);
+
+	CHECK(sum == comp6771::euclidean_vector{3.0, 4.0, 5.0});
+	CHECK(difference == comp6771::euclidean_vector{-1.0, 0.0, 1.0});
+	CHECK(product == comp6771::euclidean_vector{2.0, 4.0, 6.0});
+	CHECK(quotient == comp6771::euclidean_vector{0.5, 1.0, 1.5});
+	CHECK(negated == comp6771::euclidean_vector{-1.0, -2.0, -3.0});
+	CHECK(comp6771::euclidean_norm(u) == Approx(1.0));
+	CHECK(v4 == comp6771::euclidean_vector(dimension, 1.0));
+	CHECK(v5 == comp6771::euclidean_vector(dimension, 1.0));
+}
+
+TEST_CASE("Heap storage above the inline limit", "[small_buffer]") {
+	auto const dimension = static_cast<int>(comp6771::euclidean_vector::inline_dimensions) + 1;
+	auto const before = allocations;
+
+	auto const v1 = comp6771::euclidean_vector(dimension, 3.0);
+
+	auto const after = allocations;
+	CHECK(after == before + 1);
+	CHECK(v1.dimensions() == dimension);
+	CHECK(v1.at(dimension - 1) == 3.0);
+}
+
+TEST_CASE("Copy and move between inline and heap storage", "[small_buffer]") {
+	auto const large_dimension = static_cast<int>(comp6771::euclidean_vector::inline_dimensions) + 4;
+	auto small = comp6771::euclidean_vector{1.0, 2.0};
+	auto large = comp6771::euclidean_vector(large_dimension, 5.0);
+
+	SECTION("Copy assignment") {
+		auto small_cp = small;
+		small_cp = large;
+		CHECK(small_cp == large);
+
+		auto large_cp = large;
+		large_cp = small;
+		CHECK(large_cp == small);
+	}
+
+	SECTION("Move assignment") {
+		auto small_cp = small;
+		auto large_cp = large;
+
+		small_cp = std::move(large_cp);
+		CHECK(small_cp == large);
+		CHECK(large_cp.dimensions() == 0);
+
+		large_cp = std::move(small);
+		CHECK(large_cp == comp6771::euclidean_vector{1.0, 2.0});
+		CHECK(small.dimensions() == 0);
+	}
+
+	SECTION("Unary minus leaves the operand untouched") {
+		auto const negated = -small;
+		CHECK(negated == comp6771::euclidean_vector{-1.0, -2.0});
+		CHECK(small == comp6771::euclidean_vector{1.0, 2.0});
+	}
+}
@@ -6,11 +6,24 @@
 //         1. test euclidean_norm() function
 //         2. test unit() function
 //         3. test dot() function
+//         4. test euclidean_norm() in the incremental norm mode
+//         5. test squared_distance() and distance() functions
+//         6. test cosine_similarity() and cosine_distance() functions
+//         7. test normalize() over many vectors
+//         8. test write_vectors() over many vectors
+//         9. test parse_vectors() and its error reporting
 
 #include <comp6771/euclidean_vector.hpp>
 
 #include <catch2/catch.hpp>
 
+#include <cmath>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
 TEST_CASE("Euclidean Norm", "[utility_functions]") {
 	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
 	auto const v2 = comp6771::euclidean_vector(0);
@@ -76,10 +89,24 @@ TEST_CASE("Unit Vector", "[utility_functions]") {
 		CHECK(comp6771::euclidean_norm(u2) == Approx(1.0));
 	}
 
+	SECTION("Unit of a temporary reuses its storage") {
+		auto tmp = comp6771::euclidean_vector(20, 2.0);
+		auto const* const storage = tmp.data();
+		auto const u = comp6771::unit(std::move(tmp));
+
+		CHECK(u.data() == storage);
+		CHECK(u == comp6771::unit(comp6771::euclidean_vector(20, 2.0)));
+		CHECK(comp6771::euclidean_norm(u) == Approx(1.0));
+	}
+
 	auto const v3 = comp6771::euclidean_vector(0);
 	auto const v4 = comp6771::euclidean_vector(4);
 
 	SECTION("Exception handling") {
+		CHECK_THROWS_WITH(comp6771::unit(comp6771::euclidean_vector(0)),
+		                  "euclidean_vector with no dimensions does not have a unit vector");
+		CHECK_THROWS_WITH(comp6771::unit(comp6771::euclidean_vector(4)),
+		                  "euclidean_vector with zero euclidean normal does not have a unit vector");
 		CHECK_THROWS_WITH(comp6771::unit(v3),
 		                  "euclidean_vector with no dimensions does not have a unit vector");
 		CHECK_THROWS_WITH(comp6771::unit(v4),
@@ -106,4 +133,299 @@ TEST_CASE("Dot Product", "[utility_functions]") {
 		CHECK_THROWS_WITH(comp6771::dot(v1, v3), "Dimensions of LHS(4) and RHS(0) do not match");
 		CHECK_THROWS_WITH(comp6771::dot(v3, v4), "Dimensions of LHS(0) and RHS(5) do not match");
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("Incremental Euclidean Norm", "[utility_functions]") {
+	auto v1 = comp6771::euclidean_vector(1024, 0.5);
+	v1.set_incremental_norm(true);
+	REQUIRE(v1.incremental_norm());
+
+	SECTION("Element writes adjust the sum without a pass over the vector") {
+		// Writing through a stale data_mut() pointer bypasses the tracker, which shows whether the
+		// next query summed the elements again.
+		auto* const magnitudes = v1.data_mut();
+		CHECK(comp6771::euclidean_norm(v1) == 16.0);
+		magnitudes[1] = 100.0;
+
+		v1[0] = 2.5;
+		CHECK(comp6771::euclidean_norm(v1) == Approx(std::sqrt(256.0 - 0.25 + 6.25)));
+	}
+
+	SECTION("Many writes stay within the tolerance of the exact norm") {
+		auto engine = std::mt19937_64(7);
+		auto index = std::uniform_int_distribution<int>(0, 1023);
+		auto value = std::uniform_real_distribution<double>(-1000.0, 1000.0);
+		auto reference = comp6771::euclidean_vector(1024, 0.5);
+
+		for (auto i = 0; i < 100000; ++i) {
+			auto const at = index(engine);
+			auto const x = value(engine);
+			v1[at] = x;
+			reference[at] = x;
+			if (i % 1000 == 0) {
+				REQUIRE(comp6771::euclidean_norm(v1)
+				        == Approx(comp6771::euclidean_norm(reference)).epsilon(1e-10));
+			}
+		}
+		CHECK(comp6771::euclidean_norm(v1)
+		      == Approx(comp6771::euclidean_norm(reference)).epsilon(1e-10));
+	}
+
+	SECTION("Cancellation to zero is recomputed exactly") {
+		auto v2 = comp6771::euclidean_vector{0.1, 0.2, 0.3};
+		v2.set_incremental_norm(true);
+		CHECK(comp6771::euclidean_norm(v2) == Approx(std::sqrt(0.14)));
+
+		v2[0] = 0.0;
+		v2[1] = 0.0;
+		v2.at(2) = 0.0;
+		CHECK(comp6771::euclidean_norm(v2) == 0.0);
+		CHECK_THROWS_WITH(comp6771::unit(v2),
+		                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	}
+
+	SECTION("Whole-vector operations and copies") {
+		CHECK(comp6771::euclidean_norm(v1) == 16.0);
+		v1 *= 2.0;
+		CHECK(comp6771::euclidean_norm(v1) == 32.0);
+
+		auto const copy = v1;
+		CHECK(copy.incremental_norm());
+
+		v1.set_incremental_norm(false);
+		v1.set(0, 0.0);
+		CHECK(not v1.incremental_norm());
+		CHECK(comp6771::euclidean_norm(v1) == Approx(std::sqrt(1023.0)));
+	}
+}
+
+TEST_CASE("Distance", "[utility_functions]") {
+	auto const v1 = comp6771::euclidean_vector{1.0, 2.0, 3.0};
+	auto const v2 = comp6771::euclidean_vector{4.0, 6.0, 3.0};
+	auto const v3 = comp6771::euclidean_vector(0);
+
+	SECTION("Check squared_distance() and distance() functions") {
+		CHECK(comp6771::squared_distance(v1, v2) == 25.0);
+		CHECK(comp6771::distance(v1, v2) == 5.0);
+		CHECK(comp6771::distance(v2, v1) == 5.0);
+		CHECK(comp6771::distance(v1, v1) == 0.0);
+		CHECK(comp6771::distance(v3, v3) == 0.0);
+	}
+
+	SECTION("Check against the norm of the difference") {
+		auto engine = std::mt19937_64(11);
+		auto value = std::uniform_real_distribution<double>(-100.0, 100.0);
+		for (auto const dimension : {1, 7, 8, 9, 33, 1000}) {
+			auto a = comp6771::euclidean_vector(dimension);
+			auto b = comp6771::euclidean_vector(dimension);
+			for (auto i = 0; i < dimension; ++i) {
+				a[i] = value(engine);
+				b[i] = value(engine);
+			}
+			CHECK(comp6771::distance(a, b) == Approx(comp6771::euclidean_norm(a - b)));
+		}
+	}
+
+	SECTION("Check exception handling for distance() functions") {
+		CHECK_THROWS_WITH(comp6771::squared_distance(v1, v3),
+		                  "Dimensions of LHS(3) and RHS(0) do not match");
+		CHECK_THROWS_WITH(comp6771::distance(v3, v1), "Dimensions of LHS(0) and RHS(3) do not match");
+	}
+}
+
+TEST_CASE("Cosine similarity", "[utility_functions]") {
+	auto const v1 = comp6771::euclidean_vector{1.0, 0.0};
+	auto const v2 = comp6771::euclidean_vector{0.0, 2.0};
+	auto const v3 = comp6771::euclidean_vector{3.0, 4.0};
+
+	SECTION("Check cosine_similarity() and cosine_distance() functions") {
+		CHECK(comp6771::cosine_similarity(v1, v2) == 0.0);
+		CHECK(comp6771::cosine_similarity(v1, v3) == Approx(0.6));
+		CHECK(comp6771::cosine_similarity(v3, v3 * 2.5) == 1.0);
+		CHECK(comp6771::cosine_similarity(v3, -v3) == -1.0);
+		CHECK(comp6771::cosine_distance(v1, v2) == 1.0);
+		CHECK(comp6771::cosine_distance(v3, -v3) == 2.0);
+		CHECK(comp6771::cosine_distance(v1, v3) == Approx(0.4));
+	}
+
+	SECTION("Check the norms are cached by the same pass") {
+		auto v4 = comp6771::euclidean_vector{3.0, 4.0};
+		auto v5 = comp6771::euclidean_vector{6.0, 8.0};
+		// Writing through stale data_mut() pointers bypasses the caches, which shows whether
+		// cosine_similarity() filled them and whether it used them afterwards.
+		auto* const magnitudes4 = v4.data_mut();
+		auto* const magnitudes5 = v5.data_mut();
+		CHECK(comp6771::cosine_similarity(v4, v5) == 1.0);
+		magnitudes4[0] = 0.0;
+		magnitudes5[0] = 0.0;
+		CHECK(comp6771::euclidean_norm(v4) == 5.0);
+		CHECK(comp6771::euclidean_norm(v5) == 10.0);
+		CHECK(comp6771::cosine_similarity(v4, v5) == Approx(32.0 / 50.0));
+	}
+
+	SECTION("Check the incremental norm mode is kept in step") {
+		auto v4 = comp6771::euclidean_vector{3.0, 4.0};
+		v4.set_incremental_norm(true);
+		CHECK(comp6771::cosine_similarity(v4, v1) == Approx(0.6));
+		v4[1] = 0.0;
+		CHECK(comp6771::euclidean_norm(v4) == 3.0);
+		CHECK(comp6771::cosine_similarity(v4, v1) == 1.0);
+	}
+
+	SECTION("Check exception handling for cosine_similarity() functions") {
+		CHECK_THROWS_WITH(comp6771::cosine_similarity(v1, comp6771::euclidean_vector(3)),
+		                  "Dimensions of LHS(2) and RHS(3) do not match");
+		CHECK_THROWS_WITH(comp6771::cosine_similarity(v1, comp6771::euclidean_vector(2)),
+		                  "euclidean_vector with zero euclidean normal does not have a cosine "
+		                  "similarity");
+		CHECK_THROWS_WITH(comp6771::cosine_distance(comp6771::euclidean_vector(0),
+		                                            comp6771::euclidean_vector(0)),
+		                  "euclidean_vector with zero euclidean normal does not have a cosine "
+		                  "similarity");
+	}
+}
+
+TEST_CASE("Bulk normalize", "[utility_functions]") {
+	auto engine = std::mt19937_64(13);
+	auto value = std::uniform_real_distribution<double>(-10.0, 10.0);
+	auto vectors = std::vector<comp6771::euclidean_vector>();
+	for (auto i = 0; i < 2000; ++i) {
+		auto v = comp6771::euclidean_vector(64);
+		for (auto j = 0; j < v.dimensions(); ++j) {
+			v[j] = value(engine);
+		}
+		vectors.push_back(v);
+	}
+	auto const original = vectors;
+
+	SECTION("Check every vector is normalised") {
+		comp6771::normalize(std::span(vectors));
+		for (auto i = std::size_t{0}; i < vectors.size(); ++i) {
+			CHECK(vectors[i][5] == Approx(original[i][5] / comp6771::euclidean_norm(original[i])));
+		}
+		comp6771::normalize(std::span(vectors.data(), 0));
+	}
+
+	SECTION("Check a std::vector is normalised without a span") {
+		comp6771::normalize(vectors);
+		CHECK(vectors[7][5] == Approx(original[7][5] / comp6771::euclidean_norm(original[7])));
+
+		auto floats = std::vector<comp6771::float_euclidean_vector>{{3.0F, 4.0F}, {0.0F, 2.0F}};
+		comp6771::normalize(floats);
+		CHECK(floats[0][0] == Approx(0.6));
+		CHECK(floats[0][1] == Approx(0.8));
+		CHECK(floats[1][1] == 1.0F);
+	}
+
+	SECTION("Check exception handling for bulk normalize") {
+		vectors[1500] = comp6771::euclidean_vector(64);
+		CHECK_THROWS_WITH(comp6771::normalize(std::span(vectors)),
+		                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+		CHECK(vectors[1500] == comp6771::euclidean_vector(64));
+		CHECK(comp6771::euclidean_norm(vectors[1999]) == 1.0);
+
+		vectors[1999] = comp6771::euclidean_vector(0);
+		vectors[0] = original[0];
+		CHECK_THROWS_WITH(comp6771::normalize(std::span(vectors)),
+		                  "euclidean_vector with no dimensions does not have a unit vector");
+		CHECK(vectors[0] == original[0]);
+	}
+}
+
+TEST_CASE("Write vectors", "[utility_functions]") {
+	SECTION("Check each vector is written as operator<< writes it, one per line") {
+		auto const vectors = std::vector<comp6771::euclidean_vector>{{1.5, -2.0},
+		                                                             comp6771::euclidean_vector(0),
+		                                                             {0.1, 3.0, 1e-7}};
+		auto oss = std::ostringstream();
+		CHECK(&comp6771::write_vectors(oss, vectors) == &oss);
+		CHECK(oss.str() == "[1.5 -2]\n[]\n[0.1 3 1e-07]\n");
+
+		oss.str(std::string{});
+		comp6771::write_vectors(oss, std::vector<comp6771::euclidean_vector>());
+		CHECK(oss.str().empty());
+	}
+
+	SECTION("Check output larger than one flush") {
+		auto engine = std::mt19937_64(14);
+		auto value = std::uniform_real_distribution<float>(-10.0F, 10.0F);
+		auto vectors = std::vector<comp6771::float_euclidean_vector>();
+		auto expected = std::ostringstream();
+		for (auto i = 0; i < 3000; ++i) {
+			auto v = comp6771::float_euclidean_vector(16);
+			for (auto j = 0; j < v.dimensions(); ++j) {
+				v[j] = value(engine);
+			}
+			expected << v << '\n';
+			vectors.push_back(v);
+		}
+
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, vectors);
+		CHECK(oss.str().size() > std::size_t{1} << 17);
+		CHECK(oss.str() == expected.str());
+	}
+}
+
+TEST_CASE("Parse vectors", "[utility_functions]") {
+	SECTION("Check the text of write_vectors() reads back exactly") {
+		auto engine = std::mt19937_64(15);
+		auto value = std::uniform_real_distribution<double>(-1e6, 1e6);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < 500; ++i) {
+			auto v = comp6771::euclidean_vector(i % 20);
+			for (auto j = 0; j < v.dimensions(); ++j) {
+				v[j] = value(engine);
+			}
+			vectors.push_back(v);
+		}
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, vectors);
+		CHECK(comp6771::parse_vectors(oss.str()) == vectors);
+
+		CHECK(comp6771::parse_vectors(" \t\n").empty());
+		CHECK(comp6771::parse_vectors("[1 2][3]\r\n[ ]")
+		      == std::vector<comp6771::euclidean_vector>{{1.0, 2.0},
+		                                                 {3.0},
+		                                                 comp6771::euclidean_vector(0)});
+		CHECK(comp6771::parse_vectors<float>("[0.1 -2]")
+		      == std::vector<comp6771::float_euclidean_vector>{{0.1F, -2.0F}});
+	}
+
+	SECTION("Check text large enough to be parsed in pieces") {
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < 40000; ++i) {
+			auto v = comp6771::euclidean_vector(16);
+			for (auto j = 0; j < v.dimensions(); ++j) {
+				v[j] = 1.0 / (i + j + 1);
+			}
+			vectors.push_back(v);
+		}
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, vectors);
+		auto text = oss.str();
+		REQUIRE(text.size() > std::size_t{8} << 20);
+		CHECK(comp6771::parse_vectors(text) == vectors);
+
+		// the first problem is reported, even when a later piece has one too
+		auto const bad = text.rfind('[', text.size() / 2);
+		text[bad + 5] = ',';
+		text[text.size() - 3] = 'x';
+		CHECK_THROWS_WITH(comp6771::parse_vectors(text),
+		                  "Malformed euclidean_vector text at byte " + std::to_string(bad + 5)
+		                     + ": expected whitespace or ']'");
+	}
+
+	SECTION("Check the exception handling reports the byte offset") {
+		auto const malformed = [](char const* text, char const* message) {
+			CHECK_THROWS_WITH(comp6771::parse_vectors(text),
+			                  std::string("Malformed euclidean_vector text at byte ") + message);
+		};
+		malformed("[1 2] x", "6: expected '['");
+		malformed("[1 2", "4: expected ']' before the end of the text");
+		malformed("[1 , 2]", "3: expected a number or ']'");
+		malformed("[1 [2]]", "3: expected a number or ']'");
+		malformed("[1e999]", "1: number out of range");
+		malformed("[1 2x]", "4: expected whitespace or ']'");
+	}
+}
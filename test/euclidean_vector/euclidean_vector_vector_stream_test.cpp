@@ -0,0 +1,208 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the chunked vector streams.
+//      The test cases are:
+//          1. test converting between text and binary files in chunks
+//          2. test the transforms
+//          3. test the memory budget
+//          4. test streaming without a writer
+//          5. test the exception handling
+
+#include <comp6771/vector_stream.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	auto sample_vectors(int count) -> std::vector<comp6771::euclidean_vector> {
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto i = 0; i < count; ++i) {
+			vectors.push_back(comp6771::euclidean_vector{i + 1.0, -0.5 * i, 2.0, i % 3 * 1.0});
+		}
+		return vectors;
+	}
+
+	auto as_text(std::vector<comp6771::euclidean_vector> const& vectors) -> std::string {
+		auto oss = std::ostringstream();
+		comp6771::write_vectors(oss, vectors);
+		return oss.str();
+	}
+
+	// A budget that fits `rows` rows of dimension 4, which pad to 8 doubles, in each of two chunks
+	auto budget_for(std::size_t rows) -> comp6771::stream_options {
+		return comp6771::stream_options{2 * rows * 8 * sizeof(double)};
+	}
+} // namespace
+
+TEST_CASE("Stream conversions", "[vector_stream]") {
+	auto const vectors = sample_vectors(1000);
+
+	SECTION("Text to binary") {
+		auto in = std::istringstream(as_text(vectors));
+		auto out = std::stringstream();
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+		auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::binary);
+		CHECK(reader.dimensions() == 4);
+
+		auto const summary = comp6771::stream_vectors(reader, writer, budget_for(64));
+		CHECK(summary.rows_per_chunk == 64);
+		CHECK(summary.chunks == 16);
+		CHECK(summary.rows_read == 1000);
+		CHECK(summary.rows_kept == 1000);
+		CHECK(writer.rows() == 1000);
+		CHECK(comp6771::load_vectors(out) == vectors);
+	}
+
+	SECTION("Binary to text") {
+		auto in = std::stringstream();
+		comp6771::save(in, std::span<comp6771::euclidean_vector const>(vectors));
+		auto out = std::ostringstream();
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::binary);
+		auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::text);
+
+		auto const summary = comp6771::stream_vectors(reader, writer, budget_for(300));
+		CHECK(summary.chunks == 4);
+		CHECK(out.str() == as_text(vectors));
+	}
+
+	SECTION("Empty files") {
+		auto in = std::istringstream(" \n ");
+		auto out = std::stringstream();
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+		auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::binary);
+		auto const summary = comp6771::stream_vectors(reader, writer, {});
+		CHECK(summary.chunks == 0);
+		CHECK(comp6771::load_vectors(out).empty());
+	}
+}
+
+TEST_CASE("Stream transforms", "[vector_stream]") {
+	auto const vectors = sample_vectors(200);
+	auto in = std::istringstream(as_text(vectors));
+	auto out = std::stringstream();
+	auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+	auto writer = comp6771::vector_writer(out, comp6771::vector_file_format::binary);
+
+	// keep the rows with norm in [10, 50], then scale them to length 3
+	auto const summary = comp6771::stream_vectors(reader,
+	                                              writer,
+	                                              budget_for(16),
+	                                              comp6771::filter_by_norm{10, 50},
+	                                              comp6771::normalize_chunk{},
+	                                              comp6771::scale_chunk{3});
+
+	auto expected = std::vector<comp6771::euclidean_vector>();
+	for (auto const& v : vectors) {
+		auto const norm = comp6771::euclidean_norm(v);
+		if (norm >= 10 and norm <= 50) {
+			expected.push_back(comp6771::unit(v) * 3);
+		}
+	}
+	REQUIRE(not expected.empty());
+	CHECK(summary.rows_read == 200);
+	CHECK(summary.rows_kept == static_cast<int>(expected.size()));
+
+	auto const written = comp6771::load_vectors(out);
+	REQUIRE(written.size() == expected.size());
+	for (auto i = std::size_t{0}; i < written.size(); ++i) {
+		CHECK(comp6771::euclidean_norm(written[i]) == Approx(3.0));
+		CHECK(comp6771::distance(written[i], expected[i]) == Approx(0.0).margin(1e-12));
+	}
+}
+
+TEST_CASE("Stream memory budget", "[vector_stream]") {
+	auto const vectors = sample_vectors(10);
+	auto in = std::istringstream(as_text(vectors));
+	auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+
+	// every chunk the transform sees stays within the budget
+	auto largest = 0;
+	auto const summary = comp6771::stream_vectors(reader, budget_for(3), [&](auto const& chunk) {
+		largest = std::max(largest, chunk.rows());
+	});
+	CHECK(summary.rows_per_chunk == 3);
+	CHECK(summary.chunks == 4);
+	CHECK(largest == 3);
+
+	// the two chunks are allocated up front, so the transforms only ever see those two buffers
+	auto text = std::istringstream(as_text(sample_vectors(1000)));
+	auto text_reader = comp6771::vector_reader(text, comp6771::vector_file_format::text);
+	auto buffers = std::vector<double const*>();
+	comp6771::stream_vectors(text_reader, budget_for(100), [&](auto const& chunk) {
+		if (std::find(buffers.begin(), buffers.end(), chunk[0].data()) == buffers.end()) {
+			buffers.push_back(chunk[0].data());
+		}
+	});
+	CHECK(buffers.size() == 2);
+
+	// a budget too small for two rows still moves one row at a time
+	auto small = std::istringstream(as_text(vectors));
+	auto one_row = comp6771::vector_reader(small, comp6771::vector_file_format::text);
+	CHECK(comp6771::stream_vectors(one_row, comp6771::stream_options{1}).chunks == 10);
+}
+
+TEST_CASE("Stream without a writer", "[vector_stream]") {
+	auto const vectors = sample_vectors(500);
+	auto in = std::stringstream();
+	comp6771::save(in, std::span<comp6771::euclidean_vector const>(vectors));
+	auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::binary);
+
+	auto norms = std::vector<double>();
+	auto const collect_norms = [&](comp6771::euclidean_vector_batch const& chunk) {
+		auto const chunk_norms = chunk.norms();
+		norms.insert(norms.end(), chunk_norms.begin(), chunk_norms.end());
+	};
+	comp6771::stream_vectors(reader, budget_for(50), collect_norms);
+	REQUIRE(norms.size() == 500);
+	for (auto i = std::size_t{0}; i < norms.size(); ++i) {
+		CHECK(norms[i] == Approx(comp6771::euclidean_norm(vectors[i])));
+	}
+}
+
+TEST_CASE("Stream exception handling", "[vector_stream]") {
+	SECTION("Malformed text") {
+		auto in = std::istringstream("[1 2]\n[3 4]\n[5 x]\n[7 8]\n");
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+		CHECK_THROWS_WITH(comp6771::stream_vectors(reader, {}),
+		                  "Malformed euclidean_vector text after 2 vectors");
+
+		auto mixed = std::istringstream("[1 2]\n[3 4 5]\n");
+		auto mixed_reader = comp6771::vector_reader(mixed, comp6771::vector_file_format::text);
+		CHECK_THROWS_WITH(comp6771::stream_vectors(mixed_reader, {}),
+		                  "Dimensions of LHS(2) and RHS(3) do not match");
+
+		auto unterminated = std::istringstream("[1 2");
+		CHECK_THROWS_WITH(comp6771::vector_reader(unterminated, comp6771::vector_file_format::text),
+		                  "Malformed euclidean_vector text after 0 vectors");
+	}
+
+	SECTION("A transform that throws") {
+		auto in = std::istringstream(as_text(sample_vectors(100)));
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+		auto chunks = 0;
+		auto const fail_on_third = [&](comp6771::euclidean_vector_batch const&) {
+			if (++chunks == 3) {
+				throw comp6771::euclidean_vector_error("stop");
+			}
+		};
+		CHECK_THROWS_WITH(comp6771::stream_vectors(reader, budget_for(10), fail_on_third), "stop");
+		CHECK(chunks == 3);
+	}
+
+	SECTION("Readers and chunks") {
+		auto in = std::istringstream("[1 2]");
+		auto reader = comp6771::vector_reader(in, comp6771::vector_file_format::text);
+		auto chunk = comp6771::euclidean_vector_batch(0, 3);
+		CHECK_THROWS_WITH(reader.read(chunk, 1), "Dimensions of LHS(2) and RHS(3) do not match");
+
+		auto binary = std::istringstream("not a file");
+		CHECK_THROWS_WITH(comp6771::vector_reader(binary, comp6771::vector_file_format::binary),
+		                  "euclidean_vector binary file is truncated");
+	}
+}
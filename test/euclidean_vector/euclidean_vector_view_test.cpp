@@ -0,0 +1,142 @@
+// author: Wang, Liao
+// date: 2022-7
+// description:
+//      This test file is to test the EuclideanVectorView classes over external buffers.
+//      The test cases are:
+//          1. test viewing external buffers and euclidean_vector without copying
+//          2. test dot(), euclidean_norm(), distance(), cosine_similarity() and comparison on views
+//          3. test unit() into a caller-supplied output
+//          4. test arithmetic written into an owning vector or a mutable view
+//          5. test the exception handling
+
+#include <comp6771/euclidean_vector_view.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+TEST_CASE("View construction", "[view]") {
+	auto buffer = std::array<double, 4>{14.3, 26.5, -12.8, 2.1};
+	auto const v1 = comp6771::euclidean_vector{14.3, 26.5, -12.8, 2.1};
+
+	SECTION("Pointer and dimension") {
+		auto const view = comp6771::euclidean_vector_view(buffer.data(), 4);
+		CHECK(view.dimensions() == 4);
+		CHECK(view.data() == buffer.data());
+		CHECK(view[3] == 2.1);
+	}
+
+	SECTION("Span") {
+		auto const view = comp6771::euclidean_vector_view(std::span<double const>(buffer));
+		auto const mutable_view = comp6771::mutable_euclidean_vector_view(std::span<double>(buffer));
+		CHECK(view.dimensions() == 4);
+		CHECK(mutable_view.data() == buffer.data());
+	}
+
+	SECTION("Zero-copy view of a euclidean_vector") {
+		auto const view = comp6771::euclidean_vector_view(v1);
+		CHECK(view.data() == v1.data());
+		CHECK(view == v1);
+	}
+
+	SECTION("Materialise a view") {
+		auto const copy = comp6771::euclidean_vector(comp6771::euclidean_vector_view(buffer.data(), 4));
+		CHECK(copy == v1);
+	}
+}
+
+TEST_CASE("View utility functions and comparison", "[view]") {
+	auto const a = std::vector<double>{3.0, 0.0, 4.0};
+	auto const b = std::vector<double>{1.0, 2.0, 3.0};
+	auto const view_a = comp6771::euclidean_vector_view(a.data(), 3);
+	auto const view_b = comp6771::euclidean_vector_view(b.data(), 3);
+
+	CHECK(comp6771::euclidean_norm(view_a) == Approx(5.0));
+	CHECK(comp6771::dot(view_a, view_b) == Approx(15.0));
+	CHECK(comp6771::dot(view_a, comp6771::euclidean_vector{1.0, 1.0, 1.0}) == Approx(7.0));
+	CHECK(comp6771::squared_distance(view_a, view_b) == Approx(9.0));
+	CHECK(comp6771::distance(view_a, comp6771::euclidean_vector{3.0, 0.0, 0.0}) == Approx(4.0));
+	CHECK(comp6771::cosine_similarity(view_a, view_b) == Approx(15.0 / (5.0 * std::sqrt(14.0))));
+	CHECK(comp6771::cosine_distance(view_a, view_a * 2.0) == Approx(0.0).margin(1e-15));
+
+	CHECK(view_a == view_a);
+	CHECK(view_a != view_b);
+	CHECK(view_b == comp6771::euclidean_vector{1.0, 2.0, 3.0});
+	CHECK(comp6771::euclidean_vector{1.0, 2.0, 3.0} == view_b);
+	CHECK(view_a != comp6771::euclidean_vector{3.0, 0.0});
+}
+
+TEST_CASE("View unit into an output", "[view]") {
+	auto const a = std::vector<double>{3.0, 0.0, 4.0};
+	auto const view = comp6771::euclidean_vector_view(a.data(), 3);
+
+	SECTION("Into a mutable view") {
+		auto out = std::vector<double>(3);
+		comp6771::unit(view, comp6771::mutable_euclidean_vector_view(out.data(), 3));
+		CHECK(out == std::vector<double>{0.6, 0.0, 0.8});
+	}
+
+	SECTION("In place") {
+		auto in_place = a;
+		auto const out = comp6771::mutable_euclidean_vector_view(in_place.data(), 3);
+		comp6771::unit(out, out);
+		CHECK(in_place == std::vector<double>{0.6, 0.0, 0.8});
+	}
+
+	SECTION("Into an owning vector") {
+		auto out = comp6771::euclidean_vector(3);
+		comp6771::unit(view, out);
+		CHECK(out == comp6771::euclidean_vector{0.6, 0.0, 0.8});
+		CHECK(comp6771::euclidean_norm(out) == Approx(1.0));
+	}
+}
+
+TEST_CASE("View arithmetic", "[view]") {
+	auto a = std::vector<double>{1.0, 2.0, 3.0};
+	auto const b = std::vector<double>{4.0, 5.0, 6.0};
+	auto const view_a = comp6771::mutable_euclidean_vector_view(a.data(), 3);
+	auto const view_b = comp6771::euclidean_vector_view(b.data(), 3);
+
+	SECTION("Into an owning vector") {
+		auto out = comp6771::euclidean_vector(3);
+		out = view_a + view_b * 2.0;
+		CHECK(out == comp6771::euclidean_vector{9.0, 12.0, 15.0});
+
+		out += view_b;
+		CHECK(out == comp6771::euclidean_vector{13.0, 17.0, 21.0});
+	}
+
+	SECTION("Into a mutable view") {
+		view_a = view_b - view_a;
+		CHECK(a == std::vector<double>{3.0, 3.0, 3.0});
+
+		view_a += comp6771::euclidean_vector{1.0, 1.0, 1.0};
+		view_a *= 2.0;
+		view_a -= view_b;
+		view_a /= 2.0;
+		CHECK(a == std::vector<double>{2.0, 1.5, 1.0});
+	}
+}
+
+TEST_CASE("View exception handling", "[view]") {
+	auto const a = std::vector<double>{1.0, 2.0, 3.0};
+	auto const zero = std::vector<double>{0.0, 0.0, 0.0};
+	auto out = std::vector<double>(2);
+	auto const view = comp6771::euclidean_vector_view(a.data(), 3);
+	auto const empty = comp6771::euclidean_vector_view(a.data(), 0);
+	auto const small_out = comp6771::mutable_euclidean_vector_view(out.data(), 2);
+	auto owning = comp6771::euclidean_vector(3);
+
+	CHECK_THROWS_WITH(comp6771::dot(view, comp6771::euclidean_vector(2)),
+	                  "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::distance(view, comp6771::euclidean_vector(2)),
+	                  "Dimensions of LHS(3) and RHS(2) do not match");
+	CHECK_THROWS_WITH(comp6771::unit(view, small_out), "Dimensions of LHS(2) and RHS(3) do not match");
+	CHECK_THROWS_WITH(comp6771::unit(empty, owning),
+	                  "euclidean_vector with no dimensions does not have a unit vector");
+	CHECK_THROWS_WITH(comp6771::unit(comp6771::euclidean_vector_view(zero.data(), 3), owning),
+	                  "euclidean_vector with zero euclidean normal does not have a unit vector");
+	CHECK_THROWS_WITH(small_out = view, "Dimensions of LHS(2) and RHS(3) do not match");
+}